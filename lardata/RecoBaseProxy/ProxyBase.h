@@ -15,6 +15,7 @@
 
 // LArSoft libraries
 #include "lardata/RecoBaseProxy/ProxyBase/getCollection.h"
+#include "lardata/RecoBaseProxy/ProxyBase/lazy.h"
 #include "lardata/RecoBaseProxy/ProxyBase/withAssociated.h"
 #include "lardata/RecoBaseProxy/ProxyBase/withCollectionProxy.h"
 #include "lardata/RecoBaseProxy/ProxyBase/withParallelData.h"
@@ -0,0 +1,77 @@
+/**
+ * @file   lardata/RecoBaseProxy/ProxyBase/AssociatedData.cxx
+ * @brief  Grouping of unsorted associations for associated data.
+ * @see    lardata/RecoBaseProxy/ProxyBase/AssociatedData.h
+ */
+
+// LArSoft libraries
+#include "lardata/RecoBaseProxy/ProxyBase/AssociatedData.h"
+
+// framework libraries
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::min(), std::max()
+#include <cstdlib>   // std::size_t
+#include <vector>
+
+//------------------------------------------------------------------------------
+proxy::details::GroupIndex proxy::details::groupByKey(std::vector<std::size_t> const& keys,
+                                                      std::size_t nGroups)
+{
+  using offset_t = BoundaryOffsets_t::value_type;
+
+  // each chunk has its own counter for each group: the number of chunks is
+  // limited so that all the counters together are not more than the elements
+  std::size_t const n = keys.size();
+  std::size_t nChunks = 1;
+  if (n >= ParallelGroupingMin) {
+    auto const maxTasks = static_cast<std::size_t>(tbb::this_task_arena::max_concurrency());
+    std::size_t const maxChunks = (nGroups > 0) ? (n / nGroups) : n;
+    nChunks = std::max(std::min({n / ParallelGroupingChunk, maxTasks, maxChunks}), std::size_t{1});
+  }
+  auto chunkBegin = [n, nChunks](std::size_t iChunk) { return n * iChunk / nChunks; };
+  auto forEachChunk = [nChunks](auto const& action) {
+    if (nChunks == 1)
+      action(std::size_t{0});
+    else
+      tbb::parallel_for(std::size_t{0}, nChunks, action);
+  };
+
+  // number of elements of each group in each chunk
+  std::vector<BoundaryOffsets_t> positions(nChunks);
+  forEachChunk([&](std::size_t iChunk) {
+    BoundaryOffsets_t& counts = positions[iChunk];
+    counts.assign(nGroups, 0);
+    for (std::size_t i = chunkBegin(iChunk); i < chunkBegin(iChunk + 1); ++i)
+      ++counts[keys[i]];
+  });
+
+  // group boundaries; counts become the position of the first element
+  // of each group from each chunk, chunks in input order
+  GroupIndex groups;
+  groups.offsets.resize(nGroups + 1);
+  offset_t next = 0;
+  for (std::size_t iGroup = 0; iGroup < nGroups; ++iGroup) {
+    groups.offsets[iGroup] = next;
+    for (BoundaryOffsets_t& counts : positions) {
+      offset_t const count = counts[iGroup];
+      counts[iGroup] = next;
+      next += count;
+    }
+  }
+  groups.offsets[nGroups] = next;
+
+  // stable scatter of the element positions
+  groups.order.resize(n);
+  forEachChunk([&](std::size_t iChunk) {
+    BoundaryOffsets_t& nextPos = positions[iChunk];
+    for (std::size_t i = chunkBegin(iChunk); i < chunkBegin(iChunk + 1); ++i)
+      groups.order[nextPos[keys[i]]++] = static_cast<offset_t>(i);
+  });
+
+  return groups;
+} // proxy::details::groupByKey()
+
+//------------------------------------------------------------------------------
@@ -5,7 +5,9 @@
  * @date   July 27, 2017
  * @see    lardata/RecoBaseProxy/ProxyBase.h
  *
- * This library is header-only.
+ * This library is mostly header-only: the grouping of unsorted associations
+ * (`details::groupByKey()`) is implemented in `AssociatedData.cxx`, which is
+ * part of the `lardata_RecoBaseProxy` library.
  */
 
 #ifndef LARDATA_RECOBASEPROXY_PROXYBASE_ASSOCIATEDDATA_H
@@ -27,9 +29,14 @@
 // #include <tuple> // std::tuple_element_t<>, std::get()
 #include <algorithm> // std::min()
 #include <cassert>
+#include <cstddef>     // std::ptrdiff_t
+#include <cstdint>     // std::uint32_t
 #include <cstdlib>     // std::size_t
 #include <iterator>    // std::distance(), std::forward_iterator_tag, ...
-#include <memory>      // std::addressof()
+#include <limits>      // std::numeric_limits<>
+#include <memory>      // std::addressof(), std::shared_ptr<>, ...
+#include <stdexcept>   // std::runtime_error
+#include <string>      // std::to_string()
 #include <type_traits> // std::is_same<>, std::enable_if_t<>, ...
 #include <utility>     // std::forward(), std::declval(), ...
 
@@ -134,6 +141,9 @@ namespace proxy {
         return asIterator().transform(asDataIterator() + index);
       }
 
+      /// Returns an iterator `n` positions after this one (random access only).
+      iterator operator+(difference_type n) const { return iterator(asDataIterator() + n); }
+
       /// Dereference operator; need to be redefined by derived classes.
       auto operator*() const -> decltype(auto) { return asIterator().transform(asDataIterator()); }
 
@@ -612,32 +622,222 @@ namespace proxy {
 
     }; // class BoundaryListRangeIterator<>
 
+    /// Boundaries of a `BoundaryList`, as offsets from the first element.
+    using BoundaryOffsets_t = std::vector<std::uint32_t>;
+
+    /**
+     * @brief Grouping of the elements of a sequence.
+     *
+     * The elements of group `i` are the ones at positions `order[j]` in the
+     * sequence, for `j` from `offsets[i]` to `offsets[i + 1]` (excluded).
+     * If the sequence is already in group order, `order` is empty and `j`
+     * is directly the position in the sequence.
+     */
+    struct GroupIndex {
+      BoundaryOffsets_t offsets; ///< Begin of each group, plus end of the last one.
+      BoundaryOffsets_t order;   ///< Position of the elements, in group order.
+
+      /// Returns whether the sequence is already in group order.
+      bool sorted() const { return order.empty(); }
+    }; // struct GroupIndex
+
+    /**
+     * @brief Iterator on a sequence, in the order of a `GroupIndex`.
+     * @tparam Iter type of iterator to the sequence (random access)
+     *
+     * The iterator at position `j` points to the element `order[j]` of the
+     * sequence, or to the element `j` if there is no `order`.
+     * The iterator keeps an iterator to the pointed element, updated on each
+     * movement, so that dereferencing does not change its state.
+     *
+     * The iterator shares the ownership of the index, which stays valid as
+     * long as the iterator exists; the sequence itself is not owned.
+     * If the sequence is already in group order, no index is held at all.
+     */
+    template <typename Iter>
+    class GroupedIterator {
+      using data_iterator_t = Iter;
+
+    public:
+      /// @{
+      /// @name Iterator traits
+      using value_type = typename std::iterator_traits<data_iterator_t>::value_type;
+      using difference_type = std::ptrdiff_t;
+      using pointer = std::add_pointer_t<std::add_const_t<value_type>>;
+      using reference = decltype(*std::declval<data_iterator_t const&>());
+      using iterator_category = std::random_access_iterator_tag;
+      /// @}
+
+      /// Default constructor: not pointing to any sequence.
+      GroupedIterator() = default;
+
+      /// Constructor: position `pos` in the order of `groups` from `first`.
+      GroupedIterator(data_iterator_t const& first,
+                      std::shared_ptr<GroupIndex const> const& groups,
+                      std::size_t pos)
+        : fFirst(first)
+        , fGroups((groups && !groups->sorted()) ? groups : nullptr)
+        , fOrder(fGroups ? fGroups->order.data() : nullptr)
+        , fPos(static_cast<difference_type>(pos))
+      {
+        locate();
+      }
+
+      /// Returns the pointed element.
+      reference operator*() const { return *fCurrent; }
+
+      /// Returns a pointer to the pointed element.
+      pointer operator->() const { return std::addressof(operator*()); }
+
+      /// Returns (a copy of) the element `n` positions after this one.
+      value_type operator[](difference_type n) const { return *(*this + n); }
+
+      /// @{
+      /// @name Movement
+      GroupedIterator& operator++() { return *this += 1; }
+      GroupedIterator operator++(int)
+      {
+        auto old = *this;
+        ++*this;
+        return old;
+      }
+      GroupedIterator& operator--() { return *this -= 1; }
+      GroupedIterator operator--(int)
+      {
+        auto old = *this;
+        --*this;
+        return old;
+      }
+      GroupedIterator& operator+=(difference_type n)
+      {
+        fPos += n;
+        locate();
+        return *this;
+      }
+      GroupedIterator& operator-=(difference_type n) { return *this += -n; }
+      GroupedIterator operator+(difference_type n) const { return GroupedIterator(*this) += n; }
+      GroupedIterator operator-(difference_type n) const { return GroupedIterator(*this) -= n; }
+      difference_type operator-(GroupedIterator const& other) const { return fPos - other.fPos; }
+      /// @}
+
+      /// @{
+      /// @name Comparison (with iterators on the same sequence)
+      bool operator==(GroupedIterator const& other) const { return fPos == other.fPos; }
+      bool operator!=(GroupedIterator const& other) const { return fPos != other.fPos; }
+      bool operator<(GroupedIterator const& other) const { return fPos < other.fPos; }
+      bool operator>(GroupedIterator const& other) const { return fPos > other.fPos; }
+      bool operator<=(GroupedIterator const& other) const { return fPos <= other.fPos; }
+      bool operator>=(GroupedIterator const& other) const { return fPos >= other.fPos; }
+      /// @}
+
+    private:
+      data_iterator_t fFirst;                    ///< Iterator to the first element of the sequence.
+      std::shared_ptr<GroupIndex const> fGroups; ///< Index (null if in order).
+      std::uint32_t const* fOrder = nullptr;     ///< Order of the elements (null if in order).
+      difference_type fPos = 0;                  ///< Position in the group order.
+      data_iterator_t fCurrent;                  ///< Iterator to the pointed element.
+
+      /// Points `fCurrent` to the element at the current position (if any).
+      void locate()
+      {
+        if (!fOrder)
+          fCurrent = fFirst + fPos;
+        else if ((fPos >= 0) && (static_cast<std::size_t>(fPos) < fGroups->order.size()))
+          fCurrent = fFirst + static_cast<difference_type>(fOrder[fPos]);
+      }
+
+    }; // class GroupedIterator<>
+
+    /**
+     * @brief Iterator exposing the ranges of a boundary list by index.
+     * @tparam List type of boundary list (like `BoundaryList`)
+     *
+     * When dereferenced, this iterator returns the range at its current index
+     * in the list, as returned by `List::range()`.
+     */
+    template <typename List>
+    class BoundaryListIndexIterator {
+    public:
+      /// @{
+      /// @name Iterator traits
+      using value_type = typename List::range_t;
+      using difference_type = std::ptrdiff_t;
+      using pointer = std::add_pointer_t<value_type>;
+      using reference = value_type;
+      using iterator_category = std::forward_iterator_tag;
+      /// @}
+
+      /// Default constructor: not pointing to any list.
+      BoundaryListIndexIterator() = default;
+
+      /// Constructor: points to the range `index` of `list`.
+      BoundaryListIndexIterator(List const& list, std::size_t index)
+        : fList(std::addressof(list)), fIndex(index)
+      {}
+
+      /// Returns the pointed range.
+      value_type operator*() const { return fList->range(fIndex); }
+
+      /// Prefix increment operator.
+      BoundaryListIndexIterator& operator++()
+      {
+        ++fIndex;
+        return *this;
+      }
+
+      /// Postfix increment operator.
+      BoundaryListIndexIterator operator++(int)
+      {
+        auto old = *this;
+        ++fIndex;
+        return old;
+      }
+
+      /// Comparison with another iterator (on the same list).
+      bool operator==(BoundaryListIndexIterator const& other) const
+      {
+        return fIndex == other.fIndex;
+      }
+
+      /// Comparison with another iterator (on the same list).
+      bool operator!=(BoundaryListIndexIterator const& other) const
+      {
+        return fIndex != other.fIndex;
+      }
+
+    private:
+      List const* fList = nullptr; ///< The list of ranges.
+      std::size_t fIndex = 0;      ///< Index of the pointed range.
+
+    }; // class BoundaryListIndexIterator<>
+
     /**
      * @brief Builds and keeps track of internal boundaries in a sequence.
      * @tparam Iter type of iterators to the original sequence
      *
-     * This class manages a sequence of boundary iterators defining the
-     * beginning of contiguous subsequences. Each iterator marks the begin of a
+     * This class manages a sequence of boundaries defining the beginning of
+     * contiguous subsequences. Each boundary marks the begin of a
      * subsequence, whose end is marked by the beginning of the next one.
-     * The last iterator in the boundary list marks the end of the last
-     * subsequence, but it does not mark the beginning of a following one.
-     * Therefore, for a list of _N_ subsequences there will be _N + 1_ boundary
-     * iterators in the list: _N_ marking the beginning of the respective
+     * The last boundary in the list marks the end of the last subsequence,
+     * but it does not mark the beginning of a following one.
+     * Therefore, for a list of _N_ subsequences there will be _N + 1_
+     * boundaries in the list: _N_ marking the beginning of the respective
      * subsequences, plus another marking the end of the last subsequence.
      *
-     * It is likely that the first iterator in the boundary list is the begin
-     * iterator of the underlying sequence (usually a container) being
-     * partitioned, while the last one is the end iterator of that sequence.
-     *
      * This is a data class which does not contain any logic to define the
      * subsequences, but rather acquires the result of an algorithm which is
      * expected to have established which the boundaries are.
      *
-     * The underlying representation of the class is a random-access sequence
-     * of boundaries. The exposed value, `range_t`, is a range of data elements
-     * (a view with the interface of a random access container), which is
-     * internally represented as a single iterator pointing to the begin
-     * iterator of the range.
+     * The boundaries are stored in a `GroupIndex`, as 32-bit offsets from an
+     * iterator to the first element of the underlying sequence (`Iter` must
+     * support random access by `operator+`). The subsequences are contiguous
+     * in the order of the index, which may differ from the order of the
+     * sequence itself: in that case the elements are reached through the
+     * index (`GroupedIterator`). The index can be shared among lists on the
+     * same sequence, e.g. via `AssociationRangeCache`.
+     * The exposed value, `range_t`, is a range of data elements (a view with
+     * the interface of a random access container) holding its own begin and
+     * end iterators.
      */
     template <typename Iter>
     class BoundaryList {
@@ -645,67 +845,78 @@ namespace proxy {
 
     public:
       using data_iterator_t = Iter;
+
+      /// Type of list of boundaries, as offsets.
+      using offsets_t = BoundaryOffsets_t;
+
+      /// Type of offset of a boundary from the start of the sequence.
+      using offset_t = offsets_t::value_type;
+
+      /// Type of list of boundaries, as iterators.
       using boundaries_t = std::vector<data_iterator_t>;
 
-      /// Iterator on the ranges contained in the collection.
-      using range_iterator_t = BoundaryListRangeIterator<typename boundaries_t::const_iterator>;
+      /// Iterator on the elements of a range.
+      using element_iterator_t = GroupedIterator<data_iterator_t>;
 
-      /// Structure holding begin and end iterator for a single range.
-      // BoundaryListRange<data_iterator_t> const&
-      using range_ref_t = typename range_iterator_t::value_type;
+      /// Iterator on the ranges contained in the collection.
+      using range_iterator_t = BoundaryListIndexIterator<boundarylist_t>;
 
       /// Range object directly containing the boundary iterators.
-      using range_t = lar::RangeAsCollection_t<data_iterator_t>;
+      using range_t = lar::RangeAsCollection_t<element_iterator_t>;
 
-      /// Constructor: steals the specified boundary list.
-      explicit BoundaryList(boundaries_t&& boundaries) : boundaries(std::move(boundaries))
+      /// Type returned by `rangeRef()`.
+      using range_ref_t = range_t;
+
+      /// Constructor: shares the grouping `groups` of the sequence from `first`.
+      BoundaryList(data_iterator_t first, std::shared_ptr<GroupIndex const> groups)
+        : fFirst(std::move(first)), fGroups(std::move(groups))
       {
-        assert(this->boundaries.size() >= 1);
+        assert(fGroups && (fGroups->offsets.size() >= 1));
       }
 
+      /// Constructor: converts the specified boundary list into offsets.
+      explicit BoundaryList(boundaries_t&& boundaries)
+        : BoundaryList(boundaries.front(), toGroups(boundaries))
+      {}
+
       /// Returns the number of ranges contained in the list.
-      std::size_t nRanges() const { return boundaries.size() - 1; }
+      std::size_t nRanges() const { return fGroups->offsets.size() - 1; }
       /// Returns the begin iterator of the `i`-th range (end if overflow).
-      data_iterator_t const& rangeBegin(std::size_t i) const
+      element_iterator_t rangeBegin(std::size_t i) const
       {
-        return boundaries[std::min(i, nRanges())];
+        return {fFirst, fGroups, fGroups->offsets[std::min(i, nRanges())]};
       }
       /// Returns the end iterator of the `i`-th range (end if overflow).
-      data_iterator_t const& rangeEnd(std::size_t i) const { return rangeBegin(i + 1); }
+      element_iterator_t rangeEnd(std::size_t i) const { return rangeBegin(i + 1); }
 
       /// Returns the number of ranges contained in the list.
       std::size_t size() const { return nRanges(); }
       /// Returns the begin iterator of the first range.
-      range_iterator_t begin() const { return {boundaries.begin()}; }
+      range_iterator_t begin() const { return {*this, 0U}; }
       /// Returns the end iterator of the last range.
-      range_iterator_t end() const { return {std::prev(boundaries.end())}; }
+      range_iterator_t end() const { return {*this, nRanges()}; }
       /**
        * @brief Returns the specified range.
        * @param i index of the range to be returned
        * @return a proxy object with container interface
        * @see `range()`
        *
-       * The returned object exposes the range as a random access container
-       * interface.
-       *
-       * Internally, it refers to the relevant information from this
-       * `BoundaryList` object, and therefore it becomes invalid when this
-       * `BoundaryList` object is destroyed.
-       * If this is not acceptable, use `range()` instead.
+       * This is the same as `range()`, and it is kept for compatibility.
        */
-      range_ref_t rangeRef(std::size_t i) const { return {std::next(boundaries.begin(), i)}; }
+      range_ref_t rangeRef(std::size_t i) const { return range(i); }
       /**
        * @brief Returns the specified range in an object holding the iterators.
        * @param i index of the range to be returned
        * @return a new object with container interface
-       * @see `rangeRef()`
        *
        * The returned object contains copies of the begin and end iterators of
-       * the range. This object is self-contained and valid even after this
-       * BoundaryList object is destroyed.
+       * the range, which share the ownership of the grouping index. This object
+       * is self-contained and valid even after this BoundaryList object is
+       * destroyed.
        *
        * Note the content of the range itself is _not_ copied: just the boundary
-       * iterators of the range are.
+       * iterators of the range are, and the underlying sequence must still
+       * exist when the range is used.
        */
       range_t range(std::size_t i) const
       {
@@ -716,9 +927,28 @@ namespace proxy {
       /// @see `range()`
       auto operator[](std::size_t i) const -> decltype(auto) { return range(i); }
 
+      /// Returns the grouping of the sequence.
+      GroupIndex const& groups() const { return *fGroups; }
+
     private:
-      /// Begin iterator of each range, plus end iterator of whole sequence.
-      boundaries_t boundaries;
+      /// Iterator to the first element of the sequence.
+      data_iterator_t fFirst;
+
+      /// Boundaries of the ranges (and order of the elements, if needed).
+      std::shared_ptr<GroupIndex const> fGroups;
+
+      /// Returns the grouping with the offsets of `boundaries` from the first one.
+      static std::shared_ptr<GroupIndex const> toGroups(boundaries_t const& boundaries)
+      {
+        assert(boundaries.size() >= 1);
+        GroupIndex groups;
+        groups.offsets.reserve(boundaries.size());
+        for (data_iterator_t const& boundary : boundaries) {
+          groups.offsets.push_back(
+            static_cast<offset_t>(std::distance(boundaries.front(), boundary)));
+        }
+        return std::make_shared<GroupIndex const>(std::move(groups));
+      }
 
     }; // class BoundaryList
 
@@ -891,51 +1121,95 @@ namespace proxy {
     //--------------------------------------------------------------------------
     //--- associationRangeBoundaries() implementation
     //--------------------------------------------------------------------------
+    /// Minimum number of association elements to group them in parallel.
+    constexpr std::size_t ParallelGroupingMin = 1U << 16;
+
+    /// Minimum number of association elements grouped by each parallel task.
+    constexpr std::size_t ParallelGroupingChunk = 1U << 14;
+
+    /// Throws an exception if `n` elements can't be indexed by `GroupIndex`.
+    inline void checkGroupingSize(std::size_t n)
+    {
+      using offset_t = BoundaryOffsets_t::value_type;
+      if (n > std::numeric_limits<offset_t>::max()) {
+        throw std::runtime_error("associationRanges() got " + std::to_string(n) +
+                                 " input elements, more than supported (" +
+                                 std::to_string(std::numeric_limits<offset_t>::max()) + ")!");
+      }
+    } // checkGroupingSize()
+
+    /**
+     * @brief Groups the positions of `keys` by key value (counting sort).
+     * @param keys the key of each element
+     * @param nGroups number of groups (larger than all keys)
+     * @return the grouping, with the elements of each group in input order
+     *
+     * Large inputs are split in chunks which are counted and scattered in
+     * parallel; the result does not depend on the number of chunks.
+     * This function is implemented in `AssociatedData.cxx`.
+     */
+    GroupIndex groupByKey(std::vector<std::size_t> const& keys, std::size_t nGroups);
+
+    /// Groups associations in any order by their `GroupKey` key.
+    template <std::size_t GroupKey, typename Iter>
+    GroupIndex unsortedAssociationRangesImpl(Iter begin, Iter end)
+    {
+      std::vector<std::size_t> keys;
+      keys.reserve(std::distance(begin, end));
+      std::size_t maxKey = 0;
+      for (auto it = begin; it != end; ++it) {
+        keys.push_back(std::get<GroupKey>(*it).key());
+        maxKey = std::max(maxKey, keys.back());
+      }
+      checkGroupingSize(keys.size());
+      return groupByKey(keys, keys.empty() ? 0 : maxKey + 1);
+    } // unsortedAssociationRangesImpl()
+
     template <std::size_t GroupKey, typename Iter>
-    typename BoundaryList<Iter>::boundaries_t
-    associationRangesImpl(Iter begin, Iter end, std::size_t expectedSize /* = 0 */)
+    GroupIndex associationRangesImpl(Iter begin, Iter end, std::size_t expectedSize /* = 0 */)
     {
       constexpr auto KeyIndex = GroupKey;
+      using offset_t = BoundaryOffsets_t::value_type;
 
       auto extractKey = [](auto const& assn) { return std::get<KeyIndex>(assn).key(); };
 
-      typename BoundaryList<Iter>::boundaries_t boundaries;
-      boundaries.reserve(expectedSize + 1);
-      boundaries.push_back(begin);
+      // fast path for associations already sorted by key: no reordering needed
+      GroupIndex groups;
+      BoundaryOffsets_t& offsets = groups.offsets;
+      offsets.reserve(expectedSize + 1);
+      offsets.push_back(0);
       std::size_t current = 0;
-      for (auto it = begin; it != end; ++it) {
+      std::size_t index = 0;
+      for (auto it = begin; it != end; ++it, ++index) {
         auto const key = extractKey(*it);
         if (key == current) continue;
-        if (key < current) {
-          auto index = std::distance(begin, it);
-          throw std::runtime_error(
-            "associationRanges() got input element #" + std::to_string(index - 1) + " with key " +
-            std::to_string(current) + " and the next with key " + std::to_string(key) + "!");
-        }
-        boundaries.insert(boundaries.end(), key - current, it);
+        if (key < current) return unsortedAssociationRangesImpl<GroupKey>(begin, end);
+        offsets.insert(offsets.end(), key - current, static_cast<offset_t>(index));
         current = key;
       } // for
-      boundaries.push_back(end);
-      return boundaries;
+      checkGroupingSize(index);
+      offsets.push_back(static_cast<offset_t>(index));
+      return groups;
     } // associationRangesImpl()
 
     //--------------------------------------------------------------------------
     template <std::size_t GroupKey, typename Iter>
     auto associationRangeBoundaries(Iter begin, Iter end)
     {
-      return associationRangesImpl<GroupKey, Iter>(begin, end);
+      return associationRangesImpl<GroupKey, Iter>(begin, end, 0U);
     }
 
     //--------------------------------------------------------------------------
     template <std::size_t GroupKey, typename Iter>
     auto associationRangeBoundaries(Iter begin, Iter end, std::size_t n)
     {
-      auto boundaries = associationRangesImpl<GroupKey, Iter>(begin, end, n);
+      auto groups = associationRangesImpl<GroupKey, Iter>(begin, end, n);
+      BoundaryOffsets_t& boundaries = groups.offsets;
       if (boundaries.size() <= n) {
         boundaries.insert(boundaries.end(), n + 1 - boundaries.size(), boundaries.back());
         assert(boundaries.size() == (n + 1));
       }
-      return boundaries;
+      return groups;
     } // associationRangeBoundaries(Iter, Iter, std::size_t)
 
     //--------------------------------------------------------------------------
@@ -946,13 +1220,16 @@ namespace proxy {
      * @param begin iterator to the first association in the list
      * @param end iterator past the last association in the list
      * @return a list of range boundaries marking the different groups.
-     * @throw std::runtime_error if input key is not monotonic
      *
      * The input iterators are expected to point to a tuple-like structure whose
      * key element can be accessed as `std::get<GroupKey>()` and is an _art_
      * pointer of some sort.
      *
-     * The index of the grouping key is expected to be monotonically increasing.
+     * The associations may be in any order. If the index of the grouping key
+     * is monotonically increasing, the groups are contiguous in the input and
+     * only their boundaries are recorded; otherwise the associations are
+     * grouped by counting sort (in parallel for large inputs), keeping the
+     * input order within each group.
      * Gaps are supported except that at the end: if e.g. an association of 5
      * keys associates objects to only elements #0, #1 and #3, the resulting
      * list will cover 4 ranges for elements #0 to #3 included, but excluding
@@ -964,7 +1241,9 @@ namespace proxy {
     template <std::size_t GroupKey, typename Iter>
     BoundaryList<Iter> associationRanges(Iter begin, Iter end)
     {
-      return BoundaryList<Iter>(associationRangeBoundaries<GroupKey>(begin, end));
+      return BoundaryList<Iter>(
+        begin,
+        std::make_shared<GroupIndex const>(associationRangeBoundaries<GroupKey>(begin, end)));
     }
 
     /**
@@ -975,7 +1254,6 @@ namespace proxy {
      * @param end iterator past the last association in the list
      * @param n minimum number of ranges to be produced.
      * @return a list of range boundaries marking the different groups.
-     * @throw std::runtime_error if input key is not monotonic
      * @see `associationRanges(Iter, Iter)`
      *
      * This function operates almost like `associationRanges(Iter, Iter)`.
@@ -988,10 +1266,30 @@ namespace proxy {
     template <std::size_t GroupKey, typename Iter>
     BoundaryList<Iter> associationRanges(Iter begin, Iter end, std::size_t n)
     {
-      return BoundaryList<Iter>(associationRangeBoundaries<GroupKey>(begin, end, n));
+      return BoundaryList<Iter>(
+        begin,
+        std::make_shared<GroupIndex const>(associationRangeBoundaries<GroupKey>(begin, end, n)));
     }
 
     //--------------------------------------------------------------------------
+    template <typename Tag, typename Assns>
+    auto makeAssociatedDataFromGroups(Assns const& assns,
+                                      std::shared_ptr<GroupIndex const> groups)
+    {
+      using Main_t = typename Assns::left_t;
+      using Aux_t = typename Assns::right_t;
+      using Metadata_t = lar::util::assns_metadata_t<Assns>;
+      using AssociatedData_t = details::AssociatedData<Main_t, Aux_t, Metadata_t, Tag>;
+      using group_ranges_t = typename AssociatedData_t::group_ranges_t;
+      using data_iterator_t = typename group_ranges_t::data_iterator_t;
+
+      // the grouping is the same for iterators to association elements
+      // (i.e. tuples) and to the right associated item
+      using std::begin;
+      return AssociatedData_t(group_ranges_t(data_iterator_t(begin(assns)), std::move(groups)));
+    } // makeAssociatedDataFromGroups()
+
+    //--------------------------------------------------------------------------
 
   } // namespace details
 
@@ -999,21 +1297,12 @@ namespace proxy {
   template <typename Tag, typename Assns>
   auto makeAssociatedData(Assns const& assns, std::size_t minSize /* = 0 */)
   {
-    using Main_t = typename Assns::left_t;
-    using Aux_t = typename Assns::right_t;
-    using Metadata_t = lar::util::assns_metadata_t<Assns>;
-    using AssociatedData_t = details::AssociatedData<Main_t, Aux_t, Metadata_t, Tag>;
-
-    // associationRangeBoundaries() produces iterators to association elements,
-    // (i.e. tuples)
     using std::begin;
     using std::end;
-    auto ranges = details::associationRangeBoundaries<0U>(begin(assns), end(assns), minSize);
-    // we convert those iterators into iterators to the right associated item
-    // (it takes a few steps)
-    using group_ranges_t = typename AssociatedData_t::group_ranges_t;
-    return AssociatedData_t(
-      group_ranges_t(typename group_ranges_t::boundaries_t(ranges.begin(), ranges.end())));
+    return details::makeAssociatedDataFromGroups<Tag>(
+      assns,
+      std::make_shared<details::GroupIndex const>(
+        details::associationRangeBoundaries<0U>(begin(assns), end(assns), minSize)));
   } // makeAssociatedDataFrom(assns)
 
   //----------------------------------------------------------------------------
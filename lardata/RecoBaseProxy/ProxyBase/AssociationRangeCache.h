@@ -0,0 +1,282 @@
+/**
+ * @file   lardata/RecoBaseProxy/ProxyBase/AssociationRangeCache.h
+ * @brief  Cache of association range boundaries shared by proxies.
+ * @see    lardata/RecoBaseProxy/ProxyBase/AssociatedData.h
+ *
+ * This library is header-only.
+ */
+
+#ifndef LARDATA_RECOBASEPROXY_PROXYBASE_ASSOCIATIONRANGECACHE_H
+#define LARDATA_RECOBASEPROXY_PROXYBASE_ASSOCIATIONRANGECACHE_H
+
+// LArSoft libraries
+#include "lardata/RecoBaseProxy/ProxyBase/AssociatedData.h" // GroupIndex
+
+// C/C++ standard libraries
+#include <algorithm> // std::find()
+#include <cstdint>   // std::uint64_t
+#include <cstdlib>   // std::size_t
+#include <deque>
+#include <map>
+#include <memory> // std::shared_ptr<>, std::make_shared()
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits> // std::void_t<>
+#include <utility>     // std::declval(), std::move()
+
+namespace proxy {
+
+  namespace details {
+
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Event-scoped cache of association range boundaries.
+     *
+     * Associated data (`withAssociated()`) groups the elements of an
+     * association by the key of the main element, with a pass on the whole
+     * association (`associationRanges()`). Several proxies, often in
+     * different modules, are built on the same association in the same
+     * event: this cache keeps the grouping (`GroupIndex`) so that the pass
+     * is done only once per event.
+     *
+     * Boundaries are keyed by event, association data product and minimum
+     * number of ranges, and they are validated against the address and size
+     * of the association, in case two events share the same ID.
+     * The boundaries of the `MaxEvents` most recent events are kept, which
+     * should be more than the events processed concurrently; boundaries in
+     * use by proxies stay valid after they leave the cache.
+     *
+     * The validation is not bulletproof: a job reading two events with the
+     * same ID (e.g. from concatenated samples) may find the association of the
+     * second one at the same address and with the same size as the first one,
+     * and it would be served the grouping of the first event.
+     * For this reason the cache is disabled by default, and it should be
+     * enabled (`AssociationRangeCache::instance().setEnabled(true)`) only in
+     * jobs where event IDs are known to be unique.
+     *
+     * The cache is thread-safe.
+     */
+    class AssociationRangeCache {
+    public:
+      /// Shared, read-only boundaries of a grouped association.
+      using groups_ptr_t = std::shared_ptr<GroupIndex const>;
+
+      /// Identifier of an event: run, subrun and event number.
+      using event_key_t = std::tuple<std::uint64_t, std::uint64_t, std::uint64_t>;
+
+      /// Identifier of boundaries: event, association product ID, minimum size.
+      using key_t = std::tuple<event_key_t, std::uint64_t, std::size_t>;
+
+      /// Number of events whose boundaries are kept.
+      static constexpr std::size_t MaxEvents = 16;
+
+      /// Returns the cache for the whole job.
+      static AssociationRangeCache& instance()
+      {
+        static AssociationRangeCache cache;
+        return cache;
+      }
+
+      /**
+       * @brief Returns the boundaries for `key`, computing them if needed.
+       * @tparam Make type of callable returning `GroupIndex`
+       * @param key identifier of the boundaries
+       * @param assns address of the association object
+       * @param assnsSize number of elements in the association
+       * @param make computes the boundaries, when they are not in the cache
+       * @return the boundaries
+       */
+      template <typename Make>
+      groups_ptr_t get(key_t const& key, void const* assns, std::size_t assnsSize, Make make);
+
+      /// Returns the number of cached boundary lists.
+      std::size_t size() const
+      {
+        std::lock_guard<std::mutex> lock(fMutex);
+        return fEntries.size();
+      }
+
+      /// Returns the number of requests served from the cache.
+      std::size_t nHits() const
+      {
+        std::lock_guard<std::mutex> lock(fMutex);
+        return fHits;
+      }
+
+      /// Returns whether the cache is used.
+      bool enabled() const
+      {
+        std::lock_guard<std::mutex> lock(fMutex);
+        return fEnabled;
+      }
+
+      /// Enables or disables (and empties) the cache.
+      void setEnabled(bool enable)
+      {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fEnabled = enable;
+        if (!fEnabled) clearImpl();
+      }
+
+      /// Removes all the boundaries from the cache, and resets the hit count.
+      void clear()
+      {
+        std::lock_guard<std::mutex> lock(fMutex);
+        clearImpl();
+      }
+
+    private:
+      /// Cached boundaries, with the association they were computed from.
+      struct Entry_t {
+        void const* assns = nullptr; ///< Address of the association.
+        std::size_t assnsSize = 0;   ///< Number of association elements.
+        groups_ptr_t groups;         ///< Boundaries.
+      };
+
+      mutable std::mutex fMutex;
+      std::map<key_t, Entry_t> fEntries;
+      std::deque<event_key_t> fEvents; ///< Cached events, oldest first.
+      std::size_t fHits = 0;
+      bool fEnabled = false;
+
+      /// Returns the cached boundaries for `key`, if valid (lock must be held).
+      groups_ptr_t find(key_t const& key, void const* assns, std::size_t assnsSize) const
+      {
+        auto const iEntry = fEntries.find(key);
+        if (iEntry == fEntries.end()) return {};
+        Entry_t const& entry = iEntry->second;
+        if ((entry.assns != assns) || (entry.assnsSize != assnsSize)) return {};
+        return entry.groups;
+      }
+
+      /// Removes the boundaries of the oldest event (lock must be held).
+      void dropOldestEvent()
+      {
+        event_key_t const& event = fEvents.front();
+        auto const first = fEntries.lower_bound(key_t{event, 0, 0});
+        auto last = first;
+        while ((last != fEntries.end()) && (std::get<0>(last->first) == event))
+          ++last;
+        fEntries.erase(first, last);
+        fEvents.pop_front();
+      }
+
+      void clearImpl()
+      {
+        fEntries.clear();
+        fEvents.clear();
+        fHits = 0;
+      }
+
+    }; // class AssociationRangeCache
+
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Returns the cache key of an association, if it can have one.
+     * @tparam Event type of event the association is read from
+     * @tparam Handle type of handle to the association
+     *
+     * A key is available if the event provides its ID (`event.id()`, with
+     * `run()`, `subRun()` and `event()`) and the handle the ID of the data
+     * product (`handle.id().value()`), as for `art::Event`.
+     */
+    template <typename Event, typename Handle, typename = void>
+    struct AssociationRangeCacheKey {
+      static std::optional<AssociationRangeCache::key_t> get(Event const&,
+                                                             Handle const&,
+                                                             std::size_t)
+      {
+        return std::nullopt;
+      }
+    }; // AssociationRangeCacheKey<>
+
+    template <typename Event, typename Handle>
+    struct AssociationRangeCacheKey<
+      Event,
+      Handle,
+      std::void_t<decltype(std::declval<Event const&>().id().event()),
+                  decltype(std::declval<Handle const&>().id().value())>> {
+      static std::optional<AssociationRangeCache::key_t> get(Event const& event,
+                                                             Handle const& handle,
+                                                             std::size_t minSize)
+      {
+        auto const id = event.id();
+        return AssociationRangeCache::key_t{{id.run(), id.subRun(), id.event()},
+                                            handle.id().value(),
+                                            minSize};
+      }
+    }; // AssociationRangeCacheKey<>
+
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Returns the associated data from an association in an event.
+     * @tparam Tag the tag labelling this associated data
+     * @tparam Event type of event the association was read from
+     * @tparam Handle type of (valid) handle to the association
+     * @param event event the association was read from
+     * @param handle handle to the association
+     * @param minSize minimum number of entries in the produced association data
+     * @return a new `AssociatedData` with the associations from `handle`
+     *
+     * The range boundaries are taken from `AssociationRangeCache` if possible.
+     */
+    template <typename Tag, typename Event, typename Handle>
+    auto makeCachedAssociatedData(Event const& event, Handle const& handle, std::size_t minSize)
+    {
+      auto const& assns = *handle;
+      auto makeGroups = [&assns, minSize]() {
+        using std::begin;
+        using std::end;
+        return associationRangeBoundaries<0U>(begin(assns), end(assns), minSize);
+      };
+
+      auto const key = AssociationRangeCacheKey<Event, Handle>::get(event, handle, minSize);
+      AssociationRangeCache& cache = AssociationRangeCache::instance();
+      auto groups = (key && cache.enabled()) ?
+                      cache.get(*key, std::addressof(assns), assns.size(), makeGroups) :
+                      std::make_shared<GroupIndex const>(makeGroups());
+      return makeAssociatedDataFromGroups<Tag>(assns, std::move(groups));
+    } // makeCachedAssociatedData()
+
+  } // namespace details
+
+} // namespace proxy
+
+//------------------------------------------------------------------------------
+//--- template implementation
+//------------------------------------------------------------------------------
+template <typename Make>
+auto proxy::details::AssociationRangeCache::get(key_t const& key,
+                                                void const* assns,
+                                                std::size_t assnsSize,
+                                                Make make) -> groups_ptr_t
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (groups_ptr_t groups = find(key, assns, assnsSize)) {
+      ++fHits;
+      return groups;
+    }
+  }
+
+  // compute outside the lock, so that different associations are grouped concurrently
+  auto groups = std::make_shared<GroupIndex const>(make());
+
+  std::lock_guard<std::mutex> lock(fMutex);
+  if (groups_ptr_t other = find(key, assns, assnsSize)) return other; // someone was faster
+  if (!fEnabled) return groups;
+
+  event_key_t const& event = std::get<0>(key);
+  if (std::find(fEvents.begin(), fEvents.end(), event) == fEvents.end()) {
+    fEvents.push_back(event);
+    while (fEvents.size() > MaxEvents)
+      dropOldestEvent();
+  }
+  fEntries[key] = Entry_t{assns, assnsSize, groups};
+  return groups;
+} // proxy::details::AssociationRangeCache::get()
+
+//------------------------------------------------------------------------------
+
+#endif // LARDATA_RECOBASEPROXY_PROXYBASE_ASSOCIATIONRANGECACHE_H
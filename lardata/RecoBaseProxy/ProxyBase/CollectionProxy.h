@@ -181,7 +181,8 @@ namespace proxy {
     template <typename AuxTag>
     auto get() const -> decltype(auto)
     {
-      return auxByTag<AuxTag>();
+      using aux_coll_t = util::type_with_tag_t<AuxTag, aux_collections_t>;
+      return details::AuxDataAccess<aux_coll_t>::get(aux<aux_coll_t>());
     }
 
     /**
@@ -30,6 +30,26 @@ namespace proxy {
     template <typename AuxCollTuple>
     struct SubstituteWithAuxList;
 
+    /**
+     * @brief Access to the content of auxiliary data, as served to users.
+     * @tparam Aux type of auxiliary data (collection or element)
+     *
+     * Auxiliary data is normally handed to the users as it is stored.
+     * Auxiliary data which is not stored directly (like data loaded on first
+     * access, see `proxy::lazy()`) specializes this class to resolve `Aux` into
+     * the actual data.
+     */
+    template <typename Aux, typename = void>
+    struct AuxDataAccess {
+
+      /// Returns the data in `aux` (that is, `aux` itself).
+      static Aux const& get(Aux const& aux) { return aux; }
+
+      /// Returns whether the data in `aux` is available (always).
+      static constexpr bool loaded(Aux const&) { return true; }
+
+    }; // AuxDataAccess<>
+
   } // namespace details
 
   //--- BEGIN Proxy element infrastructure -------------------------------------
@@ -184,7 +204,9 @@ namespace proxy {
     template <typename Tag>
     auto get() const -> decltype(auto)
     {
-      return std::get<util::index_of_tag_v<Tag, aux_elements_t>>(fAuxData);
+      constexpr std::size_t I = util::index_of_tag_v<Tag, aux_elements_t>;
+      using aux_t = std::tuple_element_t<I, aux_elements_t>;
+      return details::AuxDataAccess<aux_t>::get(std::get<I>(fAuxData));
     }
 
     /**
@@ -0,0 +1,178 @@
+/**
+ * @file   lardata/RecoBaseProxy/ProxyBase/LazyAuxData.h
+ * @brief  Auxiliary data loaded on first access.
+ * @see    lardata/RecoBaseProxy/ProxyBase/lazy.h
+ *
+ * This library is header-only.
+ */
+
+#ifndef LARDATA_RECOBASEPROXY_PROXYBASE_LAZYAUXDATA_H
+#define LARDATA_RECOBASEPROXY_PROXYBASE_LAZYAUXDATA_H
+
+// LArSoft libraries
+#include "lardata/RecoBaseProxy/ProxyBase/CollectionProxyElement.h" // AuxDataAccess
+#include "lardata/Utilities/TupleLookupByTag.h" // util::tag_of_t
+
+// C/C++ standard
+#include <atomic>
+#include <cstdlib>    // std::size_t
+#include <functional> // std::function<>
+#include <memory>     // std::shared_ptr<>, std::make_shared()
+#include <mutex>      // std::once_flag, std::call_once()
+#include <optional>
+#include <type_traits> // std::is_same<>
+#include <utility>     // std::move()
+
+namespace proxy {
+
+  namespace details {
+
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Creates and holds auxiliary data on first request.
+     * @tparam AuxColl type of auxiliary data collection being held
+     *
+     * The auxiliary data collection is created by a function set at
+     * construction, the first time it is requested by `get()`.
+     * The creation happens only once even when `get()` is called concurrently
+     * from different threads. If the creation throws an exception, the
+     * exception is propagated and the creation will be attempted again at the
+     * next request.
+     */
+    template <typename AuxColl>
+    class LazyAuxDataLoader {
+    public:
+      /// Type of the held auxiliary data collection.
+      using aux_collection_t = AuxColl;
+
+      /// Type of function creating the auxiliary data collection.
+      using loader_t = std::function<aux_collection_t()>;
+
+      /// Constructor: `load` will create the collection when needed.
+      LazyAuxDataLoader(loader_t load) : fLoad(std::move(load)) {}
+
+      /// Returns the auxiliary data collection, creating it if needed.
+      aux_collection_t const& get() const
+      {
+        std::call_once(fOnce, [this]() {
+          fData.emplace(fLoad());
+          fLoad = nullptr; // releases the references to the event
+          fLoaded = true;
+        });
+        return *fData;
+      }
+
+      /// Returns whether the auxiliary data collection has been created yet.
+      bool loaded() const { return fLoaded; }
+
+    private:
+      mutable std::once_flag fOnce;                 ///< Protects the creation.
+      mutable loader_t fLoad;                       ///< Creation function.
+      mutable std::optional<aux_collection_t> fData; ///< The collection, once created.
+      mutable std::atomic<bool> fLoaded{false};      ///< Whether `fData` is available.
+
+    }; // class LazyAuxDataLoader
+
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Auxiliary data of a single element, loaded on first access.
+     * @tparam AuxColl type of auxiliary data collection the data belongs to
+     *
+     * This object stands for `AuxColl::auxiliary_data_t`; the actual data is
+     * delivered by `get()` (or by `proxy::CollectionProxyElement::get()`),
+     * which loads the whole auxiliary collection if not loaded yet.
+     */
+    template <typename AuxColl>
+    class LazyAuxDataElement {
+    public:
+      /// Tag of the auxiliary data.
+      using tag = util::tag_of_t<AuxColl>;
+
+      /// Constructor: refers to element `index` of the data from `loader`.
+      LazyAuxDataElement(std::shared_ptr<LazyAuxDataLoader<AuxColl> const> loader,
+                         std::size_t index)
+        : fLoader(std::move(loader)), fIndex(index)
+      {}
+
+      /// Returns the auxiliary data of the element, loading it if needed.
+      decltype(auto) get() const { return fLoader->get()[fIndex]; }
+
+    private:
+      std::shared_ptr<LazyAuxDataLoader<AuxColl> const> fLoader; ///< Data loader.
+      std::size_t fIndex; ///< Index of the element in the collection.
+
+    }; // class LazyAuxDataElement
+
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Auxiliary data collection loaded on first access.
+     * @tparam AuxColl type of the auxiliary data collection being wrapped
+     * @see `proxy::lazy()`
+     *
+     * This object takes the place of an auxiliary data collection of type
+     * `AuxColl` in a collection proxy. The collection is created only when its
+     * content is accessed first, either directly from the collection proxy
+     * (`get()`) or from one of its elements.
+     * Creating element proxies does not load anything.
+     *
+     * Copies of this object share the same data.
+     */
+    template <typename AuxColl>
+    class LazyAuxData {
+      using loader_t = LazyAuxDataLoader<AuxColl>; ///< Type of data loader.
+
+    public:
+      /// Type of the wrapped auxiliary data collection.
+      using aux_collection_t = AuxColl;
+
+      /// Tag of the auxiliary data.
+      using tag = util::tag_of_t<aux_collection_t>;
+
+      /// Type of auxiliary data of a single element.
+      using auxiliary_data_t = LazyAuxDataElement<aux_collection_t>;
+
+      /// Constructor: `load` will create the collection when needed.
+      LazyAuxData(typename loader_t::loader_t load)
+        : fData(std::make_shared<loader_t const>(std::move(load)))
+      {}
+
+      /// Returns the auxiliary data of element `i`, without loading it.
+      auxiliary_data_t operator[](std::size_t i) const { return {fData, i}; }
+
+      /// Returns the auxiliary data collection, loading it if needed.
+      aux_collection_t const& auxData() const { return fData->get(); }
+
+      /// Returns whether the auxiliary data collection has been loaded yet.
+      bool loaded() const { return fData->loaded(); }
+
+      /// Returns whether this data is labelled with the specified tag.
+      template <typename TestTag>
+      static constexpr bool hasTag()
+      {
+        return std::is_same<TestTag, tag>();
+      }
+
+    private:
+      std::shared_ptr<loader_t const> fData; ///< Data, possibly not loaded yet.
+
+    }; // class LazyAuxData
+
+    //--------------------------------------------------------------------------
+    template <typename AuxColl>
+    struct AuxDataAccess<LazyAuxDataElement<AuxColl>> {
+      static decltype(auto) get(LazyAuxDataElement<AuxColl> const& aux) { return aux.get(); }
+    }; // AuxDataAccess<LazyAuxDataElement>
+
+    template <typename AuxColl>
+    struct AuxDataAccess<LazyAuxData<AuxColl>> {
+      static AuxColl const& get(LazyAuxData<AuxColl> const& aux) { return aux.auxData(); }
+      static bool loaded(LazyAuxData<AuxColl> const& aux) { return aux.loaded(); }
+    }; // AuxDataAccess<LazyAuxData>
+
+    //--------------------------------------------------------------------------
+
+  } // namespace details
+
+} // namespace proxy
+
+#endif // LARDATA_RECOBASEPROXY_PROXYBASE_LAZYAUXDATA_H
@@ -20,8 +20,11 @@
 #include "canvas/Persistency/Common/Ptr.h"
 
 // C/C++ standard
+#include <algorithm>   // std::max()
+#include <bitset>      // std::bitset<>::count()
+#include <cstdint>     // std::uint64_t, std::uint32_t
 #include <cstdlib>     // std::size_t
-#include <iterator>    // std::cbegin(), std::cend()
+#include <iterator>    // std::cbegin(), std::cend(), std::distance()
 #include <tuple>       // std::tuple_element_t<>, std::get()
 #include <type_traits> // std::is_convertible<>
 #include <utility>     // std::move()
@@ -29,8 +32,90 @@
 
 namespace proxy {
 
+  /// How one-to-(zero-or-one) associated data is stored (see `makeOneTo01data()`).
+  enum class OneTo01Storage {
+    Automatic, ///< `Compact` if few main elements are associated, `Full` otherwise.
+    Full,      ///< One _art_ pointer per main element (default).
+    Compact    ///< Only the associated pointers, plus one bit per main element.
+  }; // OneTo01Storage
+
   namespace details {
 
+    /**
+     * @brief Sequence of optional values stored only where present.
+     * @tparam T type of the stored values
+     *
+     * A bitmap records which of the `size()` elements have a value, and the
+     * values are stored contiguously in element order. The position of a value
+     * is found from the number of present elements before it: that number is
+     * precomputed for each 64-element block of the bitmap.
+     *
+     * The sequence is built in two steps: all the present elements are first
+     * `mark()`ed, then `allocate()` makes room for their values, which can be
+     * assigned via `at()`.
+     */
+    template <typename T>
+    class SparseSequence {
+      using block_t = std::uint64_t; ///< Type of bitmap block.
+      static constexpr std::size_t BlockBits = 64;
+
+    public:
+      using value_type = T;
+
+      SparseSequence() = default;
+
+      /// Constructor: `size` elements, none present.
+      explicit SparseSequence(std::size_t size)
+        : fSize(size), fPresent((size + BlockBits - 1) / BlockBits, block_t{0})
+      {}
+
+      /// Returns the number of elements (present or not).
+      std::size_t size() const { return fSize; }
+
+      /// Returns whether element `i` is present (`false` if out of range).
+      bool has(std::size_t i) const
+      {
+        return (i < fSize) && (fPresent[i / BlockBits] & bit(i));
+      }
+
+      /// Returns a pointer to the value of element `i`, `nullptr` if not present.
+      T const* find(std::size_t i) const { return has(i) ? &fData[position(i)] : nullptr; }
+
+      /// Marks element `i` as present (before `allocate()` only).
+      void mark(std::size_t i) { fPresent[i / BlockBits] |= bit(i); }
+
+      /// Allocates the values of the marked elements (default-constructed).
+      void allocate()
+      {
+        fRank.resize(fPresent.size());
+        std::uint32_t n = 0;
+        for (std::size_t iBlock = 0; iBlock < fPresent.size(); ++iBlock) {
+          fRank[iBlock] = n;
+          n += std::bitset<BlockBits>(fPresent[iBlock]).count();
+        }
+        fData.resize(n);
+      }
+
+      /// Returns the value of the present element `i` (after `allocate()`).
+      T& at(std::size_t i) { return fData[position(i)]; }
+
+    private:
+      std::size_t fSize = 0;             ///< Number of elements.
+      std::vector<block_t> fPresent;     ///< One bit per element.
+      std::vector<std::uint32_t> fRank;  ///< Elements present before each block.
+      std::vector<T> fData;              ///< Values of the present elements.
+
+      static block_t bit(std::size_t i) { return block_t{1} << (i % BlockBits); }
+
+      /// Position in `fData` of the value of element `i`.
+      std::size_t position(std::size_t i) const
+      {
+        block_t const before = fPresent[i / BlockBits] & (bit(i) - 1);
+        return fRank[i / BlockBits] + std::bitset<BlockBits>(before).count();
+      }
+
+    }; // class SparseSequence<>
+
     /**
      * @brief Object for one-to-zero/or/one associated data interface.
      * @tparam Main type of the main associated object (one)
@@ -45,7 +130,8 @@ namespace proxy {
      * Construction is not part of the interface.
      *
      * The `OneTo01Data` object acquires a vector of _art_ pointers, one for
-     * each element in the main collection.
+     * each element in the main collection, or, in compact form, only the
+     * pointers of the associated elements (`SparseSequence`).
      * It is an implementation detail for associations fulfilling the
      * @ref LArSoftProxyDefinitionOneToZeroOrOneSeqAssn "one-to-(zero-or-one) sequential association"
      * requirement.
@@ -90,16 +176,29 @@ namespace proxy {
       /// Type of collection of auxiliary data for all main elements.
       using aux_coll_t = std::vector<aux_ptr_t>;
 
+      /// Type of compact collection of auxiliary data of associated elements.
+      using sparse_aux_coll_t = SparseSequence<aux_ptr_t>;
+
       /// Type of the source association.
       using assns_t = art::Assns<main_t, aux_t>;
 
       OneTo01Data(aux_coll_t&& data) : auxData(std::move(data)) {}
 
+      OneTo01Data(sparse_aux_coll_t&& data) : sparseData(std::move(data)), fCompact(true) {}
+
       /// Returns whether the element `i` is associated with auxiliary datum.
-      bool has(std::size_t i) const { return get(i) == aux_ptr_t(); }
+      bool has(std::size_t i) const { return get(i) != aux_ptr_t(); }
 
       /// Returns a copy of the pointer to data associated with element `i`.
-      auxiliary_data_t get(std::size_t i) const { return auxiliary_data_t(auxData[i]); }
+      auxiliary_data_t get(std::size_t i) const
+      {
+        if (!fCompact) return auxiliary_data_t(auxData[i]);
+        aux_ptr_t const* ptr = sparseData.find(i);
+        return auxiliary_data_t(ptr ? *ptr : aux_ptr_t());
+      }
+
+      /// Returns whether only the pointers of associated elements are stored.
+      bool compact() const { return fCompact; }
 
       /// Returns the range with the specified index (no check performed).
       auto operator[](std::size_t index) const -> decltype(auto)
@@ -110,7 +209,9 @@ namespace proxy {
       }
 
     private:
-      aux_coll_t auxData; ///< Data associated to the main collection.
+      aux_coll_t auxData;           ///< Data associated to the main collection.
+      sparse_aux_coll_t sparseData; ///< Data of associated elements (compact form).
+      bool fCompact = false;        ///< Whether `sparseData` is used.
 
     }; // class OneTo01Data<>
 
@@ -124,6 +225,7 @@ namespace proxy {
    * @tparam Assns type of association to be processed
    * @param assns association object to be processed
    * @param minSize minimum number of entries in the produced association data
+   * @param storage how to store the associated pointers
    * @return a new `OneTo01Data` filled with associations from `tag`
    *
    * The content of the association object must fulfill the requirements of
@@ -140,6 +242,17 @@ namespace proxy {
    * less than `minSize` main objects, more records will be added to mark the
    * missing objects as not associated to anything.
    *
+   * The association is scanned once to find the size of the data, which is
+   * then allocated once and filled directly from the association keys.
+   * By default (`OneTo01Storage::Full`) one pointer is stored per main
+   * element. With `OneTo01Storage::Compact` storage, only the pointers of the
+   * associated main elements are kept, plus one bit per main element, which
+   * saves memory when few of the main elements are associated, at the price
+   * of a slightly slower access and of one more scan of the association.
+   * `OneTo01Storage::Automatic` chooses the compact storage when no more than
+   * one main element in `details::CompactDensity` is associated; the choice
+   * is made after the first scan, from the number of associations.
+   *
    * Example:
    * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
    * art::Assns<recob::Track, recob::Vertex> trackVertexAssns;
@@ -152,12 +265,16 @@ namespace proxy {
    * is used as tag.
    */
   template <typename Tag, typename Assns>
-  auto makeOneTo01data(Assns const& assns, std::size_t minSize = 0);
+  auto makeOneTo01data(Assns const& assns,
+                       std::size_t minSize = 0,
+                       OneTo01Storage storage = OneTo01Storage::Full);
 
   template <typename Assns>
-  auto makeOneTo01data(Assns const& assns, std::size_t minSize = 0)
+  auto makeOneTo01data(Assns const& assns,
+                       std::size_t minSize = 0,
+                       OneTo01Storage storage = OneTo01Storage::Full)
   {
-    return makeOneTo01data<typename Assns::right_t>(assns, minSize);
+    return makeOneTo01data<typename Assns::right_t>(assns, minSize, storage);
   }
   //@}
 
@@ -203,65 +320,79 @@ namespace proxy {
   namespace details {
 
     //--------------------------------------------------------------------------
-    // Extends vector v with default-constructed data
-    // and executes v[index]=value
-    template <typename T>
-    void extendAndAssign(std::vector<T>& v,
-                         typename std::vector<T>::size_type index,
-                         typename std::vector<T>::value_type const& value)
+    /// `OneTo01Storage::Automatic` picks compact storage when no more than one
+    /// main element every `CompactDensity` is associated.
+    constexpr std::size_t CompactDensity = 4;
+
+    //--------------------------------------------------------------------------
+    // Returns the number of main elements: at least n, and all the keys
+    template <std::size_t Key, typename Iter>
+    std::size_t associationKeySize(Iter begin, Iter end, std::size_t n)
     {
-      if (index >= v.size()) {
-        v.reserve(index + 1);
-        v.resize(index);
-        v.push_back(value);
-      }
-      else
-        v[index] = value;
-    } // extendAndAssign()
+      std::size_t size = n;
+      for (auto it = begin; it != end; ++it)
+        size = std::max(size, std::size_t(std::get<Key>(*it).key()) + 1);
+      return size;
+    } // associationKeySize()
 
-    // Extends vector v with default-constructed data
-    // and executes v[index]=move(value)
-    template <typename T>
-    void extendAndAssign(std::vector<T>& v,
-                         typename std::vector<T>::size_type index,
-                         typename std::vector<T>::value_type&& value)
+    //--------------------------------------------------------------------------
+    // Returns which of the size main elements have an association, as a
+    // sequence of Data to be filled by associationOneToOneSparseSequence();
+    // size must include all the keys (see associationKeySize())
+    template <std::size_t Key, std::size_t Data, typename Iter>
+    auto associationKeyMap(Iter begin, Iter end, std::size_t size)
     {
-      if (index >= v.size()) {
-        v.reserve(index + 1);
-        v.resize(index);
-        v.push_back(std::move(value));
-      }
-      else
-        v[index] = std::move(value);
-    } // extendAndAssign()
+      using value_type = typename Iter::value_type;
+      using data_t = std::tuple_element_t<Data, value_type>;
+      SparseSequence<data_t> keys(size);
+      for (auto it = begin; it != end; ++it)
+        keys.mark(std::get<Key>(*it).key());
+      return keys;
+    } // associationKeyMap()
 
     //--------------------------------------------------------------------------
     template <std::size_t Key, std::size_t Data, typename Iter>
-    auto associationOneToOneFullSequence(Iter begin, Iter end, std::size_t n)
+    auto associationOneToOneFullSequence(Iter begin, Iter end, std::size_t size)
     {
       //
       // Here we are actually not using the assumption that the keys are in
       // increasing order; which is just as good as long as we use a fast random
       // access container as STL vector.
       // We do assume the key side of the association to be valid, though.
+      // The size, including all the keys, is found first by the caller
+      // (see associationKeySize()), so that the data is allocated only once.
       //
       using value_type = typename Iter::value_type;
       using data_t = std::tuple_element_t<Data, value_type>;
-      std::vector<data_t> data(n); // all default-constructed
-      for (auto it = begin; it != end; ++it) {
-        auto const& keyPtr = std::get<Key>(*it);
-        extendAndAssign(data, keyPtr.key(), std::get<Data>(*it));
-      }
+      std::vector<data_t> data(size); // all default-constructed
+      for (auto it = begin; it != end; ++it)
+        data[std::get<Key>(*it).key()] = std::get<Data>(*it);
       return data;
     } // associationOneToOneFullSequence(Iter, Iter, std::size_t)
 
+    //--------------------------------------------------------------------------
+    // Fills the values of the elements marked in keys (from associationKeyMap())
+    template <std::size_t Key, std::size_t Data, typename Iter, typename T>
+    SparseSequence<T> associationOneToOneSparseSequence(Iter begin,
+                                                        Iter end,
+                                                        SparseSequence<T>&& keys)
+    {
+      keys.allocate();
+      for (auto it = begin; it != end; ++it)
+        keys.at(std::get<Key>(*it).key()) = std::get<Data>(*it);
+      return std::move(keys);
+    } // associationOneToOneSparseSequence()
+
   } // namespace details
 
   //----------------------------------------------------------------------------
   //--- makeOneTo01data() implementation
   //----------------------------------------------------------------------------
   template <typename Tag, typename Assns>
-  auto makeOneTo01data(Assns const& assns, std::size_t minSize /* = 0 */)
+  auto makeOneTo01data(Assns const& assns,
+                       std::size_t minSize /* = 0 */,
+                       OneTo01Storage storage /* = OneTo01Storage::Full */
+  )
   {
     using Main_t = typename Assns::left_t;
     using Aux_t = typename Assns::right_t;
@@ -270,8 +401,22 @@ namespace proxy {
 
     using std::cbegin;
     using std::cend;
-    return AssociatedData_t(
-      details::associationOneToOneFullSequence<0U, 1U>(cbegin(assns), cend(assns), minSize));
+    std::size_t const size = details::associationKeySize<0U>(cbegin(assns), cend(assns), minSize);
+
+    bool compact = (storage == OneTo01Storage::Compact);
+    if (storage == OneTo01Storage::Automatic) {
+      // each main element has at most one association
+      std::size_t const nAssns = std::distance(cbegin(assns), cend(assns));
+      compact = (nAssns * details::CompactDensity <= size);
+    }
+    if (!compact) {
+      return AssociatedData_t(
+        details::associationOneToOneFullSequence<0U, 1U>(cbegin(assns), cend(assns), size));
+    }
+    return AssociatedData_t(details::associationOneToOneSparseSequence<0U, 1U>(
+      cbegin(assns),
+      cend(assns),
+      details::associationKeyMap<0U, 1U>(cbegin(assns), cend(assns), size)));
   } // makeOneTo01data(assns)
 
   //----------------------------------------------------------------------------
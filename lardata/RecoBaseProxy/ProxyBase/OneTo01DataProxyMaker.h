@@ -135,14 +135,71 @@ namespace proxy {
       return makeOneTo01dataFrom<data_tag>(assns, handle->size());
     }
 
+    /**
+     * @brief Create a association proxy collection using main collection tag.
+     * @param storage how to store the associated pointers
+     * @see `make(Event const&, Handle&&, MainArgs const&)`
+     *
+     * This is the same as the version without `storage` argument, which uses
+     * `OneTo01Storage::Full`.
+     */
+    template <typename Event, typename Handle, typename MainArgs>
+    static auto make(Event const& event,
+                     Handle&& mainHandle,
+                     MainArgs const& mainArgs,
+                     OneTo01Storage storage)
+    {
+      return createFromTag(
+        event, std::forward<Handle>(mainHandle), art::InputTag(mainArgs), storage);
+    }
+
+    /**
+     * @brief Create a association proxy collection using the specified tag.
+     * @param storage how to store the associated pointers
+     * @see `make(Event const&, Handle&&, MainArgs const&, art::InputTag const&)`
+     *
+     * This is the same as the version without `storage` argument, which uses
+     * `OneTo01Storage::Full`.
+     */
+    template <typename Event, typename Handle, typename MainArgs>
+    static auto make(Event const& event,
+                     Handle&& mainHandle,
+                     MainArgs const&,
+                     art::InputTag const& auxInputTag,
+                     OneTo01Storage storage)
+    {
+      return createFromTag(event, std::forward<Handle>(mainHandle), auxInputTag, storage);
+    }
+
+    /**
+     * @brief Create a association proxy collection from the associations.
+     * @param storage how to store the associated pointers
+     * @see `make(Event const&, Handle&&, MainArgs const&, Assns const&)`
+     *
+     * This is the same as the version without `storage` argument, which uses
+     * `OneTo01Storage::Full`.
+     */
+    template <typename Event, typename Handle, typename MainArgs, typename Assns>
+    static auto make(Event const&,
+                     Handle&& handle,
+                     MainArgs const&,
+                     Assns const& assns,
+                     OneTo01Storage storage)
+    {
+      static_assert(std::is_convertible<typename Assns::right_t, aux_element_t>(),
+                    "Improper right type for one-to-(zero-or-one) association.");
+      return makeOneTo01dataFrom<data_tag>(assns, handle->size(), storage);
+    }
+
   private:
     template <typename Event, typename Handle>
     static auto createFromTag(Event const& event,
                               Handle&& mainHandle,
-                              art::InputTag const& auxInputTag)
+                              art::InputTag const& auxInputTag,
+                              OneTo01Storage storage = OneTo01Storage::Full)
     {
       return makeOneTo01dataFrom<main_element_t, aux_element_t, metadata_t, data_tag>(
-        event, auxInputTag, mainHandle->size());
+        event, auxInputTag, mainHandle->size(), storage);
     }
 
   }; // struct OneTo01DataProxyMakerBase<>
@@ -211,11 +268,12 @@ namespace proxy {
      * @tparam Event type of the event to read associations from
      * @tparam Handle type of data product handle
      * @tparam MainArgs any type convertible to `art::InputTag`
-     * @tparam Args optional single type (`art::InputTag` required)
+     * @tparam Args optional input tag, and optional `OneTo01Storage`
      * @param event the event to read associations from
      * @param mainHandle handle of the main collection data product
      * @param margs an object describing the main data product
-     * @param args input tag for associated data, if different from main
+     * @param args input tag for associated data, if different from main,
+     *             and storage of the associated pointers (default: `Full`)
      * @return an auxiliary data proxy object
      *
      * The returned object exposes a random access container interface, with
@@ -85,6 +85,9 @@ namespace proxy {
       using proxy_maker_t = ProxyMaker<CollProxy>;
 
     public:
+      /// Type of the tuple of stored arguments.
+      using arg_tuple_t = ArgTuple;
+
       /// Type of association proxy created for the specified `CollProxy`.
       template <typename CollProxy>
       using aux_collection_proxy_t = typename proxy_maker_t<CollProxy>::aux_collection_proxy_t;
@@ -101,6 +104,14 @@ namespace proxy {
           event, std::forward<Handle>(mainHandle), mainArgs, std::make_index_sequence<NArgs>());
       } // construct()
 
+      /// Returns an equivalent object storing the arguments as `NewArgTuple`.
+      template <typename NewArgTuple>
+      auto withArgumentsAs() &&
+      {
+        return WithAssociatedStructBase<Aux, Metadata, NewArgTuple, ProxyMaker, AuxTag>(
+          NewArgTuple(std::move(args)));
+      }
+
     protected:
       ArgTuple args; ///< Argument construction storage as tuple.
 
@@ -71,6 +71,9 @@ namespace proxy {
       using proxy_maker_t = ProxyAsAuxProxyMaker<main_t<CollProxy>, aux_proxy_t, CollProxy, tag>;
 
     public:
+      /// Type of the tuple of stored arguments.
+      using arg_tuple_t = ArgTuple;
+
       /// Constructor: steals the arguments, to be used by
       /// `createAuxProxyMaker()`.
       WithProxyAsAuxStructBase(ArgTuple&& args) : args(std::move(args)) {}
@@ -83,6 +86,14 @@ namespace proxy {
           event, std::forward<Handle>(mainHandle), mainArgs, std::make_index_sequence<NArgs>());
       } // construct()
 
+      /// Returns an equivalent object storing the arguments as `NewArgTuple`.
+      template <typename NewArgTuple>
+      auto withArgumentsAs() &&
+      {
+        return WithProxyAsAuxStructBase<AuxProxy, NewArgTuple, AuxTag>(
+          NewArgTuple(std::move(args)));
+      }
+
     protected:
       ArgTuple args; ///< Argument construction storage as tuple.
 
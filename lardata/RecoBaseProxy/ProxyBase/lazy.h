@@ -0,0 +1,160 @@
+/**
+ * @file   lardata/RecoBaseProxy/ProxyBase/lazy.h
+ * @brief  Loading of auxiliary data of a proxy on first access.
+ * @see    lardata/RecoBaseProxy/ProxyBase.h
+ *
+ * This library is header-only.
+ */
+
+#ifndef LARDATA_RECOBASEPROXY_PROXYBASE_LAZY_H
+#define LARDATA_RECOBASEPROXY_PROXYBASE_LAZY_H
+
+// LArSoft libraries
+#include "lardata/RecoBaseProxy/ProxyBase/LazyAuxData.h"
+#include "lardata/Utilities/TupleLookupByTag.h" // util::type_with_tag_t
+
+// C/C++ standard
+#include <tuple>
+#include <type_traits> // std::conditional_t<>, std::decay_t<>, ...
+#include <utility>     // std::move(), std::declval()
+
+namespace proxy {
+
+  //----------------------------------------------------------------------------
+  namespace details {
+
+    //--------------------------------------------------------------------------
+    /// Type to store an argument of type `Arg` beyond the call it was given to.
+    template <typename Arg>
+    using stored_argument_t =
+      std::conditional_t<std::is_lvalue_reference_v<Arg>, Arg, std::decay_t<Arg>>;
+
+    template <typename ArgTuple>
+    struct StoredArgumentTuple;
+
+    template <typename... Args>
+    struct StoredArgumentTuple<std::tuple<Args...>> {
+      using type = std::tuple<stored_argument_t<Args>...>;
+    };
+
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Helper to create auxiliary data loaded on first access.
+     * @tparam WithArg type of the helper creating the auxiliary data
+     *
+     * This class wraps a helper like the one from `proxy::withAssociated()`,
+     * and it delays the creation of its auxiliary data (by
+     * `WithArg::createAuxProxyMaker()`) until that data is first accessed.
+     * The result is a `LazyAuxData` object.
+     *
+     * The helper `WithArg` must own its arguments or refer to objects that
+     * outlive the proxy (see `proxy::lazy()`).
+     */
+    template <typename WithArg>
+    class WithLazyStruct {
+    public:
+      /// Constructor: steals the helper creating the auxiliary data.
+      WithLazyStruct(WithArg&& withArg) : fWithArg(std::move(withArg)) {}
+
+      /// Creates the auxiliary data proxy, to be loaded on first access.
+      template <typename CollProxy, typename Event, typename Handle, typename MainArgs>
+      auto createAuxProxyMaker(Event const& event, Handle&& mainHandle, MainArgs const& mainArgs)
+      {
+        using handle_t = std::decay_t<Handle>;
+        using aux_collection_t =
+          decltype(std::declval<WithArg&>().template createAuxProxyMaker<CollProxy>(
+            event, std::declval<handle_t const&>(), mainArgs));
+
+        return LazyAuxData<aux_collection_t>(
+          [withArg = fWithArg, &event, mainHandle = handle_t(mainHandle), mainArgs]() {
+            WithArg with = withArg; // creation consumes the arguments; keep the originals
+            return with.template createAuxProxyMaker<CollProxy>(event, mainHandle, mainArgs);
+          });
+      } // createAuxProxyMaker()
+
+    private:
+      WithArg fWithArg; ///< Helper creating the auxiliary data.
+
+    }; // class WithLazyStruct<>
+
+    //--------------------------------------------------------------------------
+
+  } // namespace details
+
+  //----------------------------------------------------------------------------
+  /**
+   * @brief Requests auxiliary data to be loaded only when first accessed.
+   * @tparam WithArg type of the helper of the auxiliary data to be loaded
+   * @param withArg the helper of the auxiliary data (e.g. `withAssociated()`)
+   * @return a temporary object that `getCollection()` knows to handle
+   * @ingroup LArSoftProxyBase
+   *
+   * By default, all auxiliary data of a collection proxy is read from the
+   * event and indexed when the proxy is created. Wrapping the request of an
+   * auxiliary data in `lazy()` delays this until the data is actually used,
+   * either from the collection proxy or from any of its elements:
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+   * auto tracks = proxy::getCollection<proxy::Tracks>(event, tracksTag,
+   *   proxy::lazy(proxy::withAssociated<recob::SpacePoint>(spacePointTag))
+   *   );
+   *
+   * for (auto const& track: tracks) {
+   *   if (track->Length() < 100.0) continue;
+   *   // space point associations are read and indexed here, only once
+   *   for (art::Ptr<recob::SpacePoint> const& spacePoint
+   *     : track.get<recob::SpacePoint>())
+   *   {
+   *     // ...
+   *   }
+   * }
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   * Auxiliary data that is never accessed is never read.
+   * The loading happens once per proxy (copies of the proxy and of its
+   * elements share the loaded data), and it is safe for concurrent access from
+   * different threads.
+   * Whether some data has been already loaded is told by `isAuxDataLoaded()`.
+   *
+   * Since the data may be read after `getCollection()` has returned, the
+   * objects it is read from must still be available at that time:
+   * the event, and all the arguments of the auxiliary data helper which are
+   * given as references (e.g. an input tag stored in a variable).
+   * Temporary arguments (like `art::InputTag{ "pandora" }`) are copied.
+   *
+   * A proxy whose data is not loaded yet is cheaper to create, but access to
+   * each element is slower. Lazy loading pays off when only a fraction of the
+   * main elements is inspected, or when the auxiliary data is not always
+   * needed.
+   */
+  template <typename WithArg>
+  auto lazy(WithArg withArg)
+  {
+    using stored_tuple_t =
+      typename details::StoredArgumentTuple<typename WithArg::arg_tuple_t>::type;
+    auto storedWithArg = std::move(withArg).template withArgumentsAs<stored_tuple_t>();
+    return details::WithLazyStruct<decltype(storedWithArg)>(std::move(storedWithArg));
+  } // lazy()
+
+  //----------------------------------------------------------------------------
+  /**
+   * @brief Returns whether the auxiliary data with the specified tag is loaded.
+   * @tparam Tag tag of the auxiliary data to be checked
+   * @tparam CollProxy type of collection proxy
+   * @param proxy the collection proxy holding the auxiliary data
+   * @return whether the auxiliary data with tag `Tag` is loaded in `proxy`
+   * @ingroup LArSoftProxyBase
+   * @see `lazy()`
+   *
+   * All auxiliary data not requested via `lazy()` is always loaded.
+   */
+  template <typename Tag, typename CollProxy>
+  bool isAuxDataLoaded(CollProxy const& proxy)
+  {
+    using aux_coll_t = util::type_with_tag_t<Tag, typename CollProxy::aux_collections_t>;
+    return details::AuxDataAccess<aux_coll_t>::loaded(static_cast<aux_coll_t const&>(proxy));
+  }
+
+  //----------------------------------------------------------------------------
+
+} // namespace proxy
+
+#endif // LARDATA_RECOBASEPROXY_PROXYBASE_LAZY_H
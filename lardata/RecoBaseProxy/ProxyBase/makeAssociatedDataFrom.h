@@ -14,6 +14,7 @@
 // LArSoft libraries
 #include "larcorealg/CoreUtils/ContainerMeta.h" // util::collection_value_t, ...
 #include "lardata/RecoBaseProxy/ProxyBase/AssociatedData.h"
+#include "lardata/RecoBaseProxy/ProxyBase/AssociationRangeCache.h"
 
 // framework libraries
 #include "canvas/Persistency/Common/Assns.h"
@@ -61,6 +62,10 @@ namespace proxy {
    * objects, more records will be added to mark the missing objects as not
    * associated to anything.
    *
+   * If `details::AssociationRangeCache` is enabled, the grouping of the
+   * association is shared with the other associated data from the same
+   * association in the same event.
+   *
    * Two template types must be explicitly specified, e.g.
    * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
    * auto assData = makeAssociatedDataFrom<recob::Track, recob::Hit>(event, tag);
@@ -178,7 +183,8 @@ namespace proxy {
     using AssociatedData_t = details::AssociatedData<Main_t, Aux_t, Metadata_t, Tag>;
     using Assns_t = typename AssociatedData_t::assns_t;
 
-    return makeAssociatedDataFrom<Tag>(*(event.template getValidHandle<Assns_t>(tag)));
+    return details::makeCachedAssociatedData<Tag>(
+      event, event.template getValidHandle<Assns_t>(tag), minSize);
 
   } // makeAssociatedDataFrom(tag)
 
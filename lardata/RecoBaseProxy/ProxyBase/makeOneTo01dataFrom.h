@@ -38,7 +38,9 @@ namespace proxy {
    * @tparam Assns type of association to be processed
    * @param assns association object to be processed
    * @param minSize minimum number of entries in the produced association data
+   * @param storage how to store the associated pointers
    * @return a new `OneTo01Data` filled with associations from `tag`
+   * @see `makeOneTo01data()`
    *
    * The content of the association object must fulfill the requirements of
    * @ref LArSoftProxyDefinitionOneToZeroOrOneSeqAssn "one-to-(zero or one) sequential association".
@@ -63,15 +65,19 @@ namespace proxy {
    * will have `assData` tagged as `recob::Vertex`.
    */
   template <typename Tag, typename Assns>
-  auto makeOneTo01dataFrom(Assns const& assns, std::size_t minSize = 0)
+  auto makeOneTo01dataFrom(Assns const& assns,
+                           std::size_t minSize = 0,
+                           OneTo01Storage storage = OneTo01Storage::Full)
   {
-    return proxy::makeOneTo01data<Tag>(assns, minSize);
+    return proxy::makeOneTo01data<Tag>(assns, minSize, storage);
   }
 
   template <typename Assns>
-  auto makeOneTo01dataFrom(Assns const& assns, std::size_t minSize = 0)
+  auto makeOneTo01dataFrom(Assns const& assns,
+                           std::size_t minSize = 0,
+                           OneTo01Storage storage = OneTo01Storage::Full)
   {
-    return proxy::makeOneTo01data(assns, minSize);
+    return proxy::makeOneTo01data(assns, minSize, storage);
   }
 
   /**
@@ -84,8 +90,9 @@ namespace proxy {
    * @param event event to read associations from
    * @param tag input tag of the association object
    * @param minSize minimum number of entries in the produced association data
+   * @param storage how to store the associated pointers
    * @return a new `OneTo01Data` filled with associations from `tag`
-   * @see `makeOneTo01dataFrom(Assns, std::size_t)`
+   * @see `makeOneTo01dataFrom(Assns, std::size_t, OneTo01Storage)`
    *
    * The association being retrieved must fulfill the requirements of
    * @ref LArSoftProxyDefinitionOneToZeroOrOneSeqAssn "one-to-(zero or one) sequential association".
@@ -96,12 +103,18 @@ namespace proxy {
    * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
    */
   template <typename Main, typename Aux, typename Metadata, typename Tag, typename Event>
-  auto makeOneTo01dataFrom(Event const& event, art::InputTag const& tag, std::size_t minSize = 0);
+  auto makeOneTo01dataFrom(Event const& event,
+                           art::InputTag const& tag,
+                           std::size_t minSize = 0,
+                           OneTo01Storage storage = OneTo01Storage::Full);
 
   template <typename Main, typename Aux, typename Metadata, typename Event>
-  auto makeOneTo01dataFrom(Event const& event, art::InputTag const& tag, std::size_t minSize = 0)
+  auto makeOneTo01dataFrom(Event const& event,
+                           art::InputTag const& tag,
+                           std::size_t minSize = 0,
+                           OneTo01Storage storage = OneTo01Storage::Full)
   {
-    return makeOneTo01dataFrom<Main, Aux, Metadata, Aux, Event>(event, tag, minSize);
+    return makeOneTo01dataFrom<Main, Aux, Metadata, Aux, Event>(event, tag, minSize, storage);
   }
 
   /**
@@ -180,7 +193,8 @@ namespace proxy {
   template <typename Main, typename Aux, typename Metadata, typename Tag, typename Event>
   auto makeOneTo01dataFrom(Event const& event,
                            art::InputTag const& tag,
-                           std::size_t minSize /* = 0 */
+                           std::size_t minSize /* = 0 */,
+                           OneTo01Storage storage /* = OneTo01Storage::Full */
   )
   {
     using Main_t = Main;
@@ -189,7 +203,8 @@ namespace proxy {
     using AssociatedData_t = details::OneTo01Data<Main_t, Aux_t, Metadata_t, Tag>;
     using Assns_t = typename AssociatedData_t::assns_t;
 
-    return makeOneTo01dataFrom<Tag>(*(event.template getValidHandle<Assns_t>(tag)), minSize);
+    return makeOneTo01dataFrom<Tag>(
+      *(event.template getValidHandle<Assns_t>(tag)), minSize, storage);
 
   } // makeOneTo01dataFrom(tag)
 
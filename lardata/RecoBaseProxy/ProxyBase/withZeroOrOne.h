@@ -17,7 +17,8 @@
 
 // C/C++ standard libraries
 #include <tuple>
-#include <utility> // std::forward(), std::move()
+#include <type_traits> // std::conditional_t, std::decay_t, std::is_same
+#include <utility>     // std::forward(), std::move()
 
 namespace proxy {
 
@@ -31,6 +32,12 @@ namespace proxy {
       OneTo01DataProxyMakerWrapper<Aux, Metadata, AuxTag>::template maker_t,
       AuxTag>;
 
+    /// Type keeping an argument of `withZeroOrOne()`: the storage by value.
+    template <typename Arg>
+    using OneTo01Arg_t = std::conditional_t<std::is_same<std::decay_t<Arg>, OneTo01Storage>::value,
+                                            OneTo01Storage,
+                                            Arg&&>;
+
   } // namespace details
 
   // --- BEGIN One-to-one (optional) associations ------------------------------
@@ -63,7 +70,7 @@ namespace proxy {
   template <typename Aux, typename Metadata, typename AuxTag, typename... Args>
   auto withZeroOrOneMetaAs(Args&&... args)
   {
-    using ArgTuple_t = std::tuple<Args&&...>;
+    using ArgTuple_t = std::tuple<details::OneTo01Arg_t<Args>...>;
     ArgTuple_t argsTuple(std::forward<Args>(args)...);
     return details::WithOneTo01AssociatedStruct<Aux, Metadata, ArgTuple_t, AuxTag>(
       std::move(argsTuple));
@@ -125,6 +132,22 @@ namespace proxy {
    * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
    *
    *
+   * Storage of the associated pointers
+   * ===================================
+   *
+   * By default one _art_ pointer is stored for each element of the main
+   * collection. A `proxy::OneTo01Storage` value as last argument selects a
+   * different storage (see `proxy::makeOneTo01data()`), e.g. for an
+   * association covering few of the main elements:
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+   * auto tracks = proxy::getCollection<proxy::Tracks>(event, trackTag,
+   *   withZeroOrOne<recob::Vertex>(vertexTag, proxy::OneTo01Storage::Compact)
+   *   );
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   * The storage can also follow the main collection tag alone:
+   * `withZeroOrOne<recob::Vertex>(proxy::OneTo01Storage::Automatic)`.
+   *
+   *
    * Customization of the association proxy
    * =======================================
    *
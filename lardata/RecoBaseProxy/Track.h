@@ -107,6 +107,11 @@
  *   associated hit and point flags. Track point proxies are obtained from a
  *   track proxy (`proxy::Track`).
  *
+ * In addition, `proxy::TrackPointColumns` copies the point information of all
+ * the tracks of a collection proxy into contiguous columns, for analyses
+ * looping over all the points of all the tracks (see
+ * @ref LArSoftProxyTracksColumns "below").
+ *
  * For the details of the interface and the information that is exposed by each
  * of these proxy classes, please refer to each class documentation. In
  * particular, see `proxy::Tracks` documentation for more usage examples.
@@ -223,6 +228,25 @@
  *
  * See the notes on @ref LArSoftProxyOverhead "overhead" in `ProxyBase.h`.
  *
+ * @anchor LArSoftProxyTracksColumns
+ * Each trajectory point proxy is built on demand from the track, its hits and
+ * its fit information. Loops on all the points of all the tracks may prefer
+ * to pay once for copying that information into a `proxy::TrackPointColumns`
+ * object, which stores each type of information of all the points in a
+ * single, contiguous vector:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * auto tracks = proxy::getCollection<proxy::Tracks>(event, tracksTag);
+ * proxy::TrackPointColumns const points = proxy::makeTrackPointColumns(tracks);
+ *
+ * for (std::size_t iTrack = 0; iTrack < points.nTracks(); ++iTrack) {
+ *   auto const& positions = points.positions(iTrack);
+ *   auto const& hits = points.hitPtrs(iTrack);
+ *   for (std::size_t iPoint = 0; iPoint < positions.size(); ++iPoint) {
+ *     // ...
+ *   }
+ * }
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
  *
  */
 
@@ -231,6 +255,7 @@
 
 // LArSoft libraries
 #include "lardata/RecoBaseProxy/ProxyBase.h" // proxy namespace
+#include "lardata/Utilities/CollectionView.h"
 #include "lardata/Utilities/filterRangeFor.h"
 #include "lardataobj/RecoBase/Hit.h"
 #include "lardataobj/RecoBase/Track.h"
@@ -240,6 +265,7 @@
 // framework libraries
 #include "canvas/Persistency/Common/Ptr.h"
 
+#include <cstddef> // std::size_t
 #include <limits>
 #include <tuple>
 #include <vector>
@@ -1299,6 +1325,135 @@ namespace proxy {
 
   }; // class TrackPointIterator
 
+  //----------------------------------------------------------------------------
+  //---  columnar track point information
+  //---
+  /**
+   * @brief Trajectory point information of all the tracks in a proxy.
+   * @see `proxy::makeTrackPointColumns()`, `proxy::TrackPointWrapper`
+   * @ingroup LArSoftProxyTracks
+   *
+   * This object holds the same information as the `proxy::TrackPoint` of
+   * all the points of all the tracks in a track collection proxy, but stored
+   * by column: all the positions of all the points in one vector, all the
+   * momenta in another, and so on. The points of each track are contiguous,
+   * with the tracks in the order of the proxy.
+   *
+   * Each column can be accessed as a whole (e.g. `positions()`), or as the
+   * subrange pertaining a single track (e.g. `positions(iTrack)`).
+   * The hits (`hitPtrs()`) are null where a point has no associated hit.
+   * The fit information (`fitInfoPtrs()`) is present only if it was merged into
+   * the track proxy (`hasFitInfo()`), and it is otherwise empty.
+   *
+   * The information is copied when the object is created; the hits and the fit
+   * information are still pointers to the original data products.
+   */
+  class TrackPointColumns {
+
+  public:
+    using Point_t = recob::Track::Point_t;              ///< Position type.
+    using Vector_t = recob::Track::Vector_t;            ///< Momentum type.
+    using PointFlags_t = recob::Track::PointFlags_t;    ///< Point flags type.
+    using HitPtr_t = art::Ptr<recob::Hit>;              ///< Hit pointer type.
+    using FitInfoPtr_t = recob::TrackFitHitInfo const*; ///< Fit info pointer type.
+
+    /// Type of the points of a single track in a column of `T`.
+    template <typename T>
+    using track_column_t = lar::RangeAsCollection_t<typename std::vector<T>::const_iterator>;
+
+    /// Copies the point information of all the tracks in the `tracks` proxy.
+    template <typename TrackCollProxy>
+    explicit TrackPointColumns(TrackCollProxy const& tracks);
+
+    /// Returns the number of tracks.
+    std::size_t nTracks() const { return fTrackOffsets.size() - 1; }
+
+    /// Returns the number of points of all the tracks.
+    std::size_t nPoints() const { return fPositions.size(); }
+
+    /// Returns the number of points of the track `iTrack`.
+    std::size_t nPoints(std::size_t iTrack) const { return trackEnd(iTrack) - trackBegin(iTrack); }
+
+    /// Returns the position in the columns of the first point of track `iTrack`.
+    std::size_t trackBegin(std::size_t iTrack) const { return fTrackOffsets[iTrack]; }
+
+    /// Returns the position in the columns after the last point of track `iTrack`.
+    std::size_t trackEnd(std::size_t iTrack) const { return fTrackOffsets[iTrack + 1]; }
+
+    /// Returns whether the fit information column is available.
+    bool hasFitInfo() const { return fHasFitInfo; }
+
+    /// @{
+    /// @name Columns of all the points
+
+    std::vector<Point_t> const& positions() const { return fPositions; }
+    std::vector<Vector_t> const& momenta() const { return fMomenta; }
+    std::vector<PointFlags_t> const& flags() const { return fFlags; }
+    std::vector<HitPtr_t> const& hitPtrs() const { return fHits; }
+    std::vector<FitInfoPtr_t> const& fitInfoPtrs() const { return fFitInfo; }
+
+    /// @}
+
+    /// @{
+    /// @name Columns of the points of the track `iTrack`
+
+    track_column_t<Point_t> positions(std::size_t iTrack) const
+    {
+      return trackColumn(fPositions, iTrack);
+    }
+    track_column_t<Vector_t> momenta(std::size_t iTrack) const
+    {
+      return trackColumn(fMomenta, iTrack);
+    }
+    track_column_t<PointFlags_t> flags(std::size_t iTrack) const
+    {
+      return trackColumn(fFlags, iTrack);
+    }
+    track_column_t<HitPtr_t> hitPtrs(std::size_t iTrack) const
+    {
+      return trackColumn(fHits, iTrack);
+    }
+    /// Fit information of the points of track `iTrack` (empty if `!hasFitInfo()`).
+    track_column_t<FitInfoPtr_t> fitInfoPtrs(std::size_t iTrack) const
+    {
+      if (!fHasFitInfo) return lar::makeCollectionView(fFitInfo.cend(), fFitInfo.cend());
+      return trackColumn(fFitInfo, iTrack);
+    }
+
+    /// @}
+
+  private:
+    std::vector<std::size_t> fTrackOffsets; ///< First point of each track, plus end.
+    std::vector<Point_t> fPositions;        ///< Positions of all the points.
+    std::vector<Vector_t> fMomenta;         ///< Momenta of all the points.
+    std::vector<PointFlags_t> fFlags;       ///< Flags of all the points.
+    std::vector<HitPtr_t> fHits;            ///< Hits of all the points.
+    std::vector<FitInfoPtr_t> fFitInfo;     ///< Fit information of all the points.
+    bool fHasFitInfo = false;               ///< Whether fit information is available.
+
+    /// Returns the subrange of `column` pertaining the track `iTrack`.
+    template <typename T>
+    track_column_t<T> trackColumn(std::vector<T> const& column, std::size_t iTrack) const
+    {
+      return lar::makeCollectionView(column.cbegin() + trackBegin(iTrack),
+                                     column.cbegin() + trackEnd(iTrack));
+    }
+
+  }; // class TrackPointColumns
+
+  /**
+   * @brief Returns the point information of all the tracks, by column.
+   * @tparam TrackCollProxy type of track collection proxy
+   * @param tracks the track collection proxy (from `proxy::Tracks`)
+   * @return a `proxy::TrackPointColumns` with information from `tracks`
+   * @ingroup LArSoftProxyTracks
+   */
+  template <typename TrackCollProxy>
+  TrackPointColumns makeTrackPointColumns(TrackCollProxy const& tracks)
+  {
+    return TrackPointColumns(tracks);
+  }
+
 } // namespace proxy
 
 namespace proxy {
@@ -1377,6 +1532,52 @@ namespace proxy {
   } // TrackCollectionProxyElement<>::pointsWithFlags()
 
   //----------------------------------------------------------------------------
+  template <typename TrackCollProxy>
+  TrackPointColumns::TrackPointColumns(TrackCollProxy const& tracks)
+    : fHasFitInfo(TrackCollProxy::template has<Tracks::TrackFitHitInfoTag>())
+  {
+    fTrackOffsets.reserve(tracks.size() + 1);
+    fTrackOffsets.push_back(0);
+    for (auto const& track : tracks)
+      fTrackOffsets.push_back(fTrackOffsets.back() + track.nPoints());
+
+    std::size_t const nAllPoints = fTrackOffsets.back();
+    fPositions.reserve(nAllPoints);
+    fMomenta.reserve(nAllPoints);
+    fFlags.reserve(nAllPoints);
+    fHits.reserve(nAllPoints);
+    if (fHasFitInfo) fFitInfo.reserve(nAllPoints);
+
+    for (auto const& track : tracks) {
+      recob::TrackTrajectory const& trajectory = track.track().Trajectory();
+      std::size_t const nPoints = track.nPoints();
+      for (std::size_t iPoint = 0; iPoint < nPoints; ++iPoint) {
+        fPositions.push_back(trajectory.LocationAtPoint(iPoint));
+        fMomenta.push_back(trajectory.MomentumVectorAtPoint(iPoint));
+        fFlags.push_back(trajectory.FlagsAtPoint(iPoint));
+      }
+
+      // there should be one hit per point, but we don't rely on that
+      std::size_t const trackEnd = fPositions.size();
+      for (HitPtr_t const& hit : track.hits()) {
+        if (fHits.size() == trackEnd) break;
+        fHits.push_back(hit);
+      }
+      fHits.resize(trackEnd);
+
+      if constexpr (TrackCollProxy::template has<Tracks::TrackFitHitInfoTag>()) {
+        auto const& fitInfo = track.template get<Tracks::TrackFitHitInfoTag>();
+        for (recob::TrackFitHitInfo const& info : fitInfo) {
+          if (fFitInfo.size() == trackEnd) break;
+          fFitInfo.push_back(&info);
+        }
+        fFitInfo.resize(trackEnd, nullptr);
+      }
+    } // for tracks
+
+  } // TrackPointColumns::TrackPointColumns()
+
+  //----------------------------------------------------------------------------
 
 } // namespace proxy
 
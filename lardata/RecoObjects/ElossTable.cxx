@@ -0,0 +1,205 @@
+///////////////////////////////////////////////////////////////////////
+///
+/// \file   ElossTable.cxx
+///
+/// \brief  Tabulated energy loss as a function of momentum.
+///
+////////////////////////////////////////////////////////////////////////
+
+#include "lardata/RecoObjects/ElossTable.h"
+#include "lardataalg/DetectorInfo/DetectorPropertiesData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+  /// Number of grid intervals.
+  constexpr int NIntervals = 6 * trkf::ElossTable::NPerDecade; // PMax/PMin = 10^6.
+
+  /// Grid step in log(p).
+  const double LogStep = std::log(10.) / trkf::ElossTable::NPerDecade;
+
+  /// Reference dE/dx for the medium signature: a muon with beta*gamma = 30,
+  /// where the density effect correction is in its transition region, so
+  /// that all the inputs of the energy loss affect it.
+  constexpr double RefMass = 0.105658367;
+  constexpr double RefMomentum = 30. * RefMass;
+
+} // anonymous namespace
+
+namespace trkf {
+
+  /// Constructor.
+  ///
+  /// Arguments:
+  ///
+  /// eloss - Mean energy loss (MeV/cm) as a function of momentum (GeV/c).
+  /// mass  - Particle mass (GeV/c^2).
+  ///
+  ElossTable::ElossTable(const std::function<double(double)>& eloss, double mass)
+    : fMass(mass)
+    , fEloss(NIntervals + 1)
+    , fElossSlope(NIntervals + 1)
+  {
+    // Tabulate dE/dx.
+
+    for (int i = 0; i <= NIntervals; ++i)
+      fEloss[i] = eloss(PMin * std::exp(i * LogStep));
+
+    // Fritsch-Carlson slopes: average of the neighbouring secants (zero
+    // at a local extremum), then limited so that each interval is monotone.
+
+    std::vector<double> secant(NIntervals);
+    for (int i = 0; i < NIntervals; ++i)
+      secant[i] = fEloss[i + 1] - fEloss[i];
+    fElossSlope[0] = secant[0];
+    fElossSlope[NIntervals] = secant[NIntervals - 1];
+    for (int i = 1; i < NIntervals; ++i)
+      fElossSlope[i] = (secant[i - 1] * secant[i] > 0. ? 0.5 * (secant[i - 1] + secant[i]) : 0.);
+    for (int i = 0; i < NIntervals; ++i) {
+      if (secant[i] == 0.) {
+        fElossSlope[i] = 0.;
+        fElossSlope[i + 1] = 0.;
+        continue;
+      }
+      double a = fElossSlope[i] / secant[i];
+      double b = fElossSlope[i + 1] / secant[i];
+      double r2 = a * a + b * b;
+      if (r2 > 9.) {
+        double tau = 3. / std::sqrt(r2);
+        fElossSlope[i] = tau * a * secant[i];
+        fElossSlope[i + 1] = tau * b * secant[i];
+      }
+    }
+
+    // Power laws for extrapolation.
+
+    fLowPower = std::log(fEloss[1] / fEloss[0]) / LogStep;
+    fHighPower = std::log(fEloss[NIntervals] / fEloss[NIntervals - 1]) / LogStep;
+  }
+
+  /// Medium of DetectorPropertiesData::Eloss.
+  ElossTable::Medium::Medium(const detinfo::DetectorPropertiesData& detProp)
+    : Medium(detProp.Density(), [&detProp](double p, double mass, double tcut) {
+      return detProp.Eloss(p, mass, tcut);
+    })
+  {}
+
+  /// Medium of the given density and energy loss function.
+  ///
+  /// Arguments:
+  ///
+  /// density - Density (g/cm^3).
+  /// eloss   - Mean energy loss (MeV/cm) as a function of momentum (GeV/c),
+  ///           mass (GeV/c^2) and tcut (MeV).
+  ///
+  ElossTable::Medium::Medium(double density, ElossFunction eloss)
+    : fEloss(std::move(eloss)), fSignature{density, fEloss(RefMomentum, RefMass, 0.)}
+  {}
+
+  /// Shared table of the medium energy loss for given mass and tcut.
+  ///
+  /// Arguments:
+  ///
+  /// medium - Medium.
+  /// mass   - Particle mass (GeV/c^2).
+  /// tcut   - Maximum delta ray energy (MeV, see DetectorPropertiesData::Eloss).
+  ///
+  /// The table is made the first time it is requested.  When a table of
+  /// a new medium is made, the tables of other media are dropped; each
+  /// thread keeps the tables it uses until it requests one of a
+  /// different medium, so the returned reference is valid until then.
+  /// This method is thread safe.
+  ///
+  const ElossTable& ElossTable::Get(const Medium& medium, double mass, double tcut)
+  {
+    struct Entry {
+      std::array<double, 2> signature;
+      double mass;
+      double tcut;
+      ElossTable table;
+
+      bool matches(const std::array<double, 2>& s, double m, double t) const
+      {
+        return signature == s && mass == m && tcut == t;
+      }
+    };
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    const std::array<double, 2>& signature = medium.fSignature;
+
+    // Tables already used by this thread.
+
+    thread_local std::vector<EntryPtr> used;
+    for (const EntryPtr& entry : used) {
+      if (entry->matches(signature, mass, tcut)) return entry->table;
+    }
+
+    // Look up, or make, the table.
+
+    EntryPtr entry;
+    {
+      static std::mutex mutex;
+      static std::vector<EntryPtr> entries;
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = std::find_if(entries.begin(), entries.end(), [&](const EntryPtr& e) {
+        return e->matches(signature, mass, tcut);
+      });
+      if (it != entries.end())
+        entry = *it;
+      else {
+        auto eloss = [&medium, mass, tcut](double p) { return medium.Eloss(p, mass, tcut); };
+        entry = std::make_shared<const Entry>(Entry{signature, mass, tcut, {eloss, mass}});
+        entries.erase(std::remove_if(entries.begin(),
+                                     entries.end(),
+                                     [&](const EntryPtr& e) { return e->signature != signature; }),
+                      entries.end());
+        entries.push_back(entry);
+      }
+    }
+
+    // Tables of other media are not used by this thread any more.
+
+    used.erase(
+      std::remove_if(
+        used.begin(), used.end(), [&](const EntryPtr& e) { return e->signature != signature; }),
+      used.end());
+    used.push_back(entry);
+    return entry->table;
+  }
+
+  /// Mean energy loss (MeV/cm) at momentum p (GeV/c).
+  double ElossTable::Eloss(double p) const
+  {
+    double x = gridCoordinate(p);
+    if (x < 0.) return fEloss.front() * std::pow(p / PMin, fLowPower);
+    if (x > NIntervals) return fEloss.back() * std::pow(p / PMax, fHighPower);
+    return interpolate(fEloss, fElossSlope, x);
+  }
+
+  /// Grid coordinate of momentum p.
+  double ElossTable::gridCoordinate(double p) { return std::log(p / PMin) / LogStep; }
+
+  /// Cubic Hermite interpolation.
+  ///
+  /// Arguments:
+  ///
+  /// y  - Values at grid points.
+  /// dy - Derivatives at grid points (with respect to the grid coordinate).
+  /// x  - Grid coordinate.
+  ///
+  double ElossTable::interpolate(const std::vector<double>& y,
+                                 const std::vector<double>& dy,
+                                 double x)
+  {
+    int i = std::min(static_cast<int>(x), NIntervals - 1);
+    double t = x - i;
+    double u = 1. - t;
+    return (y[i] * (1. + 2. * t) + dy[i] * t) * u * u +
+           (y[i + 1] * (3. - 2. * t) - dy[i + 1] * u) * t * t;
+  }
+} // end namespace trkf
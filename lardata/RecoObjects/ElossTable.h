@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////
+///
+/// \file   ElossTable.h
+///
+/// \brief  Tabulated energy loss as a function of momentum.
+///
+/// Class ElossTable holds the mean energy loss per unit length (dE/dx)
+/// of a particle of given mass on a grid of momentum values uniform in
+/// log(p).  Values between grid points are obtained by monotone
+/// piecewise cubic (Fritsch-Carlson) interpolation in log(p), which
+/// reproduces the grid values exactly and never overshoots them.
+/// Outside the grid, dE/dx is extrapolated as a power of the momentum.
+///
+/// Method Get returns the table of dE/dx as calculated by
+/// DetectorPropertiesData::Eloss for given mass and maximum delta ray
+/// energy (tcut).  Tables are calculated the first time they are
+/// requested, and then shared.  Besides mass and tcut, they are
+/// identified by the medium (class ElossTable::Medium): Eloss depends
+/// on the argon density, Z/A, mean excitation energy and density effect
+/// (Sternheimer) parameters, and only the density is available from
+/// DetectorPropertiesData, so the others are identified through a
+/// reference dE/dx which depends on all of them.  When a table of a new
+/// medium is made, the tables of the other media are dropped.
+///
+/// Propagator and TrackStatePropagator use these tables for dE/dx,
+/// unless exact mode is requested, in which case they call Eloss
+/// directly.  They identify the medium once per set of detector
+/// properties (Propagator) or per propagation (TrackStatePropagator).
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef ELOSSTABLE_H
+#define ELOSSTABLE_H
+
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace detinfo {
+  class DetectorPropertiesData;
+}
+
+namespace trkf {
+
+  class ElossTable {
+  public:
+    /// Momentum range of the grid (GeV/c).
+    static constexpr double PMin = 1.e-3;
+    static constexpr double PMax = 1.e3;
+
+    /// Number of grid intervals per decade of momentum.
+    static constexpr int NPerDecade = 32;
+
+    /// Mean energy loss function (MeV/cm vs. momentum in GeV/c, mass in GeV/c^2, tcut in MeV).
+    using ElossFunction = std::function<double(double, double, double)>;
+
+    /// Medium of the energy loss, identified by density and a reference dE/dx.
+    class Medium {
+    public:
+      /// Medium of DetectorPropertiesData::Eloss (detProp must outlive this object).
+      explicit Medium(const detinfo::DetectorPropertiesData& detProp);
+
+      /// Medium of the given density and energy loss function.
+      Medium(double density, ElossFunction eloss);
+
+      /// Mean energy loss (MeV/cm).
+      double Eloss(double p, double mass, double tcut) const { return fEloss(p, mass, tcut); }
+
+      /// Whether the two media have the same density and reference dE/dx.
+      bool operator==(const Medium& other) const { return fSignature == other.fSignature; }
+      bool operator!=(const Medium& other) const { return fSignature != other.fSignature; }
+
+    private:
+      friend class ElossTable;
+
+      ElossFunction fEloss;             ///< Mean energy loss.
+      std::array<double, 2> fSignature; ///< Density and reference dE/dx.
+    };
+
+    /// Constructor from a dE/dx function (MeV/cm vs. momentum in GeV/c).
+    ElossTable(const std::function<double(double)>& eloss, double mass);
+
+    /// Shared table of the medium energy loss for given mass and tcut.
+    static const ElossTable& Get(const Medium& medium, double mass, double tcut);
+
+    /// Shared table of DetectorPropertiesData::Eloss for given mass and tcut
+    /// (the medium is identified at each call).
+    static const ElossTable& Get(const detinfo::DetectorPropertiesData& detProp,
+                                 double mass,
+                                 double tcut)
+    {
+      return Get(Medium(detProp), mass, tcut);
+    }
+
+    // Accessors.
+
+    double Mass() const { return fMass; } ///< Particle mass (GeV/c^2).
+
+    /// Mean energy loss (MeV/cm) at momentum p (GeV/c).
+    double Eloss(double p) const;
+
+  private:
+    /// Grid coordinate of momentum p (grid point i at i).
+    static double gridCoordinate(double p);
+
+    /// Cubic Hermite interpolation at grid coordinate x (0 <= x <= number of intervals).
+    static double interpolate(const std::vector<double>& y,
+                              const std::vector<double>& dy,
+                              double x);
+
+    // Attributes.
+
+    double fMass;                    ///< Particle mass.
+    std::vector<double> fEloss;      ///< dE/dx at grid points.
+    std::vector<double> fElossSlope; ///< d(dE/dx)/dx at grid points (x = grid coordinate).
+    double fLowPower;                ///< Power of p for dE/dx below the grid.
+    double fHighPower;               ///< Power of p for dE/dx above the grid.
+  };
+}
+
+#endif
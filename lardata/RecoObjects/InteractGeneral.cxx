@@ -9,6 +9,7 @@
 ////////////////////////////////////////////////////////////////////////
 
 #include "lardata/RecoObjects/InteractGeneral.h"
+#include "lardata/RecoObjects/KalmanFixedLinearAlgebra.h"
 #include "lardata/RecoObjects/SurfXYZPlane.h"
 #include <cmath>
 
@@ -77,9 +78,12 @@ namespace trkf {
     // Transform noise matrix to original surface using inverse of propagation matrix.
 
     invert(prop_matrix);
-    TrackMatrix temp = prod(plane_noise, trans(prop_matrix));
-    TrackMatrix temp2 = prod(prop_matrix, temp);
-    noise_matrix = ublas::symmetric_adaptor<TrackMatrix>(temp2);
+    noise_matrix = plane_noise;
+    if (!UseFixedKalmanAlgebra || !fixed::trySimilarity(prop_matrix, noise_matrix)) {
+      TrackMatrix temp = prod(plane_noise, trans(prop_matrix));
+      TrackMatrix temp2 = prod(prop_matrix, temp);
+      noise_matrix = ublas::symmetric_adaptor<TrackMatrix>(temp2);
+    }
 
     // Done (success).
 
@@ -10,6 +10,7 @@
 
 #include "lardata/RecoObjects/KETrack.h"
 #include "cetlib_except/exception.h"
+#include "lardata/RecoObjects/KalmanFixedLinearAlgebra.h"
 #include <cmath>
 
 namespace trkf {
@@ -138,7 +139,7 @@ namespace trkf {
     // Invert the difference error matrix.
     // This is the only place where a detectable failure can occur.
 
-    bool ok = syminvert(derr);
+    bool ok = UseFixedKalmanAlgebra ? fixed::syminvert<5>(derr) : syminvert(derr);
     if (ok) {
 
       // Calculate updated state vector.
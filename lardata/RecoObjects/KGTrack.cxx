@@ -8,8 +8,10 @@
 ///
 ////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
+#include <numeric>
 
 #include "lardata/RecoObjects/KGTrack.h"
 #include "lardata/RecoObjects/KHitWireLine.h"
@@ -26,6 +28,100 @@ namespace trkf {
 
   KGTrack::KGTrack(int prefplane) : fPrefPlane(prefplane) {}
 
+  /// Copy constructor.  The multimap copy is rebuilt on demand.
+  KGTrack::KGTrack(const KGTrack& other)
+    : fPrefPlane(other.fPrefPlane), fPath(other.fPath), fTracks(other.fTracks)
+  {}
+
+  /// Move constructor.
+  KGTrack::KGTrack(KGTrack&& other) noexcept
+    : fPrefPlane(other.fPrefPlane)
+    , fPath(std::move(other.fPath))
+    , fTracks(std::move(other.fTracks))
+  {}
+
+  /// Copy assignment.
+  KGTrack& KGTrack::operator=(const KGTrack& other)
+  {
+    if (this == &other) return *this;
+    fPrefPlane = other.fPrefPlane;
+    fPath = other.fPath;
+    fTracks = other.fTracks;
+    fMapValid = false;
+    fTrackMap.clear();
+    return *this;
+  }
+
+  /// Move assignment.
+  KGTrack& KGTrack::operator=(KGTrack&& other) noexcept
+  {
+    if (this == &other) return *this;
+    fPrefPlane = other.fPrefPlane;
+    fPath = std::move(other.fPath);
+    fTracks = std::move(other.fTracks);
+    fMapValid = false;
+    fTrackMap.clear();
+    return *this;
+  }
+
+  /// KHitTrack collection as a multimap, indexed by path distance.
+  ///
+  /// The multimap is built on first use after each change.
+  ///
+  const std::multimap<double, KHitTrack>& KGTrack::getTrackMap() const
+  {
+    std::lock_guard<std::mutex> lock(fMapMutex);
+    if (!fMapValid) fillMap();
+    return fTrackMap;
+  }
+
+  /// Modifiable copy of the KHitTrack collection as a multimap.
+  ///
+  /// The copy replaces the collection when it is released.
+  ///
+  KGTrack::ModifiableTrackMap KGTrack::modifiableTrackMap()
+  {
+    return ModifiableTrackMap(*this);
+  }
+
+  KGTrack::ModifiableTrackMap::ModifiableTrackMap(KGTrack& track)
+    : fTrack(&track), fMap(track.getTrackMap())
+  {}
+
+  KGTrack::ModifiableTrackMap::ModifiableTrackMap(ModifiableTrackMap&& other) noexcept
+    : fTrack(other.fTrack), fMap(std::move(other.fMap))
+  {
+    other.fTrack = nullptr;
+  }
+
+  KGTrack::ModifiableTrackMap::~ModifiableTrackMap()
+  {
+    release();
+  }
+
+  void KGTrack::ModifiableTrackMap::release()
+  {
+    if (!fTrack) return;
+    fTrack->assignTrackMap(fMap);
+    fTrack = nullptr;
+  }
+
+  /// Replace the collection with the content of a multimap.
+  void KGTrack::assignTrackMap(const std::multimap<double, KHitTrack>& trackmap)
+  {
+    std::vector<double> path;
+    std::vector<KHitTrack> tracks;
+    path.reserve(trackmap.size());
+    tracks.reserve(trackmap.size());
+    for (auto const& ele : trackmap) {
+      path.push_back(ele.first);
+      tracks.push_back(ele.second);
+    }
+    fPath.swap(path);
+    fTracks.swap(tracks);
+    fMapValid = false;
+  }
+
   /// Track at start point.
   const KHitTrack& KGTrack::startTrack() const
   {
@@ -33,7 +129,7 @@ namespace trkf {
 
     // Return track.
 
-    return (*fTrackMap.begin()).second;
+    return fTracks.front();
   }
 
   /// Track at end point.
@@ -45,7 +141,7 @@ namespace trkf {
 
     // Return track.
 
-    return (*fTrackMap.rbegin()).second;
+    return fTracks.back();
   }
 
   /// Modifiable track at start point.
@@ -57,7 +153,8 @@ namespace trkf {
 
     // Return track.
 
-    return (*fTrackMap.begin()).second;
+    fMapValid = false;
+    return fTracks.front();
   }
 
   /// Modifiable track at end point.
@@ -69,45 +166,89 @@ namespace trkf {
 
     // Return track.
 
-    return (*fTrackMap.rbegin()).second;
+    fMapValid = false;
+    return fTracks.back();
+  }
+
+  /// Reserve space for n measurements.
+  void KGTrack::reserve(size_t n)
+  {
+    fPath.reserve(n);
+    fTracks.reserve(n);
   }
 
   /// Add track.
+  ///
+  /// The track is inserted after any tracks with the same path
+  /// distance (as std::multimap::insert).  Adding tracks in order of
+  /// increasing path distance is constant time.
+  ///
   void KGTrack::addTrack(const KHitTrack& trh)
   {
     if (!trh.isValid()) throw cet::exception("KGTrack") << "Adding invalid track to KGTrack.\n";
-    fTrackMap.insert(std::make_pair(trh.getPath() + trh.getHit()->getPredDistance(), trh));
+    double s = trh.getPath() + trh.getHit()->getPredDistance();
+    auto pos = std::upper_bound(fPath.begin(), fPath.end(), s);
+    fTracks.insert(fTracks.begin() + (pos - fPath.begin()), trh);
+    fPath.insert(pos, s);
+    fMapValid = false;
   }
 
   /// Recalibrate track map.
   ///
-  /// Loop over contents of track map.  Copy each KHitTrack into a new multimap track map.
   /// Offset the distance stored in the KHitTracks such that the minimum distance is zero.
-  /// Also update multimap keys to agree with distance stored in track.
+  /// Also update path distance keys to agree with distance stored in track (and resort
+  /// if necessary, keeping the previous order of equal keys).
   ///
   void KGTrack::recalibrate()
   {
-    std::multimap<double, KHitTrack> newmap;
+    fMapValid = false;
+    if (fTracks.empty()) return;
 
-    // Loop over old track map.
+    // Loop over tracks.
 
-    bool first = true;
-    double s0 = 0.;
-    for (std::multimap<double, KHitTrack>::iterator i = fTrackMap.begin(); i != fTrackMap.end();
-         ++i) {
-      KHitTrack& trh = (*i).second;
-      if (first) {
-        first = false;
-        s0 = trh.getPath();
-      }
+    double s0 = fTracks.front().getPath();
+    for (size_t i = 0; i < fTracks.size(); ++i) {
+      KHitTrack& trh = fTracks[i];
       double s = trh.getPath() - s0;
       trh.setPath(s);
-      newmap.insert(std::make_pair(s, trh));
+      fPath[i] = s;
+    }
+    if (std::is_sorted(fPath.begin(), fPath.end())) return;
+
+    // Resort.
+
+    std::vector<size_t> index(fPath.size());
+    std::iota(index.begin(), index.end(), 0);
+    std::stable_sort(
+      index.begin(), index.end(), [this](size_t i, size_t j) { return fPath[i] < fPath[j]; });
+    std::vector<double> path;
+    std::vector<KHitTrack> tracks;
+    path.reserve(index.size());
+    tracks.reserve(index.size());
+    for (size_t i : index) {
+      path.push_back(fPath[i]);
+      tracks.push_back(fTracks[i]);
     }
+    fPath.swap(path);
+    fTracks.swap(tracks);
+  }
 
-    // Update data member track map.
+  /// Clear track collection.
+  void KGTrack::clear()
+  {
+    fPath.clear();
+    fTracks.clear();
+    fTrackMap.clear();
+    fMapValid = false;
+  }
 
-    fTrackMap.swap(newmap);
+  /// Fill the multimap from the flat storage.
+  void KGTrack::fillMap() const
+  {
+    fTrackMap.clear();
+    for (size_t i = 0; i < fTracks.size(); ++i)
+      fTrackMap.emplace_hint(fTrackMap.end(), fPath[i], fTracks[i]);
+    fMapValid = true;
   }
 
   /// Fill a recob::Track.
@@ -132,19 +273,16 @@ namespace trkf {
     std::vector<recob::tracking::SMatrixSym55> cov;
     std::vector<recob::TrajectoryPointFlags> outFlags;
 
-    xyz.reserve(fTrackMap.size());
-    pxpypz.reserve(fTrackMap.size());
-    outFlags.reserve(fTrackMap.size());
+    xyz.reserve(numHits());
+    pxpypz.reserve(numHits());
+    outFlags.reserve(numHits());
 
     // Loop over KHitTracks.
 
     int ndof = 0;
     float totChi2 = 0.;
     unsigned int n = 0;
-    for (std::multimap<double, KHitTrack>::const_iterator itr = fTrackMap.begin();
-         itr != fTrackMap.end();
-         ++itr, ++n) {
-      const KHitTrack& trh = (*itr).second;
+    for (const KHitTrack& trh : fTracks) {
 
       // Get position.
 
@@ -188,6 +326,7 @@ namespace trkf {
         cov.push_back(covar);
       else
         cov.back() = covar;
+      ++n;
     }
 
     // Fill track.
@@ -216,15 +355,12 @@ namespace trkf {
   void KGTrack::fillHits(art::PtrVector<recob::Hit>& hits,
                          std::vector<unsigned int>& hittpindex) const
   {
-    hits.reserve(hits.size() + fTrackMap.size());
+    hits.reserve(hits.size() + numHits());
 
     // Loop over KHitTracks and fill hits belonging to this track.
 
     unsigned int counter = 0; //Index of corresponding trajectory point
-    for (std::multimap<double, KHitTrack>::const_iterator it = fTrackMap.begin();
-         it != fTrackMap.end();
-         ++it) {
-      const KHitTrack& track = (*it).second;
+    for (const KHitTrack& track : fTracks) {
       ++counter;
       // Extrack Hit from track.
       const std::shared_ptr<const KHitBase>& hit = track.getHit();
@@ -256,9 +392,9 @@ namespace trkf {
     double oldxyz[3] = {0., 0., 0.};
     double len = 0.;
     bool first = true;
-    for (auto const& ele : fTrackMap) {
-      double s = ele.first;
-      const KHitTrack& trh = ele.second;
+    for (size_t i = 0; i < fTracks.size(); ++i) {
+      double s = fPath[i];
+      const KHitTrack& trh = fTracks[i];
       double xyz[3];
       double mom[3];
       trh.getPosition(xyz);
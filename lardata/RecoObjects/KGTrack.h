@@ -11,9 +11,18 @@
 /// measurement surface.  This is the maximum amount of information
 /// that it is possible to have.
 ///
-/// KHitTrack collection is stored as a map, indexed by path distance.
-/// This organization makes it easy to find the one or two nearest
-/// KHitTrack objects to any path distance.
+/// KHitTrack collection is stored as a flat multimap, indexed by path
+/// distance: a sorted vector of path distances, and a parallel vector
+/// of KHitTrack objects (equal path distances are kept in order of
+/// insertion).  This organization makes it easy to find the one or two
+/// nearest KHitTrack objects to any path distance, and makes loops
+/// over the collection (e.g. fillTrack) linear in memory.
+///
+/// For existing code, the collection is also available as a constant
+/// std::multimap (getTrackMap), built on demand (safely, also from
+/// concurrent const calls).  To modify the collection as a multimap,
+/// modifiableTrackMap hands out a copy, which replaces the collection
+/// when it is released; until then, the track is left unchanged.
 ///
 /// Note that by combining information from forward and backward fit
 /// tracks (Kalman smoothing), it is possible to obtain optimal fit
@@ -25,8 +34,10 @@
 #ifndef KGTRACK_H
 #define KGTRACK_H
 
+#include <cstddef>
 #include <iosfwd>
 #include <map>
+#include <mutex>
 #include <vector>
 
 #include "canvas/Persistency/Common/PtrVector.h"
@@ -48,13 +59,24 @@ namespace trkf {
   public:
     KGTrack(int prefplane);
 
+    KGTrack(const KGTrack& other);
+    KGTrack(KGTrack&& other) noexcept;
+    KGTrack& operator=(const KGTrack& other);
+    KGTrack& operator=(KGTrack&& other) noexcept;
+
     int getPrefPlane() const { return fPrefPlane; }
 
-    /// KHitTrack collection, indexed by path distance.
-    const std::multimap<double, KHitTrack>& getTrackMap() const { return fTrackMap; }
+    /// Path distances, in increasing order.
+    const std::vector<double>& getPaths() const { return fPath; }
+
+    /// KHitTrack collection, in order of path distance.
+    const std::vector<KHitTrack>& getTracks() const { return fTracks; }
+
+    /// KHitTrack collection as a multimap, indexed by path distance.
+    const std::multimap<double, KHitTrack>& getTrackMap() const;
 
     /// Number of measurements in track.
-    size_t numHits() const { return fTrackMap.size(); }
+    size_t numHits() const { return fTracks.size(); }
 
     /// Track at start point.
     const KHitTrack& startTrack() const;
@@ -63,12 +85,38 @@ namespace trkf {
     const KHitTrack& endTrack() const;
 
     /// Validity flag.
-    bool isValid() const { return fTrackMap.size() > 0; }
+    bool isValid() const { return numHits() > 0; }
 
     // Modifiers.
 
-    /// Modifiable KHitTrack collection, indexed by path distance.
-    std::multimap<double, KHitTrack>& getTrackMap() { return fTrackMap; }
+    /// Copy of the KHitTrack collection as a multimap, replacing the
+    /// collection of its track when released.
+    class ModifiableTrackMap {
+    public:
+      ModifiableTrackMap(ModifiableTrackMap&& other) noexcept;
+      ModifiableTrackMap& operator=(ModifiableTrackMap&&) = delete;
+
+      /// Releases the multimap (see release).
+      ~ModifiableTrackMap();
+
+      std::multimap<double, KHitTrack>& operator*() { return fMap; }
+      std::multimap<double, KHitTrack>* operator->() { return &fMap; }
+
+      /// Replaces the collection of the track with the content of the
+      /// multimap.  Later changes to the multimap are not applied.
+      void release();
+
+    private:
+      friend class KGTrack;
+
+      explicit ModifiableTrackMap(KGTrack& track);
+
+      KGTrack* fTrack;                       ///< Track to update (null once released).
+      std::multimap<double, KHitTrack> fMap; ///< The modifiable copy.
+    };
+
+    /// Modifiable copy of the KHitTrack collection as a multimap (see above).
+    ModifiableTrackMap modifiableTrackMap();
 
     /// Modifiable track at start point.
     KHitTrack& startTrack();
@@ -76,6 +124,9 @@ namespace trkf {
     /// Modifiable track at end point.
     KHitTrack& endTrack();
 
+    /// Reserve space for n measurements.
+    void reserve(size_t n);
+
     /// Add track.
     void addTrack(const KHitTrack& trh);
 
@@ -83,7 +134,7 @@ namespace trkf {
     void recalibrate();
 
     /// Clear track collection.
-    void clear() { fTrackMap.clear(); }
+    void clear();
 
     // Methods.
 
@@ -95,17 +146,32 @@ namespace trkf {
     /// Fill a PtrVector of Hits.
     void fillHits(art::PtrVector<recob::Hit>& hits, std::vector<unsigned int>& hittpindex) const;
 
-    const std::multimap<double, KHitTrack> TrackMap() const { return fTrackMap; }
+    const std::multimap<double, KHitTrack> TrackMap() const { return getTrackMap(); }
 
     /// Printout
     std::ostream& Print(std::ostream& out) const;
 
   private:
+    /// Replace the collection with the content of a multimap.
+    void assignTrackMap(const std::multimap<double, KHitTrack>& trackmap);
+
+    /// Fill the multimap from the flat storage.
+    void fillMap() const;
+
     /// Preferred plane.
     int fPrefPlane;
 
-    /// KHitTrack collection, indexed by path distance.
-    std::multimap<double, KHitTrack> fTrackMap;
+    // Flat KHitTrack collection, indexed by path distance.
+
+    std::vector<double> fPath;      ///< Path distances (sorted).
+    std::vector<KHitTrack> fTracks; ///< KHitTracks (parallel to fPath).
+
+    // Multimap: a copy of the flat storage built on demand by
+    // getTrackMap (under fMapMutex).
+
+    mutable std::multimap<double, KHitTrack> fTrackMap; ///< Multimap.
+    mutable bool fMapValid = false;                     ///< Copy is up to date.
+    mutable std::mutex fMapMutex;                       ///< Protects the copy.
   };
 
   /// Output operator.
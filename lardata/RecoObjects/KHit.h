@@ -66,6 +66,7 @@
 
 #include "cetlib_except/exception.h"
 #include "lardata/RecoObjects/KHitBase.h"
+#include "lardata/RecoObjects/KalmanFixedLinearAlgebra.h"
 #include "lardata/RecoObjects/Propagator.h"
 
 namespace trkf {
@@ -281,7 +282,7 @@ namespace trkf {
       fRvec = fMvec - fPvec;
       fRerr = fMerr + fPerr;
       fRinv = fRerr;
-      ok = syminvert(fRinv);
+      ok = UseFixedKalmanAlgebra ? fixed::syminvert<N>(fRinv) : syminvert(fRinv);
       if (ok) {
 
         // Calculate incremental chisquare.
@@ -319,6 +320,18 @@ namespace trkf {
     if (!getPredSurface()->isEqual(*tre.getSurface()))
       throw cet::exception("KHit") << "Track surface not the same as prediction surface.\n";
 
+    // Fixed-size update, if the sizes are the standard ones.
+
+    if (UseFixedKalmanAlgebra) {
+      TrackVector newvec = tre.getVector();
+      TrackError newerr = tre.getError();
+      if (fixed::tryUpdate<N>(newvec, newerr, fH, fMerr, fRinv, fRvec)) {
+        tre.setVector(newvec);
+        tre.setError(newerr);
+        return;
+      }
+    }
+
     const TrackVector& tvec = tre.getVector();
     const TrackError& terr = tre.getError();
     TrackVector::size_type size = tvec.size();
@@ -12,6 +12,19 @@
 
 #include "cetlib_except/exception.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+namespace {
+
+  /// Minimum number of KHitGroups for parallel sorting.
+  constexpr std::size_t ParallelSortMin = 64;
+
+  /// Number of KHitGroups per parallel task.
+  constexpr std::size_t ParallelSortGrain = 16;
+
+} // anonymous namespace
+
 namespace trkf {
 
   void fill(const art::PtrVector<recob::Hit>& hits, int only_plane) {}
@@ -49,40 +62,42 @@ namespace trkf {
 
     if (addUnsorted) fSorted.splice(fSorted.end(), fUnsorted);
 
-    // Loop over objects in sorted list.
-
-    for (std::list<KHitGroup>::iterator igr = fSorted.begin(); igr != fSorted.end();) {
-
-      KHitGroup& gr = *igr;
-
-      // Get destination surface.
-
-      const std::shared_ptr<const Surface>& psurf = gr.getSurface();
-
-      // Make a fresh copy of the track and propagate it to
-      // the destination surface.
+    // Update the path distance of each object in the sorted list by
+    // propagating a fresh copy of the track to its surface.  If
+    // propagation fails, reset the path flag.
 
+    auto updatePath = [&trk, &prop, dir](KHitGroup& gr) {
       KTrack trkp = trk;
-      std::optional<double> dist = prop.vec_prop(trkp, psurf, dir, false, 0, 0);
-      if (!dist) {
-
-        // If propagation failed, reset the path flag for this surface
-        // and move the KHitGroup to the unsorted list.  Be careful to
-        // keep the list iterator valid.
-
+      std::optional<double> dist = prop.vec_prop(trkp, gr.getSurface(), dir, false, 0, 0);
+      if (!dist)
         gr.setPath(false, 0.);
-        std::list<KHitGroup>::iterator it = igr;
-        ++igr;
-        fUnsorted.splice(fUnsorted.end(), fSorted, it);
-      }
-      else {
+      else
+        gr.setPath(true, *dist);
+    };
+
+    if (fParallelSort && fSorted.size() >= ParallelSortMin) {
+      std::vector<KHitGroup*> groups;
+      groups.reserve(fSorted.size());
+      for (KHitGroup& gr : fSorted)
+        groups.push_back(&gr);
+      tbb::parallel_for(tbb::blocked_range<std::size_t>(0, groups.size(), ParallelSortGrain),
+                        [&](const tbb::blocked_range<std::size_t>& range) {
+                          for (std::size_t i = range.begin(); i != range.end(); ++i)
+                            updatePath(*groups[i]);
+                        });
+    }
+    else {
+      for (KHitGroup& gr : fSorted)
+        updatePath(gr);
+    }
 
-        // Otherwise (if propagation succeeded), set the path distance
-        // and advance the iterator to the next KHitGroup.
+    // Move the KHitGroups for which propagation failed to the unsorted
+    // list, in order.  Be careful to keep the list iterator valid.
 
-        gr.setPath(true, *dist);
-        ++igr;
-      }
+    for (std::list<KHitGroup>::iterator igr = fSorted.begin(); igr != fSorted.end();) {
+      std::list<KHitGroup>::iterator it = igr;
+      ++igr;
+      if (!it->getHasPath()) fUnsorted.splice(fUnsorted.end(), fSorted, it);
     }
 
     // Finally, sort the sorted list in order of path distance.
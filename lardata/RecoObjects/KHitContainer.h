@@ -22,6 +22,13 @@
 /// length updated, are moved to the sorted list, and are eventually
 /// sorted.  Unreachable objects are moved to the unsorted list.
 ///
+/// If parallel sorting is enabled (setParallelSort), the propagations
+/// to the different objects are done concurrently (using TBB).  The
+/// resulting lists are the same as for serial sorting.  Parallel
+/// sorting requires that method vec_prop of the propagator (without
+/// dE/dx) be safe to call concurrently, which is true for the
+/// propagators in this package.
+///
 /// Here are the envisioned use cases of this class.
 ///
 /// 1.  At the beginning of the event, a set of candidate measurements
@@ -76,6 +83,12 @@ namespace trkf {
     std::list<KHitGroup>& getUnsorted() { return fUnsorted; } ///< Unsorted list.
     std::list<KHitGroup>& getUnused() { return fUnused; }     ///< Unused list.
 
+    /// Parallel sorting flag.
+    bool getParallelSort() const { return fParallelSort; }
+
+    /// Enable or disable parallel sorting.
+    void setParallelSort(bool parallel) { fParallelSort = parallel; }
+
     /// Clear all lists.
     void clear();
 
@@ -97,6 +110,7 @@ namespace trkf {
     std::list<KHitGroup> fSorted;   ///< Sorted KHitGroup objects.
     std::list<KHitGroup> fUnsorted; ///< Unsorted KHitGroup objects.
     std::list<KHitGroup> fUnused;   ///< Unused KHitGroup objects.
+    bool fParallelSort = false;     ///< Propagate concurrently in sort.
   };
 }
 
@@ -0,0 +1,185 @@
+///////////////////////////////////////////////////////////////////////
+///
+/// \file   KHitContainerArena.cxx
+///
+/// \brief  A collection of KHitGroups in contiguous storage.
+///
+////////////////////////////////////////////////////////////////////////
+
+#include "lardata/RecoObjects/KHitContainerArena.h"
+
+#include "cetlib_except/exception.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <algorithm>
+
+namespace {
+
+  /// Minimum number of KHitGroups for parallel sorting.
+  constexpr std::size_t ParallelSortMin = 64;
+
+  /// Number of KHitGroups per parallel task.
+  constexpr std::size_t ParallelSortGrain = 16;
+
+} // anonymous namespace
+
+namespace trkf {
+
+  /// Default constructor.
+  KHitContainerArena::KHitContainerArena() : fSortedBegin(0), fUnsortedBegin(0)
+  {
+    clear();
+  }
+
+  /// Reserve space for ngroups KHitGroup objects.
+  void KHitContainerArena::reserve(std::size_t ngroups)
+  {
+    fGroups.reserve(ngroups);
+    fOrder.reserve(ngroups);
+  }
+
+  /// Add an empty KHitGroup to the unsorted list.
+  ///
+  /// Returned value: Group number of the new KHitGroup.
+  ///
+  /// References to KHitGroup objects are invalidated by this method,
+  /// group numbers are not.
+  ///
+  std::size_t KHitContainerArena::addGroup()
+  {
+    std::size_t igr = fGroups.size();
+    fGroups.emplace_back();
+    fOrder.push_back(igr);
+    return igr;
+  }
+
+  /// Move a KHitGroup from the sorted list to the end of the unused list.
+  ///
+  /// Arguments:
+  ///
+  /// i - Position in the sorted list.
+  ///
+  /// The remaining sorted objects keep their order.  Moving the first
+  /// sorted object is constant time.
+  ///
+  void KHitContainerArena::moveToUnused(std::size_t i)
+  {
+    if (i >= numSorted())
+      throw cet::exception("KHitContainerArena")
+        << __func__ << ": position " << i << " beyond sorted list of size " << numSorted()
+        << "\n";
+    auto first = fOrder.begin() + fSortedBegin;
+    std::rotate(first, first + i, first + i + 1);
+    ++fSortedBegin;
+  }
+
+  /// Clear all lists and start a new memory arena.
+  ///
+  /// Measurements made in the previous arena stay valid.  The previous
+  /// arena is freed when the last of them is destroyed.
+  ///
+  void KHitContainerArena::clear()
+  {
+    fGroups.clear();
+    fOrder.clear();
+    fSortedBegin = 0;
+    fUnsortedBegin = 0;
+    fArena = std::make_shared<std::pmr::monotonic_buffer_resource>();
+  }
+
+  /// Move all objects to unsorted list (from sorted and unused lists).
+  ///
+  /// The resulting order is the previous unsorted, sorted, then unused
+  /// objects, as for KHitContainer.
+  ///
+  void KHitContainerArena::reset()
+  {
+    auto first = fOrder.begin();
+    std::rotate(first, first + fSortedBegin, first + fUnsortedBegin); // Sorted, unused.
+    std::rotate(first, first + fUnsortedBegin, fOrder.end());
+    fSortedBegin = 0;
+    fUnsortedBegin = 0;
+  }
+
+  /// (Re)sort objects in unsorted and sorted lists.
+  ///
+  /// Arguments:
+  ///
+  /// trk         - Track to be propagated.
+  /// addUnsorted - If true, include unsorted objects in sort.
+  /// prop        - Propagator.
+  /// dir         - Propagation direction.
+  ///
+  void KHitContainerArena::sort(const KTrack& trk,
+                                bool addUnsorted,
+                                const Propagator& prop,
+                                Propagator::PropDirection dir)
+  {
+    // Maybe transfer all objects in unsorted list to the sorted list.
+
+    if (addUnsorted) fUnsortedBegin = fOrder.size();
+
+    // Update the path distance of all objects in the sorted list by
+    // propagating a fresh copy of the track to each surface.
+
+    auto updatePath = [&](std::size_t i) {
+      KHitGroup& gr = fGroups[fOrder[i]];
+      KTrack trkp = trk;
+      std::optional<double> dist = prop.vec_prop(trkp, gr.getSurface(), dir, false, 0, 0);
+      if (!dist)
+        gr.setPath(false, 0.);
+      else
+        gr.setPath(true, *dist);
+    };
+
+    if (fParallelSort && numSorted() >= ParallelSortMin) {
+      tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(fSortedBegin, fUnsortedBegin, ParallelSortGrain),
+        [&](const tbb::blocked_range<std::size_t>& range) {
+          for (std::size_t i = range.begin(); i != range.end(); ++i)
+            updatePath(i);
+        });
+    }
+    else {
+      for (std::size_t i = fSortedBegin; i < fUnsortedBegin; ++i)
+        updatePath(i);
+    }
+
+    auto first = fOrder.begin() + fSortedBegin;
+    auto last = fOrder.begin() + fUnsortedBegin;
+
+    // Move objects for which propagation failed to the end of the
+    // unsorted list, keeping their order.
+
+    auto reached =
+      std::stable_partition(first, last, [this](std::size_t i) { return fGroups[i].getHasPath(); });
+    std::rotate(reached, last, fOrder.end());
+    fUnsortedBegin = reached - fOrder.begin();
+
+    // Finally, sort the sorted list in order of path distance.
+
+    std::stable_sort(
+      first, reached, [this](std::size_t i, std::size_t j) { return fGroups[i] < fGroups[j]; });
+  }
+
+  /// Return the plane with the most KHitGroups in the unsorted list.
+  unsigned int KHitContainerArena::getPreferredPlane() const
+  {
+    // Count hits in each plane.
+
+    std::vector<unsigned int> planehits(3, 0);
+    for (std::size_t i = fUnsortedBegin; i < fOrder.size(); ++i)
+      ++planehits.at(fGroups[fOrder[i]].getPlane());
+
+    // Figure out which plane has the most hits.
+
+    unsigned int prefplane = 0;
+    for (unsigned int i = 0; i < planehits.size(); ++i) {
+      if (planehits[i] >= planehits[prefplane]) prefplane = i;
+    }
+    return prefplane;
+  }
+
+} // end namespace trkf
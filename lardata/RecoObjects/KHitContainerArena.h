@@ -0,0 +1,194 @@
+////////////////////////////////////////////////////////////////////////
+///
+/// \file   KHitContainerArena.h
+///
+/// \brief  A collection of KHitGroups in contiguous storage.
+///
+/// This class is a variant of KHitContainer with the same sorted,
+/// unsorted and unused lists of KHitGroup objects, and the same sort,
+/// reset and getPreferredPlane methods, but with different storage.
+///
+/// 1.  KHitGroup objects are stored by value in one vector, in the
+///     order in which they are added.  They are identified by their
+///     index in this vector (group number), which never changes until
+///     the container is cleared.
+/// 2.  The three lists are consecutive ranges of one vector of group
+///     numbers, in the order unused, sorted, unsorted.  Objects are
+///     transfered among the lists by moving range boundaries (and
+///     rotating ranges if necessary) instead of splicing lists.
+///     Taking the first sorted object (the usual case) is constant
+///     time.
+/// 3.  Measurements can be allocated with method makeHit from a
+///     monotonic memory arena, which is released as a whole.  The
+///     current arena is dropped by method clear, and is freed when the
+///     last measurement allocated from it is destroyed, so measurements
+///     may safely outlive the container (e.g. in a KGTrack).
+///
+/// The order of objects within each list is the same as KHitContainer
+/// would give for the same sequence of operations.  Lists are accessed
+/// by position, e.g. getSorted(0) is the closest sorted KHitGroup.
+/// Parallel sorting can be enabled as for KHitContainer.
+///
+/// Vector capacities are kept by clear, so that a container reused for
+/// every event stops allocating memory for KHitGroup objects after the
+/// first few events.
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef KHITCONTAINERARENA_H
+#define KHITCONTAINERARENA_H
+
+#include "canvas/Persistency/Common/PtrVector.h"
+#include "lardata/RecoObjects/KHitGroup.h"
+#include "lardata/RecoObjects/KTrack.h"
+#include "lardata/RecoObjects/Propagator.h"
+#include "lardataobj/RecoBase/Hit.h"
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace detinfo {
+  class DetectorPropertiesData;
+}
+
+namespace trkf {
+
+  class KHitContainerArena {
+  public:
+    /// Allocator from a shared memory arena (keeps the arena alive).
+    template <class T>
+    class Allocator {
+    public:
+      using value_type = T;
+
+      explicit Allocator(std::shared_ptr<std::pmr::memory_resource> arena)
+        : fArena(std::move(arena))
+      {}
+      template <class U>
+      Allocator(const Allocator<U>& alloc) : fArena(alloc.fArena)
+      {}
+
+      T* allocate(std::size_t n)
+      {
+        return static_cast<T*>(fArena->allocate(n * sizeof(T), alignof(T)));
+      }
+      void deallocate(T* p, std::size_t n) { fArena->deallocate(p, n * sizeof(T), alignof(T)); }
+
+      template <class U>
+      bool operator==(const Allocator<U>& alloc) const
+      {
+        return fArena == alloc.fArena;
+      }
+      template <class U>
+      bool operator!=(const Allocator<U>& alloc) const
+      {
+        return fArena != alloc.fArena;
+      }
+
+    private:
+      template <class U>
+      friend class Allocator;
+
+      std::shared_ptr<std::pmr::memory_resource> fArena; ///< Memory arena.
+    };
+
+    /// Default constructor.
+    KHitContainerArena();
+
+    virtual ~KHitContainerArena() = default;
+
+    virtual void fill(detinfo::DetectorPropertiesData const& clock_data,
+                      const art::PtrVector<recob::Hit>& hits,
+                      int only_plane) = 0;
+
+    // Accessors.
+
+    std::size_t size() const { return fGroups.size(); } ///< Number of KHitGroups.
+
+    /// Number of sorted KHitGroups.
+    std::size_t numSorted() const { return fUnsortedBegin - fSortedBegin; }
+
+    /// Number of unsorted KHitGroups.
+    std::size_t numUnsorted() const { return fOrder.size() - fUnsortedBegin; }
+
+    /// Number of unused KHitGroups.
+    std::size_t numUnused() const { return fSortedBegin; }
+
+    /// Parallel sorting flag.
+    bool getParallelSort() const { return fParallelSort; }
+
+    /// KHitGroup by group number.
+    const KHitGroup& getGroup(std::size_t igr) const { return fGroups[igr]; }
+
+    /// KHitGroup at position i of the sorted list.
+    const KHitGroup& getSorted(std::size_t i) const { return fGroups[fOrder[fSortedBegin + i]]; }
+
+    /// KHitGroup at position i of the unsorted list.
+    const KHitGroup& getUnsorted(std::size_t i) const
+    {
+      return fGroups[fOrder[fUnsortedBegin + i]];
+    }
+
+    /// KHitGroup at position i of the unused list.
+    const KHitGroup& getUnused(std::size_t i) const { return fGroups[fOrder[i]]; }
+
+    // Non-const Accessors.
+
+    KHitGroup& getGroup(std::size_t igr) { return fGroups[igr]; }                     ///< Group.
+    KHitGroup& getSorted(std::size_t i) { return fGroups[fOrder[fSortedBegin + i]]; } ///< Sorted.
+    KHitGroup& getUnused(std::size_t i) { return fGroups[fOrder[i]]; }                ///< Unused.
+
+    /// Unsorted.
+    KHitGroup& getUnsorted(std::size_t i) { return fGroups[fOrder[fUnsortedBegin + i]]; }
+
+    // Modifiers.
+
+    /// Enable or disable parallel sorting (see KHitContainer).
+    void setParallelSort(bool parallel) { fParallelSort = parallel; }
+
+    /// Reserve space for ngroups KHitGroup objects.
+    void reserve(std::size_t ngroups);
+
+    /// Add an empty KHitGroup to the unsorted list and return its group number.
+    std::size_t addGroup();
+
+    /// Make a measurement in the memory arena.
+    template <class T, class... Args>
+    std::shared_ptr<const T> makeHit(Args&&... args) const
+    {
+      return std::allocate_shared<T>(Allocator<T>(fArena), std::forward<Args>(args)...);
+    }
+
+    /// Move the KHitGroup at position i of the sorted list to the unused list.
+    void moveToUnused(std::size_t i = 0);
+
+    /// Clear all lists and start a new memory arena.
+    void clear();
+
+    /// Move all objects to unsorted list (from sorted and unused lists).
+    void reset();
+
+    /// (Re)sort objects in unsorted and sorted lists.
+    void sort(const KTrack& trk,
+              bool addUnsorted,
+              const Propagator& prop,
+              Propagator::PropDirection dir = Propagator::UNKNOWN);
+
+    /// Return the plane with the most KHitGroups in the unsorted list.
+    unsigned int getPreferredPlane() const;
+
+  private:
+    // Attributes.
+
+    std::vector<KHitGroup> fGroups;                    ///< KHitGroup objects, by group number.
+    std::vector<std::size_t> fOrder;                   ///< Group numbers: unused, sorted, unsorted.
+    std::size_t fSortedBegin;                          ///< Start of sorted list in fOrder.
+    std::size_t fUnsortedBegin;                        ///< Start of unsorted list in fOrder.
+    std::shared_ptr<std::pmr::memory_resource> fArena; ///< Measurement memory arena.
+    bool fParallelSort = false;                        ///< Propagate concurrently in sort.
+  };
+}
+
+#endif
@@ -0,0 +1,56 @@
+///////////////////////////////////////////////////////////////////////
+///
+/// \file   KHitContainerArenaWireX.cxx
+///
+/// \brief  A KHitContainerArena for KHitWireX type measurements.
+///
+////////////////////////////////////////////////////////////////////////
+
+#include <unordered_map>
+
+#include "lardata/RecoObjects/KHitContainerArenaWireX.h"
+#include "lardata/RecoObjects/KHitWireX.h"
+
+namespace trkf {
+
+  /// Fill container.
+  ///
+  /// Arguments:
+  ///
+  /// hits       - RecoBase/Hit collection.
+  /// only_plane - Choose hits from this plane if >= 0.
+  ///
+  /// This method converts the hits in the input collection into
+  /// KHitWireX objects and inserts them into the base class.  Hits
+  /// corresponding to the same readout wire are grouped together as
+  /// KHitGroup objects.
+  ///
+  void KHitContainerArenaWireX::fill(const detinfo::DetectorPropertiesData& detProp,
+                                     const art::PtrVector<recob::Hit>& hits,
+                                     int only_plane)
+  {
+    reserve(size() + hits.size());
+
+    // Make a temporary map from channel number to group number.
+
+    std::unordered_map<unsigned int, std::size_t> group_map;
+
+    // Loop over hits.
+
+    for (const art::Ptr<recob::Hit>& phit : hits) {
+      const recob::Hit& hit = *phit;
+
+      // Choose plane.
+      if (only_plane >= 0 && hit.WireID().Plane != (unsigned int)(only_plane)) continue;
+
+      // See if we need to make a new KHitGroup.
+
+      auto [it, added] = group_map.try_emplace(hit.Channel());
+      if (added) it->second = addGroup();
+      KHitGroup& gr = getGroup(it->second);
+
+      gr.addHit(makeHit<KHitWireX>(detProp, phit, gr.getSurface()));
+    }
+  }
+
+} // end namespace trkf
@@ -0,0 +1,31 @@
+////////////////////////////////////////////////////////////////////////
+///
+/// \file   KHitContainerArenaWireX.h
+///
+/// \brief  A KHitContainerArena for KHitWireX type measurements.
+///
+/// This class derives from KHitContainerArena.  It fills the container
+/// from a collection of recob::Hit objects in the same way as
+/// KHitContainerWireX, with the KHitWireX measurements made in the
+/// memory arena of the base class.
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef KHITCONTAINERARENAWIREX_H
+#define KHITCONTAINERARENAWIREX_H
+
+#include "canvas/Persistency/Common/PtrVector.h"
+#include "lardata/RecoObjects/KHitContainerArena.h"
+#include "lardataobj/RecoBase/Hit.h"
+
+namespace trkf {
+
+  class KHitContainerArenaWireX : public KHitContainerArena {
+  public:
+    void fill(const detinfo::DetectorPropertiesData& clock_data,
+              const art::PtrVector<recob::Hit>& hits,
+              int only_plane) override;
+  };
+}
+
+#endif
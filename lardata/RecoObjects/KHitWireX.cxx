@@ -12,7 +12,7 @@
 #include "cetlib_except/exception.h"
 #include "larcore/Geometry/Geometry.h"
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
-#include "lardata/RecoObjects/SurfWireX.h"
+#include "lardata/RecoObjects/SurfaceRegistry.h"
 
 namespace trkf {
 
@@ -36,19 +36,15 @@ namespace trkf {
     geo::WireID wireid = hit->WireID();
 
     // Check the surface (determined by wire id).  If the
-    // surface pointer is null, make a new SurfWireX surface and
-    // update the base class appropriately.  Otherwise, just check
-    // that the specified surface agrees with the wire id.
-
-    if (psurf.get() == 0) {
-      std::shared_ptr<const Surface> new_psurf(new SurfWireX(wireid));
-      setMeasSurface(new_psurf);
-    }
-    else {
-      SurfWireX check_surf(wireid);
-      if (!check_surf.isEqual(*psurf))
-        throw cet::exception("KHitWireX") << "Measurement surface doesn't match wire id.\n";
-    }
+    // surface pointer is null, use the shared SurfWireX surface of
+    // this wire and update the base class appropriately.  Otherwise,
+    // just check that the specified surface agrees with the wire id.
+
+    std::shared_ptr<const SurfWireX> wire_psurf = SurfaceRegistry::getWireX(wireid);
+    if (psurf.get() == 0)
+      setMeasSurface(wire_psurf);
+    else if (!wire_psurf->isEqual(*psurf))
+      throw cet::exception("KHitWireX") << "Measurement surface doesn't match wire id.\n";
 
     setMeasPlane(hit->WireID().Plane);
 
@@ -91,7 +87,7 @@ namespace trkf {
   /// xerr    - X error.
   ///
   KHitWireX::KHitWireX(const geo::WireID& wireid, double x, double xerr)
-    : KHit(std::shared_ptr<const Surface>(new SurfWireX(wireid)))
+    : KHit(SurfaceRegistry::getWireX(wireid))
   {
     // Get services.
 
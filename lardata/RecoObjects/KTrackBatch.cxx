@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////
+///
+/// \file   KTrackBatch.cxx
+///
+/// \brief  Batch of Kalman filter tracks in structure-of-arrays layout.
+///
+////////////////////////////////////////////////////////////////////////
+
+#include "lardata/RecoObjects/KTrackBatch.h"
+#include "cetlib_except/exception.h"
+
+namespace trkf {
+
+  /// Constructor.
+  ///
+  /// Arguments:
+  ///
+  /// withError - Store the track error matrices.
+  ///
+  KTrackBatch::KTrackBatch(bool withError) : fWithError(withError) {}
+
+  /// Reserve space for n lanes.
+  void KTrackBatch::reserve(std::size_t n)
+  {
+    fSurf.reserve(n);
+    fDir.reserve(n);
+    fPdgCode.reserve(n);
+    for (auto& p : fPar)
+      p.reserve(n);
+    if (fWithError) {
+      for (auto& e : fErr)
+        e.reserve(n);
+    }
+  }
+
+  /// Remove all the lanes.
+  void KTrackBatch::clear()
+  {
+    fSurf.clear();
+    fDir.clear();
+    fPdgCode.clear();
+    for (auto& p : fPar)
+      p.clear();
+    for (auto& e : fErr)
+      e.clear();
+  }
+
+  /// Add a track without error.
+  void KTrackBatch::push_back(const KTrack& trk)
+  {
+    if (fWithError)
+      throw cet::exception("KTrackBatch") << "Track without error added to batch with errors.\n";
+    addTrack(trk);
+  }
+
+  /// Add a track with error.
+  void KTrackBatch::push_back(const KETrack& tre)
+  {
+    addTrack(tre);
+    if (fWithError) {
+      const TrackError& err = tre.getError();
+      if (err.size1() != NPar)
+        throw cet::exception("KTrackBatch")
+          << "Track error matrix has wrong size " << err.size1() << "\n";
+      for (int k = 0; k < NErr; ++k)
+        fErr[k].push_back(err.data()[k]);
+    }
+  }
+
+  /// Add the attributes common to KTrack and KETrack.
+  void KTrackBatch::addTrack(const KTrack& trk)
+  {
+    const TrackVector& vec = trk.getVector();
+    if (vec.size() != NPar)
+      throw cet::exception("KTrackBatch")
+        << "Track state vector has wrong size " << vec.size() << "\n";
+    fSurf.push_back(trk.getSurface());
+    fDir.push_back(trk.getDirection());
+    fPdgCode.push_back(trk.PdgCode());
+    for (int k = 0; k < NPar; ++k)
+      fPar[k].push_back(vec(k));
+  }
+
+  /// Mass of lane i, based on pdg code (see KTrack::Mass).
+  double KTrackBatch::Mass(std::size_t i) const
+  {
+    KTrack trk;
+    trk.setPdgCode(fPdgCode[i]);
+    return trk.Mass();
+  }
+
+  /// Copy of the track in lane i.
+  KTrack KTrackBatch::getTrack(std::size_t i) const
+  {
+    TrackVector vec(NPar);
+    for (int k = 0; k < NPar; ++k)
+      vec(k) = fPar[k][i];
+    return KTrack(fSurf[i], vec, fDir[i], fPdgCode[i]);
+  }
+
+  /// Copy of the track with error in lane i.
+  KETrack KTrackBatch::getETrack(std::size_t i) const
+  {
+    if (!fWithError)
+      throw cet::exception("KTrackBatch") << "Track error requested from batch without errors.\n";
+    TrackError err(NPar);
+    for (int k = 0; k < NErr; ++k)
+      err.data()[k] = fErr[k][i];
+    return KETrack(getTrack(i), err);
+  }
+
+  /// Replace the surface, state vector and direction of lane i.
+  void KTrackBatch::setTrack(std::size_t i, const KTrack& trk)
+  {
+    const TrackVector& vec = trk.getVector();
+    if (vec.size() != NPar)
+      throw cet::exception("KTrackBatch")
+        << "Track state vector has wrong size " << vec.size() << "\n";
+    fSurf[i] = trk.getSurface();
+    fDir[i] = trk.getDirection();
+    for (int k = 0; k < NPar; ++k)
+      fPar[k][i] = vec(k);
+  }
+
+  /// Replace lane i, including the error matrix.
+  void KTrackBatch::setETrack(std::size_t i, const KETrack& tre)
+  {
+    if (!fWithError)
+      throw cet::exception("KTrackBatch") << "Track error stored in batch without errors.\n";
+    setTrack(i, tre);
+    for (int k = 0; k < NErr; ++k)
+      fErr[k][i] = tre.getError().data()[k];
+  }
+} // end namespace trkf
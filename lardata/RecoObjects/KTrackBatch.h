@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////
+///
+/// \file   KTrackBatch.h
+///
+/// \brief  Batch of Kalman filter tracks in structure-of-arrays layout.
+///
+/// This class holds the state of a number of tracks ("lanes") with one
+/// array per track parameter and one array per error matrix element,
+/// so that the batch methods of class Propagator can process all the
+/// lanes with the same instructions.  Each lane has the attributes of
+/// a KETrack.
+///
+/// 1. Surface.
+/// 2. Track state vector (five track parameters).
+/// 3. Track direction parameter.
+/// 4. Particle id hypothesis.
+/// 5. Track error matrix (only if the batch is made with errors).
+///
+/// The error matrix elements are stored in the same order as the
+/// packed lower triangle of TrackError, that is element (i,j), i >= j,
+/// is array number i*(i+1)/2 + j.
+///
+/// Tracks are copied in with push_back and copied out with getTrack or
+/// getETrack.  All tracks of a batch must have five track parameters.
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef KTRACKBATCH_H
+#define KTRACKBATCH_H
+
+#include "lardata/RecoObjects/KETrack.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace trkf {
+
+  class KTrackBatch {
+  public:
+    /// Number of track parameters.
+    static constexpr int NPar = 5;
+
+    /// Number of independent error matrix elements.
+    static constexpr int NErr = NPar * (NPar + 1) / 2;
+
+    /// Constructor.
+    explicit KTrackBatch(bool withError = false);
+
+    // Accessors.
+
+    std::size_t size() const { return fSurf.size(); } ///< Number of lanes.
+    bool empty() const { return fSurf.empty(); }      ///< No lanes.
+    bool hasError() const { return fWithError; }      ///< Error matrices stored.
+
+    /// Surface of lane i.
+    const std::shared_ptr<const Surface>& getSurface(std::size_t i) const { return fSurf[i]; }
+    Surface::TrackDirection getDirection(std::size_t i) const { return fDir[i]; } ///< Direction.
+    int PdgCode(std::size_t i) const { return fPdgCode[i]; }                      ///< Pdg code.
+    double Mass(std::size_t i) const;                                             ///< Mass.
+
+    /// Track parameter k of all the lanes.
+    const double* par(int k) const { return fPar[k].data(); }
+
+    /// Error matrix element k (packed index) of all the lanes.
+    const double* err(int k) const { return fErr[k].data(); }
+
+    /// Copy of the track in lane i.
+    KTrack getTrack(std::size_t i) const;
+
+    /// Copy of the track with error in lane i (batch with errors only).
+    KETrack getETrack(std::size_t i) const;
+
+    // Modifiers.
+
+    double* par(int k) { return fPar[k].data(); } ///< Modifiable track parameter k.
+    double* err(int k) { return fErr[k].data(); } ///< Modifiable error matrix element k.
+
+    /// Set surface of lane i.
+    void setSurface(std::size_t i, const std::shared_ptr<const Surface>& psurf)
+    {
+      fSurf[i] = psurf;
+    }
+    void setDirection(std::size_t i, Surface::TrackDirection dir) { fDir[i] = dir; } ///< Set dir.
+
+    /// Reserve space for n lanes.
+    void reserve(std::size_t n);
+
+    /// Remove all the lanes.
+    void clear();
+
+    /// Add a track without error (batch without errors only).
+    void push_back(const KTrack& trk);
+
+    /// Add a track with error (the error is ignored in a batch without errors).
+    void push_back(const KETrack& tre);
+
+    /// Replace the surface, state vector and direction of lane i.
+    void setTrack(std::size_t i, const KTrack& trk);
+
+    /// Replace lane i, including the error matrix (batch with errors only).
+    void setETrack(std::size_t i, const KETrack& tre);
+
+  private:
+    /// Add the attributes common to KTrack and KETrack.
+    void addTrack(const KTrack& trk);
+
+    // Attributes.
+
+    bool fWithError;                                   ///< Error matrices stored.
+    std::vector<std::shared_ptr<const Surface>> fSurf; ///< Track surfaces.
+    std::vector<Surface::TrackDirection> fDir;         ///< Track directions.
+    std::vector<int> fPdgCode;                         ///< Pdg id. hypotheses.
+    std::vector<double> fPar[NPar];                    ///< Track parameters.
+    std::vector<double> fErr[NErr];                    ///< Packed error matrices.
+  };
+}
+
+#endif
@@ -0,0 +1,343 @@
+////////////////////////////////////////////////////////////////////////
+///
+/// \file   KalmanFixedLinearAlgebra.h
+///
+/// \brief  Fixed-size linear algebra kernels for the Kalman filter.
+///
+/// The Kalman filter objects (KalmanLinearAlgebra.h) are ublas vectors
+/// and matrices with bounded storage, whose size is only known at run
+/// time.  The ublas expressions on them make many temporaries and do not
+/// vectorize well.  This header provides the hot kernels of the filter
+/// for sizes known at compilation time, on plain arrays held on the stack:
+///
+/// 1. syminvert - Symmetric matrix inversion (LDL^T decomposition).
+/// 2. similarity - Similarity transform A S A^T of a symmetric matrix.
+/// 3. update - Kalman update of a track state and error (Joseph form).
+///
+/// Each of them is also provided for the ublas typedefs; it loads the
+/// ublas objects into fixed-size arrays, runs the kernel and stores the
+/// result back.  syminvert falls back to trkf::syminvert if the run time
+/// size of the matrix is not the expected one; trySimilarity and
+/// tryUpdate return false without doing anything instead, in which case
+/// the caller is expected to use the ublas expressions.
+///
+/// The RecoObjects classes use these kernels, unless the preprocessor
+/// symbol TRKF_UBLAS_KALMAN is defined, in which case the original ublas
+/// expressions are used (see UseFixedKalmanAlgebra).
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef KALMANFIXEDLINEARALGEBRA_H
+#define KALMANFIXEDLINEARALGEBRA_H
+
+#include "lardata/RecoObjects/KalmanLinearAlgebra.h"
+
+namespace trkf {
+
+#ifdef TRKF_UBLAS_KALMAN
+  inline constexpr bool UseFixedKalmanAlgebra = false;
+#else
+  inline constexpr bool UseFixedKalmanAlgebra = true;
+#endif
+
+  namespace fixed {
+
+    /// Dense, row major matrix, dimension NxM.
+    template <int N, int M>
+    struct Matrix {
+      alignas(32) double a[N][M];
+
+      double& operator()(int i, int j) { return a[i][j]; }
+      double operator()(int i, int j) const { return a[i][j]; }
+    };
+
+    /// Vector, dimension N.
+    template <int N>
+    struct Vector {
+      alignas(32) double a[N];
+
+      double& operator()(int i) { return a[i]; }
+      double operator()(int i) const { return a[i]; }
+    };
+
+    // Products.
+
+    /// Returns A B.
+    template <int N, int K, int M>
+    Matrix<N, M> multiply(const Matrix<N, K>& A, const Matrix<K, M>& B)
+    {
+      Matrix<N, M> C;
+      for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < M; ++j)
+          C(i, j) = 0.;
+        for (int k = 0; k < K; ++k) {
+          const double aik = A(i, k);
+          for (int j = 0; j < M; ++j)
+            C(i, j) += aik * B(k, j);
+        }
+      }
+      return C;
+    }
+
+    /// Returns A B^T.
+    template <int N, int K, int M>
+    Matrix<N, M> multiplyTransposed(const Matrix<N, K>& A, const Matrix<M, K>& B)
+    {
+      Matrix<N, M> C;
+      for (int i = 0; i < N; ++i) {
+        for (int j = 0; j < M; ++j) {
+          double sum = 0.;
+          for (int k = 0; k < K; ++k)
+            sum += A(i, k) * B(j, k);
+          C(i, j) = sum;
+        }
+      }
+      return C;
+    }
+
+    /// Returns A v.
+    template <int N, int M>
+    Vector<N> multiply(const Matrix<N, M>& A, const Vector<M>& v)
+    {
+      Vector<N> w;
+      for (int i = 0; i < N; ++i) {
+        double sum = 0.;
+        for (int j = 0; j < M; ++j)
+          sum += A(i, j) * v(j);
+        w(i) = sum;
+      }
+      return w;
+    }
+
+    /// Returns A S A^T for symmetric S (both triangles filled).
+    ///
+    /// Only the lower triangle is calculated, the upper one is its mirror.
+    template <int N, int M>
+    Matrix<N, N> similarity(const Matrix<N, M>& A, const Matrix<M, M>& S)
+    {
+      const Matrix<N, M> AS = multiply(A, S);
+      Matrix<N, N> R;
+      for (int i = 0; i < N; ++i) {
+        for (int j = 0; j <= i; ++j) {
+          double sum = 0.;
+          for (int k = 0; k < M; ++k)
+            sum += AS(i, k) * A(j, k);
+          R(i, j) = sum;
+          R(j, i) = sum;
+        }
+      }
+      return R;
+    }
+
+    /// Invert symmetric matrix in place (return false if singular).
+    ///
+    /// Same LDL^T decomposition method as trkf::syminvert.  Only the lower
+    /// triangle is read; both triangles are filled on success.
+    template <int N>
+    bool syminvert(Matrix<N, N>& m)
+    {
+      // In situ decomposition m = LDL^T.
+
+      for (int i = 0; i < N; ++i) {
+        for (int j = 0; j <= i; ++j) {
+          double ele = m(i, j);
+          for (int k = 0; k < j; ++k)
+            ele -= m(k, k) * m(i, k) * m(j, k);
+          if (i == j) {
+            if (ele == 0.) return false;
+          }
+          else
+            ele = ele / m(j, j);
+          m(i, j) = ele;
+        }
+      }
+
+      // In situ inversion of D and L.
+
+      for (int i = 0; i < N; ++i) {
+        for (int j = 0; j <= i; ++j) {
+          if (i == j)
+            m(i, i) = 1. / m(i, i);
+          else {
+            double sum = -m(i, j);
+            for (int k = j + 1; k < i; ++k)
+              sum -= m(i, k) * m(k, j);
+            m(i, j) = sum;
+          }
+        }
+      }
+
+      // Recompose the inverse m = L^T D L.
+
+      for (int i = 0; i < N; ++i) {
+        for (int j = 0; j <= i; ++j) {
+          double sum = m(i, i);
+          if (i != j) sum *= m(i, j);
+          for (int k = i + 1; k < N; ++k)
+            sum += m(k, k) * m(k, i) * m(k, j);
+          m(i, j) = sum;
+        }
+      }
+      for (int i = 0; i < N; ++i)
+        for (int j = 0; j < i; ++j)
+          m(j, i) = m(i, j);
+
+      return true;
+    }
+
+    /// Kalman update of state x and error P with a measurement of
+    /// dimension N (Joseph form).
+    ///
+    /// Arguments:
+    ///
+    /// x    - Track state (updated).
+    /// P    - Track error matrix (updated).
+    /// H    - Kalman H-matrix.
+    /// V    - Measurement error matrix.
+    /// Rinv - Inverse residual error matrix.
+    /// r    - Residual vector.
+    ///
+    /// K = P H^T Rinv;  x += K r;  P = (1 - K H) P (1 - K H)^T + K V K^T.
+    ///
+    template <int D, int N>
+    void update(Vector<D>& x,
+                Matrix<D, D>& P,
+                const Matrix<N, D>& H,
+                const Matrix<N, N>& V,
+                const Matrix<N, N>& Rinv,
+                const Vector<N>& r)
+    {
+      const Matrix<D, N> PHt = multiplyTransposed(P, H);
+      const Matrix<D, N> K = multiply(PHt, Rinv);
+
+      const Vector<D> dx = multiply(K, r);
+      for (int i = 0; i < D; ++i)
+        x(i) += dx(i);
+
+      Matrix<D, D> A = multiply(K, H);
+      for (int i = 0; i < D; ++i)
+        for (int j = 0; j < D; ++j)
+          A(i, j) = (i == j ? 1. : 0.) - A(i, j);
+
+      const Matrix<D, D> APAt = similarity(A, P);
+      const Matrix<D, D> KVKt = similarity(K, V);
+      for (int i = 0; i < D; ++i)
+        for (int j = 0; j < D; ++j)
+          P(i, j) = APAt(i, j) + KVKt(i, j);
+    }
+
+    // Transfer from and to the ublas objects.
+
+    template <int N, class V>
+    Vector<N> load(const ublas::vector<double, V>& v)
+    {
+      Vector<N> w;
+      for (int i = 0; i < N; ++i)
+        w(i) = v(i);
+      return w;
+    }
+
+    template <int N, class A>
+    Matrix<N, N> load(const ublas::symmetric_matrix<double, ublas::lower, ublas::row_major, A>& s)
+    {
+      Matrix<N, N> m;
+      const double* packed = &s.data()[0];
+      for (int i = 0; i < N; ++i) {
+        for (int j = 0; j <= i; ++j) {
+          m(i, j) = *packed;
+          m(j, i) = *packed++;
+        }
+      }
+      return m;
+    }
+
+    template <int N, int M, class A>
+    Matrix<N, M> load(const ublas::matrix<double, ublas::row_major, A>& s)
+    {
+      Matrix<N, M> m;
+      const double* data = &s.data()[0];
+      for (int i = 0; i < N; ++i)
+        for (int j = 0; j < M; ++j)
+          m(i, j) = data[i * M + j];
+      return m;
+    }
+
+    template <int N, class V>
+    void store(const Vector<N>& w, ublas::vector<double, V>& v)
+    {
+      if ((int)v.size() != N) v.resize(N, false);
+      for (int i = 0; i < N; ++i)
+        v(i) = w(i);
+    }
+
+    template <int N, class A>
+    void store(const Matrix<N, N>& m,
+               ublas::symmetric_matrix<double, ublas::lower, ublas::row_major, A>& s)
+    {
+      if ((int)s.size1() != N) s.resize(N, false);
+      double* packed = &s.data()[0];
+      for (int i = 0; i < N; ++i)
+        for (int j = 0; j <= i; ++j)
+          *packed++ = m(i, j);
+    }
+
+    template <int N, int M, class A>
+    void store(const Matrix<N, M>& m, ublas::matrix<double, ublas::row_major, A>& s)
+    {
+      if (((int)s.size1() != N) || ((int)s.size2() != M)) s.resize(N, M, false);
+      double* data = &s.data()[0];
+      for (int i = 0; i < N; ++i)
+        for (int j = 0; j < M; ++j)
+          data[i * M + j] = m(i, j);
+    }
+
+    // Kernels on the ublas typedefs.
+
+    /// Invert symmetric matrix of expected size N (return false if singular).
+    template <int N, class A>
+    bool syminvert(ublas::symmetric_matrix<double, ublas::lower, ublas::row_major, A>& s)
+    {
+      if ((int)s.size1() != N) return trkf::syminvert(s);
+      Matrix<N, N> m = load<N>(s);
+      if (!syminvert(m)) return false;
+      store(m, s);
+      return true;
+    }
+
+    /// Replace the track error err with F err F^T (false if not 5x5).
+    inline bool trySimilarity(const TrackMatrix& F, TrackError& err)
+    {
+      if ((F.size1() != 5) || (F.size2() != 5) || (err.size1() != 5)) return false;
+      store(similarity(load<5, 5>(F), load<5>(err)), err);
+      return true;
+    }
+
+    /// Kalman update of a track vector and error with a measurement of
+    /// dimension N (see update() on fixed-size objects); false if the
+    /// objects do not have the expected sizes.
+    template <int N>
+    bool tryUpdate(TrackVector& tvec,
+                   TrackError& terr,
+                   const typename KHMatrix<N>::type& H,
+                   const typename KSymMatrix<N>::type& V,
+                   const typename KSymMatrix<N>::type& Rinv,
+                   const typename KVector<N>::type& r)
+    {
+      if ((tvec.size() != 5) || (terr.size1() != 5)) return false;
+      if ((H.size1() != N) || (H.size2() != 5) || (V.size1() != N) || (Rinv.size1() != N) ||
+          (r.size() != N))
+        return false;
+
+      Vector<5> x = load<5>(tvec);
+      Matrix<5, 5> P = load<5>(terr);
+      update(x, P, load<N, 5>(H), load<N>(V), load<N>(Rinv), load<N>(r));
+      store(x, tvec);
+      store(P, terr);
+      return true;
+    }
+
+  } // namespace fixed
+
+} // namespace trkf
+
+#endif
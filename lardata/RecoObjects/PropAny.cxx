@@ -15,6 +15,20 @@
 #include "lardata/RecoObjects/SurfYZLine.h"
 #include "lardata/RecoObjects/SurfYZPlane.h"
 
+#include <variant>
+
+namespace {
+
+  /// Set of overloaded function objects, for std::visit.
+  template <class... F>
+  struct overloaded : F... {
+    using F::operator()...;
+  };
+  template <class... F>
+  overloaded(F...) -> overloaded<F...>;
+
+} // anonymous namespace
+
 namespace trkf {
 
   /// Constructor.
@@ -37,8 +51,9 @@ namespace trkf {
 
   /// Propagate without error.
   /// Optionally return propagation matrix and noise matrix.
-  /// This method tests the type of the destination surface, and calls
-  /// the corresponding typed propagator.
+  /// This method dispatches on the type of the destination surface
+  /// (Surface::getVariant), and calls the corresponding typed propagator
+  /// directly (not through the virtual interface).
   ///
   /// Arguments:
   ///
@@ -58,24 +73,25 @@ namespace trkf {
                                                 TrackMatrix* prop_matrix,
                                                 TrackError* noise_matrix) const
   {
-    // Default result.
-
-    std::optional<double> result{std::nullopt};
-
-    // Test the type of the destination surface.
-
-    if (dynamic_cast<const SurfYZLine*>(&*psurf))
-      result = fPropYZLine.short_vec_prop(trk, psurf, dir, doDedx, prop_matrix, noise_matrix);
-    else if (dynamic_cast<const SurfYZPlane*>(&*psurf))
-      result = fPropYZPlane.short_vec_prop(trk, psurf, dir, doDedx, prop_matrix, noise_matrix);
-    else if (dynamic_cast<const SurfXYZPlane*>(&*psurf))
-      result = fPropXYZPlane.short_vec_prop(trk, psurf, dir, doDedx, prop_matrix, noise_matrix);
-    else
-      throw cet::exception("PropAny") << "Destination surface has unknown type.\n";
-
-    // Done.
-
-    return result;
+    // Dispatch on the type of the destination surface.
+
+    return std::visit(
+      overloaded{[&](const SurfYZLine*) {
+                   return fPropYZLine.PropYZLine::short_vec_prop(
+                     trk, psurf, dir, doDedx, prop_matrix, noise_matrix);
+                 },
+                 [&](const SurfYZPlane*) {
+                   return fPropYZPlane.PropYZPlane::short_vec_prop(
+                     trk, psurf, dir, doDedx, prop_matrix, noise_matrix);
+                 },
+                 [&](const SurfXYZPlane*) {
+                   return fPropXYZPlane.PropXYZPlane::short_vec_prop(
+                     trk, psurf, dir, doDedx, prop_matrix, noise_matrix);
+                 },
+                 [](std::monostate) -> std::optional<double> {
+                   throw cet::exception("PropAny") << "Destination surface has unknown type.\n";
+                 }},
+      psurf->getVariant());
   }
 
   /// Propagate without error to dynamically generated origin surface.
@@ -95,24 +111,22 @@ namespace trkf {
                                                  const std::shared_ptr<const Surface>& porient,
                                                  TrackMatrix* prop_matrix) const
   {
-    // Default result.
-
-    std::optional<double> result{std::nullopt};
-
-    // Test the type of the destination surface.
-
-    if (dynamic_cast<const SurfYZLine*>(&*porient))
-      result = fPropYZLine.origin_vec_prop(trk, porient, prop_matrix);
-    else if (dynamic_cast<const SurfYZPlane*>(&*porient))
-      result = fPropYZPlane.origin_vec_prop(trk, porient, prop_matrix);
-    else if (dynamic_cast<const SurfXYZPlane*>(&*porient))
-      result = fPropXYZPlane.origin_vec_prop(trk, porient, prop_matrix);
-    else
-      throw cet::exception("PropAny") << "Destination surface has unknown type.\n";
-
-    // Done.
-
-    return result;
+    // Dispatch on the type of the orientation surface.
+
+    return std::visit(
+      overloaded{[&](const SurfYZLine*) {
+                   return fPropYZLine.PropYZLine::origin_vec_prop(trk, porient, prop_matrix);
+                 },
+                 [&](const SurfYZPlane*) {
+                   return fPropYZPlane.PropYZPlane::origin_vec_prop(trk, porient, prop_matrix);
+                 },
+                 [&](const SurfXYZPlane*) {
+                   return fPropXYZPlane.PropXYZPlane::origin_vec_prop(trk, porient, prop_matrix);
+                 },
+                 [](std::monostate) -> std::optional<double> {
+                   throw cet::exception("PropAny") << "Destination surface has unknown type.\n";
+                 }},
+      porient->getVariant());
   }
 
 } // end namespace trkf
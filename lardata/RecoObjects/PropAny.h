@@ -10,6 +10,11 @@
 /// tests the type of the destination surface, and calls the
 /// propagator.
 ///
+/// The surface type is obtained as a SurfaceVariant (see Surface.h),
+/// with std::visit selecting the typed propagator at compile time.
+/// The typed propagators in turn dispatch on the variant of the
+/// initial surface, so that no dynamic_cast is needed.
+///
 ////////////////////////////////////////////////////////////////////////
 
 #ifndef PROPANY_H
@@ -63,13 +63,11 @@ namespace trkf {
     // Get destination surface and surface parameters.
     // Return failure if wrong surface type.
 
-    const SurfXYZPlane* to = dynamic_cast<const SurfXYZPlane*>(&*psurf);
+    const SurfXYZPlane* to = typedSurface<SurfXYZPlane>(psurf->getVariant());
     if (to == 0) return result;
     double x02 = to->x0();
     double y02 = to->y0();
     double z02 = to->z0();
-    double theta2 = to->theta();
-    double phi2 = to->phi();
 
     // Remember starting track.
 
@@ -112,10 +110,10 @@ namespace trkf {
 
     // Calculate transcendental functions.
 
-    double sinth2 = std::sin(theta2);
-    double costh2 = std::cos(theta2);
-    double sinphi2 = std::sin(phi2);
-    double cosphi2 = std::cos(phi2);
+    double sinth2 = to->sinTheta();
+    double costh2 = to->cosTheta();
+    double sinphi2 = to->sinPhi();
+    double cosphi2 = to->cosPhi();
 
     // Calculate elements of rotation matrix from global coordinate
     // system to destination coordinate system.
@@ -304,15 +302,16 @@ namespace trkf {
     // Generate the origin surface, which will be the destination surface.
     // Return failure if orientation surface is the wrong type.
 
-    const SurfXYZPlane* orient = dynamic_cast<const SurfXYZPlane*>(&*porient);
+    const SurfXYZPlane* orient = typedSurface<SurfXYZPlane>(porient->getVariant());
     if (orient == 0) return result;
     double theta2 = orient->theta();
     double phi2 = orient->phi();
-    std::shared_ptr<const Surface> porigin(new SurfXYZPlane(x02, y02, z02, phi2, theta2));
+    std::shared_ptr<const Surface> porigin(new SurfXYZPlane(x02, y02, z02, *orient));
 
     // Test initial surface types.
 
-    if (const SurfYZLine* from = dynamic_cast<const SurfYZLine*>(&*trk.getSurface())) {
+    const SurfaceVariant from_surf = trk.getSurface()->getVariant();
+    if (const SurfYZLine* from = typedSurface<SurfYZLine>(from_surf)) {
 
       // Initial surface is SurfYZLine.
       // Get surface paramters.
@@ -325,7 +324,7 @@ namespace trkf {
       result = std::make_optional(0.);
       if (!ok) return std::nullopt;
     }
-    else if (const SurfYZPlane* from = dynamic_cast<const SurfYZPlane*>(&*trk.getSurface())) {
+    else if (const SurfYZPlane* from = typedSurface<SurfYZPlane>(from_surf)) {
 
       // Initial surface is SurfYZPlane.
       // Get surface paramters.
@@ -338,7 +337,7 @@ namespace trkf {
       result = std::make_optional(0.);
       if (!ok) return std::nullopt;
     }
-    else if (const SurfXYZPlane* from = dynamic_cast<const SurfXYZPlane*>(&*trk.getSurface())) {
+    else if (const SurfXYZPlane* from = typedSurface<SurfXYZPlane>(from_surf)) {
 
       // Initial surface is SurfXYZPlane.
       // Get surface paramters.
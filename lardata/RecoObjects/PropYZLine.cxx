@@ -61,7 +61,7 @@ namespace trkf {
     // Get destination surface and surface parameters.
     // Return failure if wrong surface type.
 
-    const SurfYZLine* to = dynamic_cast<const SurfYZLine*>(&*psurf);
+    const SurfYZLine* to = typedSurface<SurfYZLine>(psurf->getVariant());
     if (to == 0) return result;
     double x02 = to->x0();
     double y02 = to->y0();
@@ -294,14 +294,15 @@ namespace trkf {
     // Generate the origin surface, which will be the destination surface.
     // Return failure if orientation surface is the wrong type.
 
-    const SurfYZLine* orient = dynamic_cast<const SurfYZLine*>(&*porient);
+    const SurfYZLine* orient = typedSurface<SurfYZLine>(porient->getVariant());
     if (orient == 0) return result;
     double phi2 = orient->phi();
     std::shared_ptr<const Surface> porigin(new SurfYZLine(x02, y02, z02, phi2));
 
     // Test initial surface types.
 
-    if (const SurfYZLine* from = dynamic_cast<const SurfYZLine*>(&*trk.getSurface())) {
+    const SurfaceVariant from_surf = trk.getSurface()->getVariant();
+    if (const SurfYZLine* from = typedSurface<SurfYZLine>(from_surf)) {
 
       // Initial surface is SurfYZLine.
       // Get surface paramters.
@@ -314,7 +315,7 @@ namespace trkf {
       result = std::make_optional(0.);
       if (!ok) return std::nullopt;
     }
-    else if (const SurfYZPlane* from = dynamic_cast<const SurfYZPlane*>(&*trk.getSurface())) {
+    else if (const SurfYZPlane* from = typedSurface<SurfYZPlane>(from_surf)) {
 
       // Initial surface is SurfYZPlane.
       // Get surface paramters.
@@ -327,7 +328,7 @@ namespace trkf {
       result = std::make_optional(0.);
       if (!ok) return std::nullopt;
     }
-    else if (const SurfXYZPlane* from = dynamic_cast<const SurfXYZPlane*>(&*trk.getSurface())) {
+    else if (const SurfXYZPlane* from = typedSurface<SurfXYZPlane>(from_surf)) {
 
       // Initial surface is SurfXYZPlane.
       // Get surface paramters.
@@ -15,6 +15,55 @@
 #include "lardata/RecoObjects/SurfYZLine.h"
 #include "lardata/RecoObjects/SurfYZPlane.h"
 #include <cmath>
+#include <limits>
+
+namespace {
+
+  /// Similarity transform e -> f e f^T of the error matrices of a
+  /// batch of tracks, with one array per matrix element.  Element (i,j)
+  /// of lane l is f[5*i+j][l] for the propagation matrix, and
+  /// e[i*(i+1)/2+j][l] (i >= j) for the error matrix.
+  void similarity_lanes(const std::vector<double> (&f)[25],
+                        std::vector<double> (&e)[trkf::KTrackBatch::NErr],
+                        std::size_t n)
+  {
+    constexpr int N = trkf::KTrackBatch::NPar;
+    auto packed = [](int i, int j) { return (i >= j ? i * (i + 1) / 2 + j : j * (j + 1) / 2 + i); };
+
+    // t = f e.
+
+    std::vector<double> t[N * N];
+    for (int i = 0; i < N; ++i) {
+      for (int j = 0; j < N; ++j) {
+        std::vector<double>& tij = t[N * i + j];
+        tij.assign(n, 0.);
+        for (int k = 0; k < N; ++k) {
+          const double* fik = f[N * i + k].data();
+          const double* ekj = e[packed(k, j)].data();
+          for (std::size_t l = 0; l < n; ++l)
+            tij[l] += fik[l] * ekj[l];
+        }
+      }
+    }
+
+    // e = t f^T (lower triangle).
+
+    for (int i = 0; i < N; ++i) {
+      for (int j = 0; j <= i; ++j) {
+        std::vector<double>& eij = e[packed(i, j)];
+        for (std::size_t l = 0; l < n; ++l)
+          eij[l] = 0.;
+        for (int k = 0; k < N; ++k) {
+          const double* tik = t[N * i + k].data();
+          const double* fjk = f[N * j + k].data();
+          for (std::size_t l = 0; l < n; ++l)
+            eij[l] += tik[l] * fjk[l];
+        }
+      }
+    }
+  }
+
+} // anonymous namespace
 
 namespace trkf {
 
@@ -61,12 +110,11 @@ namespace trkf {
     // Get destination surface and surface parameters.
     // Return failure if wrong surface type.
 
-    const SurfYZPlane* to = dynamic_cast<const SurfYZPlane*>(&*psurf);
+    const SurfYZPlane* to = typedSurface<SurfYZPlane>(psurf->getVariant());
     if (to == 0) return result;
     double x02 = to->x0();
     double y02 = to->y0();
     double z02 = to->z0();
-    double phi2 = to->phi();
 
     // Remember starting track.
 
@@ -109,8 +157,8 @@ namespace trkf {
 
     // Calculate transcendental functions.
 
-    double sinphi2 = std::sin(phi2);
-    double cosphi2 = std::cos(phi2);
+    double sinphi2 = to->sinPhi();
+    double cosphi2 = to->cosPhi();
 
     // Calculate initial position in the destination coordinate
     // system.
@@ -286,14 +334,15 @@ namespace trkf {
     // Generate the origin surface, which will be the destination surface.
     // Return failure if orientation surface is the wrong type.
 
-    const SurfYZPlane* orient = dynamic_cast<const SurfYZPlane*>(&*porient);
+    const SurfYZPlane* orient = typedSurface<SurfYZPlane>(porient->getVariant());
     if (orient == 0) return result;
     double phi2 = orient->phi();
-    std::shared_ptr<const Surface> porigin(new SurfYZPlane(x02, y02, z02, phi2));
+    std::shared_ptr<const Surface> porigin(new SurfYZPlane(x02, y02, z02, *orient));
 
     // Test initial surface types.
 
-    if (const SurfYZLine* from = dynamic_cast<const SurfYZLine*>(&*trk.getSurface())) {
+    const SurfaceVariant from_surf = trk.getSurface()->getVariant();
+    if (const SurfYZLine* from = typedSurface<SurfYZLine>(from_surf)) {
 
       // Initial surface is SurfYZLine.
       // Get surface paramters.
@@ -306,7 +355,7 @@ namespace trkf {
       result = std::make_optional(0.);
       if (!ok) return std::nullopt;
     }
-    else if (const SurfYZPlane* from = dynamic_cast<const SurfYZPlane*>(&*trk.getSurface())) {
+    else if (const SurfYZPlane* from = typedSurface<SurfYZPlane>(from_surf)) {
 
       // Initial surface is SurfYZPlane.
       // Get surface paramters.
@@ -319,7 +368,7 @@ namespace trkf {
       result = std::make_optional(0.);
       if (!ok) return std::nullopt;
     }
-    else if (const SurfXYZPlane* from = dynamic_cast<const SurfXYZPlane*>(&*trk.getSurface())) {
+    else if (const SurfXYZPlane* from = typedSurface<SurfXYZPlane>(from_surf)) {
 
       // Initial surface is SurfXYZPlane.
       // Get surface paramters.
@@ -352,6 +401,264 @@ namespace trkf {
     return result;
   }
 
+  /// Propagate the tracks of a batch on a SurfYZPlane surface together.
+  ///
+  /// Arguments as for Propagator::vec_prop_lanes.
+  ///
+  /// The pending tracks on a SurfYZPlane surface and with a SurfYZPlane
+  /// destination surface are propagated by the same calculation as
+  /// origin_vec_prop (transformYZPlane) followed by short_vec_prop, with
+  /// one array per quantity and the loops over tracks innermost.  Tracks
+  /// with dE/dx which need more than one step (see Propagator::vec_prop)
+  /// are left pending.
+  ///
+  void PropYZPlane::vec_prop_lanes(KTrackBatch& trks,
+                                   const std::vector<std::shared_ptr<const Surface>>& psurfs,
+                                   Propagator::PropDirection dir,
+                                   bool doDedx,
+                                   BatchMode mode,
+                                   std::vector<std::optional<double>>& result,
+                                   std::vector<char>& pending) const
+  {
+    constexpr int NPar = KTrackBatch::NPar;
+    constexpr int NErr = KTrackBatch::NErr;
+    bool const shared = (psurfs.size() == 1);
+
+    // Select the tracks.  Invalid tracks are left to the single track
+    // methods, which reject them.
+
+    std::vector<std::size_t> lanes;
+    lanes.reserve(trks.size());
+    for (std::size_t i = 0; i < trks.size(); ++i) {
+      if (!pending[i] || trks.getDirection(i) == Surface::UNKNOWN) continue;
+      if (!typedSurface<SurfYZPlane>(trks.getSurface(i)->getVariant())) continue;
+      if (!typedSurface<SurfYZPlane>(psurfs[shared ? 0 : i]->getVariant())) continue;
+      bool valid = true;
+      for (int k = 0; k < NPar; ++k)
+        valid = valid && std::isfinite(trks.par(k)[i]);
+      if (valid) lanes.push_back(i);
+    }
+    std::size_t const n = lanes.size();
+    if (n == 0) return;
+
+    // Gather the surface parameters and the track parameters.
+    // Transcendental functions are only recalculated when a surface changes.
+
+    std::vector<double> x01(n), y01(n), z01(n), sinphi1(n), cosphi1(n); // Initial surface.
+    std::vector<double> x02(n), y02(n), z02(n), sinphi2(n), cosphi2(n); // Destination surface.
+    std::vector<double> sindphi(n), cosdphi(n);
+    std::vector<double> u1(n), v1(n), dudw1(n), dvdw1(n), pinv(n);
+    std::vector<double> dir1(n); // +1 (FORWARD) or -1 (BACKWARD).
+
+    const SurfYZPlane* from = 0;
+    const SurfYZPlane* to = 0;
+    double sin_from = 0., cos_from = 0., sin_to = 0., cos_to = 0., sin_d = 0., cos_d = 0.;
+    for (std::size_t l = 0; l < n; ++l) {
+      std::size_t const i = lanes[l];
+      const SurfYZPlane* from_i = static_cast<const SurfYZPlane*>(&*trks.getSurface(i));
+      const SurfYZPlane* to_i = static_cast<const SurfYZPlane*>(&*psurfs[shared ? 0 : i]);
+      if (from_i != from || to_i != to) {
+        from = from_i;
+        to = to_i;
+        sin_from = from->sinPhi();
+        cos_from = from->cosPhi();
+        sin_to = to->sinPhi();
+        cos_to = to->cosPhi();
+        sin_d = 0.;
+        cos_d = 1.;
+        if (to->phi() != from->phi()) {
+          sin_d = std::sin(to->phi() - from->phi());
+          cos_d = std::cos(to->phi() - from->phi());
+        }
+      }
+      x01[l] = from->x0();
+      y01[l] = from->y0();
+      z01[l] = from->z0();
+      sinphi1[l] = sin_from;
+      cosphi1[l] = cos_from;
+      x02[l] = to->x0();
+      y02[l] = to->y0();
+      z02[l] = to->z0();
+      sinphi2[l] = sin_to;
+      cosphi2[l] = cos_to;
+      sindphi[l] = sin_d;
+      cosdphi[l] = cos_d;
+      u1[l] = trks.par(0)[i];
+      v1[l] = trks.par(1)[i];
+      dudw1[l] = trks.par(2)[i];
+      dvdw1[l] = trks.par(3)[i];
+      pinv[l] = trks.par(4)[i];
+      dir1[l] = (trks.getDirection(i) == Surface::FORWARD ? 1. : -1.);
+    }
+
+    // Propagate.
+
+    double const dir_fwd = (dir == Propagator::FORWARD ? 1. : 0.);
+    double const dir_bwd = (dir == Propagator::BACKWARD ? 1. : 0.);
+    double const big = std::numeric_limits<double>::max();
+
+    std::vector<double> xyz0(n), xyz1(n), xyz2(n); // Track position.
+    std::vector<double> u2p(n), v2p(n), dudw2(n), dvdw2(n), dir2(n), s(n);
+    std::vector<char> ok(n);
+
+    // Nonzero propagation matrix elements, other than (0,0) = 1 and
+    // (4,4) = d(pinv2)/d(pinv1).
+    std::vector<double> pm01(n), pm02(n), pm03(n), pm11(n), pm13(n), pm22(n), pm23(n), pm33(n);
+
+    for (std::size_t l = 0; l < n; ++l) {
+
+      // Transform to the origin surface (transformYZPlane).
+
+      double const dw2dw1 = cosdphi[l] - dvdw1[l] * sindphi[l];
+      double const dudw = dudw1[l] / dw2dw1;
+      double const dvdw = (sindphi[l] + dvdw1[l] * cosdphi[l]) / dw2dw1;
+      double const d = (dw2dw1 > 0. ? dir1[l] : -dir1[l]);
+
+      // Track position (SurfYZPlane::getPosition).
+
+      double const x = x01[l] + u1[l];
+      double const y = y01[l] + v1[l] * cosphi1[l];
+      double const z = z01[l] + v1[l] * sinphi1[l];
+
+      // Propagate to the destination surface (short_vec_prop).
+
+      double const u2 = x - x02[l];
+      double const v2 = (y - y02[l]) * cosphi2[l] + (z - z02[l]) * sinphi2[l];
+      double const w2 = -(y - y02[l]) * sinphi2[l] + (z - z02[l]) * cosphi2[l];
+      double const sl = -w2 * std::sqrt(1. + dudw * dudw + dvdw * dvdw);
+      double const sdist = (d < 0. ? -sl : sl);
+
+      // Success: finite track parameters at the origin surface, and
+      // propagation in the requested direction.
+
+      bool const sok = (dir_fwd == 0. && dir_bwd == 0.) || (dir_fwd != 0. && sdist >= 0.) ||
+                       (dir_bwd != 0. && sdist <= 0.);
+      ok[l] = (dw2dw1 != 0.) && (std::abs(dudw) <= big) && (std::abs(dvdw) <= big) && sok;
+
+      xyz0[l] = x;
+      xyz1[l] = y;
+      xyz2[l] = z;
+      u2p[l] = u2 - w2 * dudw;
+      v2p[l] = v2 - w2 * dvdw;
+      dudw2[l] = dudw;
+      dvdw2[l] = dvdw;
+      dir2[l] = d;
+      s[l] = sdist;
+
+      double const p22 = 1. / dw2dw1;
+      double const p23 = dudw1[l] * sindphi[l] / (dw2dw1 * dw2dw1);
+      double const p33 = 1. / (dw2dw1 * dw2dw1);
+      pm01[l] = dudw * sindphi[l];
+      pm02[l] = -w2 * p22;
+      pm03[l] = -w2 * p23;
+      pm11[l] = cosdphi[l] + dvdw * sindphi[l];
+      pm13[l] = -w2 * p33;
+      pm22[l] = p22;
+      pm23[l] = p23;
+      pm33[l] = p33;
+    }
+
+    // Energy loss (one track at a time).  Tracks which would need more
+    // than one step are left pending.
+
+    std::vector<double> pinv2(pinv);
+    std::vector<double> pm44(n, 1.);
+    std::vector<char> multistep(n, 0);
+    if (getDoDedx() && doDedx) {
+      for (std::size_t l = 0; l < n; ++l) {
+        if (!ok[l]) continue;
+        double const mass = trks.Mass(lanes[l]);
+        if (pinv[l] != 0. && std::abs(s[l]) > dedx_max_step(pinv[l], mass)) {
+          multistep[l] = 1;
+          continue;
+        }
+        if (s[l] != 0.) {
+          std::optional<double> const p2 = dedx_prop(pinv[l], mass, s[l], &pm44[l]);
+          if (!p2)
+            ok[l] = 0;
+          else
+            pinv2[l] = *p2;
+        }
+      }
+    }
+
+    // Propagate the error matrix.
+
+    std::vector<double> err[NErr];
+    if (mode != VEC_PROP) {
+      for (int k = 0; k < NErr; ++k) {
+        err[k].resize(n);
+        for (std::size_t l = 0; l < n; ++l)
+          err[k][l] = trks.err(k)[lanes[l]];
+      }
+      std::vector<double> pm[NPar * NPar];
+      for (auto& e : pm)
+        e.assign(n, 0.);
+      pm[0].assign(n, 1.);
+      pm[1] = pm01;
+      pm[2] = pm02;
+      pm[3] = pm03;
+      pm[6] = pm11;
+      pm[8] = pm13;
+      pm[12] = pm22;
+      pm[13] = pm23;
+      pm[18] = pm33;
+      pm[24] = pm44;
+      similarity_lanes(pm, err, n);
+    }
+
+    // Add the noise (one track at a time, on the origin surface).
+
+    if (mode == NOISE_PROP && getInteractor().get() != 0) {
+      TrackError noise_matrix(NPar);
+      for (std::size_t l = 0; l < n; ++l) {
+        if (!ok[l] || multistep[l]) continue;
+        std::size_t const i = lanes[l];
+        const SurfYZPlane* dest = static_cast<const SurfYZPlane*>(&*psurfs[shared ? 0 : i]);
+        TrackVector vec(NPar);
+        vec(0) = 0.;
+        vec(1) = 0.;
+        vec(2) = dudw2[l];
+        vec(3) = dvdw2[l];
+        vec(4) = pinv[l];
+        KTrack trk(std::make_shared<const SurfYZPlane>(xyz0[l], xyz1[l], xyz2[l], dest->phi()),
+                   vec,
+                   (dir2[l] > 0. ? Surface::FORWARD : Surface::BACKWARD),
+                   trks.PdgCode(i));
+        if (!getInteractor()->noise(trk, s[l], noise_matrix)) {
+          ok[l] = 0;
+          continue;
+        }
+        for (int k = 0; k < NErr; ++k)
+          err[k][l] += noise_matrix.data()[k];
+      }
+    }
+
+    // Scatter the results.
+
+    for (std::size_t l = 0; l < n; ++l) {
+      if (multistep[l]) continue;
+      std::size_t const i = lanes[l];
+      pending[i] = 0;
+      if (!ok[l]) {
+        result[i] = std::nullopt;
+        continue;
+      }
+      result[i] = std::make_optional(s[l]);
+      trks.par(0)[i] = u2p[l];
+      trks.par(1)[i] = v2p[l];
+      trks.par(2)[i] = dudw2[l];
+      trks.par(3)[i] = dvdw2[l];
+      trks.par(4)[i] = pinv2[l];
+      trks.setSurface(i, psurfs[shared ? 0 : i]);
+      trks.setDirection(i, (dir2[l] > 0. ? Surface::FORWARD : Surface::BACKWARD));
+      if (mode != VEC_PROP) {
+        for (int k = 0; k < NErr; ++k)
+          trks.err(k)[i] = err[k][l];
+      }
+    }
+  }
+
   // Transform track parameters from SurfYZLine to SurfYZPlane.
 
   bool PropYZPlane::transformYZLine(double phi1,
@@ -362,8 +669,12 @@ namespace trkf {
   {
     // Calculate surface transcendental functions.
 
-    double sindphi = std::sin(phi2 - phi1);
-    double cosdphi = std::cos(phi2 - phi1);
+    double sindphi = 0.;
+    double cosdphi = 1.;
+    if (phi2 != phi1) {
+      sindphi = std::sin(phi2 - phi1);
+      cosdphi = std::cos(phi2 - phi1);
+    }
 
     // Get the initial track parameters.
 
@@ -553,8 +864,12 @@ namespace trkf {
   {
     // Calculate transcendental functions.
 
-    double sindphi = std::sin(phi2 - phi1);
-    double cosdphi = std::cos(phi2 - phi1);
+    double sindphi = 0.;
+    double cosdphi = 1.;
+    if (phi2 != phi1) {
+      sindphi = std::sin(phi2 - phi1);
+      cosdphi = std::cos(phi2 - phi1);
+    }
 
     // Get the initial track parameters.
 
@@ -652,8 +967,12 @@ namespace trkf {
     double sinth1 = std::sin(theta1);
     double costh1 = std::cos(theta1);
 
-    double sindphi = std::sin(phi2 - phi1);
-    double cosdphi = std::cos(phi2 - phi1);
+    double sindphi = 0.;
+    double cosdphi = 1.;
+    if (phi2 != phi1) {
+      sindphi = std::sin(phi2 - phi1);
+      cosdphi = std::cos(phi2 - phi1);
+    }
 
     // Get the initial track state vector and track parameters.
 
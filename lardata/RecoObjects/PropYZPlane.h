@@ -8,6 +8,9 @@
 ///
 /// Class for propagating to a destionation SurfYZPlane surface.
 ///
+/// Batch propagation (see Propagator.h) of tracks on a SurfYZPlane
+/// surface is done for all such tracks together.
+///
 ////////////////////////////////////////////////////////////////////////
 
 #ifndef PROPYZPLANE_H
@@ -41,6 +44,16 @@ namespace trkf {
                                           const std::shared_ptr<const Surface>& porient,
                                           TrackMatrix* prop_matrix = 0) const override;
 
+  protected:
+    /// Propagate the tracks of a batch on a SurfYZPlane surface together.
+    void vec_prop_lanes(KTrackBatch& trks,
+                        const std::vector<std::shared_ptr<const Surface>>& psurfs,
+                        Propagator::PropDirection dir,
+                        bool doDedx,
+                        BatchMode mode,
+                        std::vector<std::optional<double>>& result,
+                        std::vector<char>& pending) const override;
+
   private:
     /// The following methods transform the track parameters from
     /// initial surface to SurfYZPlane origin surface, and generate a
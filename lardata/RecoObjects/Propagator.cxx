@@ -11,6 +11,7 @@
 #include "lardata/RecoObjects/Propagator.h"
 #include "cetlib_except/exception.h"
 #include "larcore/CoreUtils/ServiceUtil.h"
+#include "lardata/RecoObjects/KalmanFixedLinearAlgebra.h"
 #include "lardata/RecoObjects/SurfXYZPlane.h"
 #include "lardataalg/DetectorInfo/DetectorPropertiesData.h"
 
@@ -27,7 +28,11 @@ namespace trkf {
                          double tcut,
                          bool doDedx,
                          const std::shared_ptr<const Interactor>& interactor)
-    : fDetProp{detProp}, fTcut(tcut), fDoDedx(doDedx), fInteractor(interactor)
+    : fDetProp{detProp}
+    , fTcut(tcut)
+    , fDoDedx(doDedx)
+    , fInteractor(interactor)
+    , fElossMedium(detProp)
   {}
 
   /// Destructor.
@@ -126,19 +131,7 @@ namespace trkf {
         // Estimate maximum step distance according to the above
         // stated principle.
 
-        pinv = trk.getVector()(4);
-        double mass = trk.Mass();
-        double p = 1. / std::abs(pinv);
-        double e = std::hypot(p, mass);
-        double t = p * p / (e + mass);
-        double dedx = 0.001 * fDetProp.Eloss(p, mass, fTcut);
-        double smax = 0.1 * t / dedx;
-        if (smax <= 0.)
-          throw cet::exception("Propagator") << __func__ << ": maximum step " << smax << "\n";
-
-        // Always allow a step of at least 0.3 cm (about one wire spacing).
-
-        if (smax < 0.3) smax = 0.3;
+        double smax = dedx_max_step(trk.getVector()(4), trk.Mass());
 
         // First do a test propagation (without dE/dx and errors) to
         // find the distance to the destination surface.
@@ -213,9 +206,12 @@ namespace trkf {
         // Update cumulative noise matrix.
 
         if (noise_matrix != 0) {
-          TrackMatrix temp = prod(*noise_matrix, trans(*plocal_prop_matrix));
-          TrackMatrix temp2 = prod(*plocal_prop_matrix, temp);
-          *noise_matrix = ublas::symmetric_adaptor<TrackMatrix>(temp2);
+          if (!UseFixedKalmanAlgebra ||
+              !fixed::trySimilarity(*plocal_prop_matrix, *noise_matrix)) {
+            TrackMatrix temp = prod(*noise_matrix, trans(*plocal_prop_matrix));
+            TrackMatrix temp2 = prod(*plocal_prop_matrix, temp);
+            *noise_matrix = ublas::symmetric_adaptor<TrackMatrix>(temp2);
+          }
           *noise_matrix += *plocal_noise_matrix;
         }
       }
@@ -356,9 +352,12 @@ namespace trkf {
     // If propagation succeeded, update track error matrix.
 
     if (!!result) {
-      TrackMatrix temp = prod(tre.getError(), trans(*prop_matrix));
-      TrackMatrix temp2 = prod(*prop_matrix, temp);
-      TrackError newerr = ublas::symmetric_adaptor<TrackMatrix>(temp2);
+      TrackError newerr = tre.getError();
+      if (!UseFixedKalmanAlgebra || !fixed::trySimilarity(*prop_matrix, newerr)) {
+        TrackMatrix temp = prod(tre.getError(), trans(*prop_matrix));
+        TrackMatrix temp2 = prod(*prop_matrix, temp);
+        newerr = ublas::symmetric_adaptor<TrackMatrix>(temp2);
+      }
       tre.setError(newerr);
     }
 
@@ -395,9 +394,12 @@ namespace trkf {
     // If propagation succeeded, update track error matrix.
 
     if (!!result) {
-      TrackMatrix temp = prod(tre.getError(), trans(prop_matrix));
-      TrackMatrix temp2 = prod(prop_matrix, temp);
-      TrackError newerr = ublas::symmetric_adaptor<TrackMatrix>(temp2);
+      TrackError newerr = tre.getError();
+      if (!UseFixedKalmanAlgebra || !fixed::trySimilarity(prop_matrix, newerr)) {
+        TrackMatrix temp = prod(tre.getError(), trans(prop_matrix));
+        TrackMatrix temp2 = prod(prop_matrix, temp);
+        newerr = ublas::symmetric_adaptor<TrackMatrix>(temp2);
+      }
       newerr += noise_matrix;
       tre.setError(newerr);
     }
@@ -429,7 +431,7 @@ namespace trkf {
   /// dE/dx = -f(E)
   ///
   /// where f(E) is the stopping power returned by method
-  /// LArProperties::Eloss.
+  /// DetectorPropertiesData::Eloss (tabulated, see ElossTable.h).
   ///
   /// We expect that this method will be called exclusively for short
   /// distance propagation.  The differential equation is solved using
@@ -462,11 +464,11 @@ namespace trkf {
 
     double p1 = 1. / std::abs(pinv);
     double e1 = std::hypot(p1, mass);
-    double de = -0.001 * s * fDetProp.Eloss(p1, mass, fTcut);
+    double de = -0.001 * s * eloss(p1, mass);
     double emid = e1 + 0.5 * de;
     if (emid > mass) {
       double pmid = std::sqrt(emid * emid - mass * mass);
-      double e2 = e1 - 0.001 * s * fDetProp.Eloss(pmid, mass, fTcut);
+      double e2 = e1 - 0.001 * s * eloss(pmid, mass);
       if (e2 > mass) {
         double p2 = std::sqrt(e2 * e2 - mass * mass);
         double pinv2 = 1. / p2;
@@ -486,4 +488,161 @@ namespace trkf {
 
     return result;
   }
+
+  /// Maximum step length of long distance propagation with dE/dx.
+  ///
+  /// Arguments:
+  ///
+  /// pinv - Initial inverse momentum (nonzero).
+  /// mass - Particle mass.
+  ///
+  /// Returned value: maximum step length (cm).
+  ///
+  /// The step is limited such that the kinetic energy of the particle
+  /// should not change by more than 10%, but a step of at least 0.3 cm
+  /// (about one wire spacing) is always allowed.
+  ///
+  double Propagator::dedx_max_step(double pinv, double mass) const
+  {
+    double p = 1. / std::abs(pinv);
+    double e = std::hypot(p, mass);
+    double t = p * p / (e + mass);
+    double dedx = 0.001 * eloss(p, mass);
+    double smax = 0.1 * t / dedx;
+    if (smax <= 0.)
+      throw cet::exception("Propagator") << __func__ << ": maximum step " << smax << "\n";
+    if (smax < 0.3) smax = 0.3;
+    return smax;
+  }
+
+  /// Mean energy loss (MeV/cm) at momentum p (GeV/c).
+  double Propagator::eloss(double p, double mass) const
+  {
+    if (fExactEloss) return fDetProp.Eloss(p, mass, fTcut);
+    return ElossTable::Get(fElossMedium, mass, fTcut).Eloss(p);
+  }
+
+  /// Propagate a batch of tracks without error (long distance).
+  ///
+  /// Arguments:
+  ///
+  /// trks   - Tracks to propagate.
+  /// psurfs - Destination surfaces (one per track, or one for all tracks).
+  /// dir    - Propagation direction (FORWARD, BACKWARD, or UNKNOWN).
+  /// doDedx - dE/dx enable/disable flag.
+  ///
+  /// Returned value: propagation distance + success flag of each track.
+  ///
+  /// Each track is propagated as by the single track vec_prop.
+  ///
+  std::vector<std::optional<double>> Propagator::vec_prop(
+    KTrackBatch& trks,
+    const std::vector<std::shared_ptr<const Surface>>& psurfs,
+    PropDirection dir,
+    bool doDedx) const
+  {
+    return batch_prop(trks, psurfs, dir, doDedx, VEC_PROP);
+  }
+
+  /// Propagate a batch of tracks with error, but without noise.
+  ///
+  /// Arguments as for the batch vec_prop.  The batch must have errors.
+  ///
+  /// Each track is propagated as by the single track err_prop.
+  ///
+  std::vector<std::optional<double>> Propagator::err_prop(
+    KTrackBatch& trks,
+    const std::vector<std::shared_ptr<const Surface>>& psurfs,
+    PropDirection dir,
+    bool doDedx) const
+  {
+    return batch_prop(trks, psurfs, dir, doDedx, ERR_PROP);
+  }
+
+  /// Propagate a batch of tracks with error and noise.
+  ///
+  /// Arguments as for the batch vec_prop.  The batch must have errors.
+  ///
+  /// Each track is propagated as by the single track noise_prop.
+  ///
+  std::vector<std::optional<double>> Propagator::noise_prop(
+    KTrackBatch& trks,
+    const std::vector<std::shared_ptr<const Surface>>& psurfs,
+    PropDirection dir,
+    bool doDedx) const
+  {
+    return batch_prop(trks, psurfs, dir, doDedx, NOISE_PROP);
+  }
+
+  /// Propagate some tracks of a batch together (long distance).
+  ///
+  /// Arguments:
+  ///
+  /// trks    - Tracks to propagate.
+  /// psurfs  - Destination surfaces (one per track, or one for all tracks).
+  /// dir     - Propagation direction (FORWARD, BACKWARD, or UNKNOWN).
+  /// doDedx  - dE/dx enable/disable flag.
+  /// mode    - Also propagate error (ERR_PROP), and add noise (NOISE_PROP).
+  /// result  - Propagation distance + success flag of each track.
+  /// pending - Flag of the tracks not yet propagated.
+  ///
+  /// An implementation propagates any pending track it supports, storing
+  /// the propagated track in trks (on success only) and the result in
+  /// result, and then clears the pending flag of the track.  The
+  /// remaining pending tracks are propagated by the single track methods.
+  ///
+  /// This default implementation does not propagate any track.
+  ///
+  void Propagator::vec_prop_lanes(KTrackBatch& /* trks */,
+                                  const std::vector<std::shared_ptr<const Surface>>& /* psurfs */,
+                                  PropDirection /* dir */,
+                                  bool /* doDedx */,
+                                  BatchMode /* mode */,
+                                  std::vector<std::optional<double>>& /* result */,
+                                  std::vector<char>& /* pending */) const
+  {}
+
+  /// Common implementation of the batch methods.
+  std::vector<std::optional<double>> Propagator::batch_prop(
+    KTrackBatch& trks,
+    const std::vector<std::shared_ptr<const Surface>>& psurfs,
+    PropDirection dir,
+    bool doDedx,
+    BatchMode mode) const
+  {
+    std::size_t const n = trks.size();
+    if (psurfs.size() != 1 && psurfs.size() != n)
+      throw cet::exception("Propagator")
+        << __func__ << ": " << psurfs.size() << " destination surfaces for " << n << " tracks\n";
+    if (mode != VEC_PROP && !trks.hasError())
+      throw cet::exception("Propagator") << __func__ << ": track batch without errors\n";
+
+    std::vector<std::optional<double>> result(n);
+    std::vector<char> pending(n, 1);
+    if (n == 0) return result;
+
+    // Propagate the tracks supported by the derived class together.
+
+    vec_prop_lanes(trks, psurfs, dir, doDedx, mode, result, pending);
+
+    // Propagate the other tracks one at a time.
+
+    for (std::size_t i = 0; i < n; ++i) {
+      if (!pending[i]) continue;
+      const std::shared_ptr<const Surface>& psurf = psurfs[psurfs.size() == 1 ? 0 : i];
+      if (mode == VEC_PROP) {
+        KTrack trk = trks.getTrack(i);
+        result[i] = vec_prop(trk, psurf, dir, doDedx);
+        if (!!result[i]) trks.setTrack(i, trk);
+      }
+      else {
+        KETrack tre = trks.getETrack(i);
+        result[i] = (mode == ERR_PROP ? err_prop(tre, psurf, dir, doDedx) :
+                                        noise_prop(tre, psurf, dir, doDedx));
+        if (!!result[i]) trks.setETrack(i, tre);
+      }
+    }
+
+    return result;
+  }
 } // end namespace trkf
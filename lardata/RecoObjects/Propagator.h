@@ -64,20 +64,35 @@
 /// Calculation of dE/dx can be enabled or disabled by a flag passed to
 /// the constructor, as well as by a flag passed to individual
 /// propagation methods.  Nonzero energy loss will take place only if
-/// both flags are true.
+/// both flags are true.  The energy loss per unit length is taken from
+/// a table (see ElossTable.h), or, in exact mode (setExactEloss), from
+/// DetectorPropertiesData::Eloss.  The medium of the tables is
+/// identified when the propagator is constructed.
 ///
 /// Method origin_vec_prop always returns a propgation distance of
 /// zero (if successful).  Origin propagation does not calculate noise
 /// (noise is zero by definition).  Origin propagation does not accept
 /// or need a propgation direction or dE/dx flag.
 ///
+/// The batch versions of vec_prop, err_prop and noise_prop propagate
+/// all the tracks of a KTrackBatch, each to its own destination surface
+/// or all to the same one, and return the propagation distance + success
+/// flag of each track.  Derived classes may override virtual method
+/// vec_prop_lanes to propagate the tracks they support together, with
+/// loops over the tracks in the innermost position.  Tracks that are not
+/// propagated there are propagated one at a time by the single track
+/// methods.  Either way the result is that of the single track method
+/// (without reference track).
+///
 ////////////////////////////////////////////////////////////////////////
 
 #ifndef PROPAGATOR_H
 #define PROPAGATOR_H
 
+#include "lardata/RecoObjects/ElossTable.h"
 #include "lardata/RecoObjects/Interactor.h"
 #include "lardata/RecoObjects/KETrack.h"
+#include "lardata/RecoObjects/KTrackBatch.h"
 #include "lardata/RecoObjects/KalmanLinearAlgebra.h"
 namespace detinfo {
   class DetectorPropertiesData;
@@ -85,6 +100,7 @@ namespace detinfo {
 
 #include <memory>
 #include <optional>
+#include <vector>
 
 namespace trkf {
 
@@ -107,6 +123,12 @@ namespace trkf {
     double getTcut() const { return fTcut; }
     bool getDoDedx() const { return fDoDedx; }
     const std::shared_ptr<const Interactor>& getInteractor() const { return fInteractor; }
+    bool getExactEloss() const { return fExactEloss; }
+
+    // Modifiers.
+
+    /// Use DetectorPropertiesData::Eloss instead of the dE/dx table (for validation).
+    void setExactEloss(bool exact) { fExactEloss = exact; }
 
     // Virtual methods.
 
@@ -160,11 +182,63 @@ namespace trkf {
     /// Method to calculate updated momentum due to dE/dx.
     std::optional<double> dedx_prop(double pinv, double mass, double s, double* deriv = 0) const;
 
+    // Batch methods.
+
+    /// Propagate a batch of tracks without error (long distance).
+    std::vector<std::optional<double>> vec_prop(
+      KTrackBatch& trks,
+      const std::vector<std::shared_ptr<const Surface>>& psurfs,
+      PropDirection dir,
+      bool doDedx) const;
+
+    /// Propagate a batch of tracks with error, but without noise.
+    std::vector<std::optional<double>> err_prop(
+      KTrackBatch& trks,
+      const std::vector<std::shared_ptr<const Surface>>& psurfs,
+      PropDirection dir,
+      bool doDedx) const;
+
+    /// Propagate a batch of tracks with error and noise.
+    std::vector<std::optional<double>> noise_prop(
+      KTrackBatch& trks,
+      const std::vector<std::shared_ptr<const Surface>>& psurfs,
+      PropDirection dir,
+      bool doDedx) const;
+
+  protected:
+    /// Batch propagation type (what is updated besides the state vector).
+    enum BatchMode { VEC_PROP, ERR_PROP, NOISE_PROP };
+
+    /// Propagate some tracks of a batch together (long distance).
+    virtual void vec_prop_lanes(KTrackBatch& trks,
+                                const std::vector<std::shared_ptr<const Surface>>& psurfs,
+                                PropDirection dir,
+                                bool doDedx,
+                                BatchMode mode,
+                                std::vector<std::optional<double>>& result,
+                                std::vector<char>& pending) const;
+
+    /// Maximum step length of long distance propagation with dE/dx.
+    double dedx_max_step(double pinv, double mass) const;
+
   private:
+    /// Mean energy loss (MeV/cm) at momentum p.
+    double eloss(double p, double mass) const;
+
+    /// Common implementation of the batch methods.
+    std::vector<std::optional<double>> batch_prop(
+      KTrackBatch& trks,
+      const std::vector<std::shared_ptr<const Surface>>& psurfs,
+      PropDirection dir,
+      bool doDedx,
+      BatchMode mode) const;
+
     detinfo::DetectorPropertiesData const& fDetProp;
     double fTcut;                                  ///< Maximum delta ray energy for dE/dx.
     bool fDoDedx;                                  ///< Energy loss enable flag.
     std::shared_ptr<const Interactor> fInteractor; ///< Interactor (for calculating noise).
+    bool fExactEloss = false;                      ///< Do not use the dE/dx table.
+    ElossTable::Medium fElossMedium;               ///< Medium of the dE/dx tables.
   };
 }
 
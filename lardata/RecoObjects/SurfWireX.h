@@ -8,7 +8,8 @@
 ///
 /// This class derives from SurfYZPlane.  This class does not add any
 /// new members, but has a constructor that allows construction from
-/// a wire id.
+/// a wire id.  Class SurfaceRegistry provides one shared SurfWireX
+/// surface per wire.
 ///
 ////////////////////////////////////////////////////////////////////////
 
@@ -22,7 +22,10 @@ namespace trkf {
   double SurfXYZPlane::fSepTolerance = 1.e-6;
 
   /// Default constructor.
-  SurfXYZPlane::SurfXYZPlane() : fX0(0.), fY0(0.), fZ0(0.), fPhi(0.), fTheta(0.) {}
+  SurfXYZPlane::SurfXYZPlane() : fX0(0.), fY0(0.), fZ0(0.), fPhi(0.), fTheta(0.)
+  {
+    setRotation();
+  }
 
   /// Initializing constructor.
   ///
@@ -34,7 +37,9 @@ namespace trkf {
   ///
   SurfXYZPlane::SurfXYZPlane(double x0, double y0, double z0, double phi, double theta)
     : fX0(x0), fY0(y0), fZ0(z0), fPhi(phi), fTheta(theta)
-  {}
+  {
+    setRotation();
+  }
 
   /// Initializing constructor (normal vector).
   ///
@@ -52,11 +57,36 @@ namespace trkf {
     fTheta = atan2(nx, nyz);
     fPhi = 0.;
     if (nyz != 0.) fPhi = atan2(-ny, nz);
+    setRotation();
+  }
+
+  /// Initializing constructor (orientation of another surface).
+  ///
+  /// Arguments:
+  ///
+  /// x0, y0, z0 - Global coordinates of local origin.
+  /// orient - Surface with the same orientation.
+  ///
+  SurfXYZPlane::SurfXYZPlane(double x0, double y0, double z0, const SurfXYZPlane& orient)
+    : SurfXYZPlane(orient)
+  {
+    fX0 = x0;
+    fY0 = y0;
+    fZ0 = z0;
   }
 
   /// Destructor.
   SurfXYZPlane::~SurfXYZPlane() {}
 
+  /// Update cached rotation constants.
+  void SurfXYZPlane::setRotation()
+  {
+    fSinPhi = std::sin(fPhi);
+    fCosPhi = std::cos(fPhi);
+    fSinTheta = std::sin(fTheta);
+    fCosTheta = std::cos(fTheta);
+  }
+
   /// Clone method.
   Surface* SurfXYZPlane::clone() const { return new SurfXYZPlane(*this); }
 
@@ -72,10 +102,10 @@ namespace trkf {
   ///
   void SurfXYZPlane::toLocal(const double xyz[3], double uvw[3]) const
   {
-    double sinth = std::sin(fTheta);
-    double costh = std::cos(fTheta);
-    double sinphi = std::sin(fPhi);
-    double cosphi = std::cos(fPhi);
+    double sinth = fSinTheta;
+    double costh = fCosTheta;
+    double sinphi = fSinPhi;
+    double cosphi = fCosPhi;
 
     // u = (x-x0)*cos(theta) + (y-y0)*sin(theta)*sin(phi) - (z-z0)*sin(theta)*cos(phi)
     uvw[0] =
@@ -98,10 +128,10 @@ namespace trkf {
   ///
   void SurfXYZPlane::toGlobal(const double uvw[3], double xyz[3]) const
   {
-    double sinth = std::sin(fTheta);
-    double costh = std::cos(fTheta);
-    double sinphi = std::sin(fPhi);
-    double cosphi = std::cos(fPhi);
+    double sinth = fSinTheta;
+    double costh = fCosTheta;
+    double sinphi = fSinPhi;
+    double cosphi = fCosPhi;
 
     // x = x0 + u*cos(theta)                       + w*sin(theta)
     xyz[0] = fX0 + uvw[0] * costh + uvw[2] * sinth;
@@ -173,10 +203,10 @@ namespace trkf {
 
     // Rotate momentum to global coordinte system.
 
-    double sinth = std::sin(fTheta);
-    double costh = std::cos(fTheta);
-    double sinphi = std::sin(fPhi);
-    double cosphi = std::cos(fPhi);
+    double sinth = fSinTheta;
+    double costh = fCosTheta;
+    double sinphi = fSinPhi;
+    double cosphi = fCosPhi;
 
     mom[0] = pu * costh + pw * sinth;
     mom[1] = pu * sinth * sinphi + pv * cosphi - pw * costh * sinphi;
@@ -197,6 +227,8 @@ namespace trkf {
   ///
   bool SurfXYZPlane::isParallel(const Surface& surf) const
   {
+    if (&surf == this) return true;
+
     bool result = false;
 
     // Test if the other surface is a SurfXYZPlane.
@@ -230,6 +262,8 @@ namespace trkf {
   ///
   double SurfXYZPlane::distanceTo(const Surface& surf) const
   {
+    if (&surf == this) return 0.;
+
     // Check if the other surface is parallel to this one.
 
     bool parallel = isParallel(surf);
@@ -263,6 +297,8 @@ namespace trkf {
   ///
   bool SurfXYZPlane::isEqual(const Surface& surf) const
   {
+    if (&surf == this) return true;
+
     bool result = false;
 
     // Test if the other surface is parallel.
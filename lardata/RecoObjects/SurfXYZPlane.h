@@ -91,6 +91,9 @@ namespace trkf {
     /// Initializing constructor (normal vector).
     SurfXYZPlane(double x0, double y0, double z0, double nx, double ny, double nz);
 
+    /// Initializing constructor (orientation of another surface).
+    SurfXYZPlane(double x0, double y0, double z0, const SurfXYZPlane& orient);
+
     /// Destructor.
     virtual ~SurfXYZPlane();
 
@@ -101,6 +104,11 @@ namespace trkf {
     double phi() const { return fPhi; }     ///< Rot. angle about x-axis (wire angle).
     double theta() const { return fTheta; } ///< Rot. angle about y'-axis (projected Lorentz angle).
 
+    double sinPhi() const { return fSinPhi; }     ///< sin(phi).
+    double cosPhi() const { return fCosPhi; }     ///< cos(phi).
+    double sinTheta() const { return fSinTheta; } ///< sin(theta).
+    double cosTheta() const { return fCosTheta; } ///< cos(theta).
+
     /// Clone method.
     virtual Surface* clone() const;
 
@@ -133,6 +141,9 @@ namespace trkf {
     /// Printout
     virtual std::ostream& Print(std::ostream& out) const;
 
+    /// Typed pointer to this surface.
+    virtual SurfaceVariant getVariant() const { return this; }
+
   private:
     // Static attributes.
 
@@ -147,6 +158,16 @@ namespace trkf {
     double fZ0;    ///< Z origin.
     double fPhi;   ///< Rotation angle about x-axis (wire angle).
     double fTheta; ///< Rotation angle about y'-axis (projected Lorentz angle).
+
+    // Cached rotation constants.
+
+    double fSinPhi;   ///< sin(phi).
+    double fCosPhi;   ///< cos(phi).
+    double fSinTheta; ///< sin(theta).
+    double fCosTheta; ///< cos(theta).
+
+    /// Update cached rotation constants.
+    void setRotation();
   };
 }
 
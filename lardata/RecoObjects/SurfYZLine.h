@@ -127,6 +127,9 @@ namespace trkf {
     /// Printout
     virtual std::ostream& Print(std::ostream& out) const;
 
+    /// Typed pointer to this surface.
+    virtual SurfaceVariant getVariant() const { return this; }
+
   private:
     // Static attributes.
 
@@ -21,7 +21,7 @@ namespace trkf {
   double SurfYZPlane::fSepTolerance = 1.e-6;
 
   /// Default constructor.
-  SurfYZPlane::SurfYZPlane() : fX0(0.), fY0(0.), fZ0(0.), fPhi(0.) {}
+  SurfYZPlane::SurfYZPlane() : fX0(0.), fY0(0.), fZ0(0.), fPhi(0.), fSinPhi(0.), fCosPhi(1.) {}
 
   /// Initializing constructor.
   ///
@@ -31,7 +31,18 @@ namespace trkf {
   /// phi - Rotation angle about x-axis.
   ///
   SurfYZPlane::SurfYZPlane(double x0, double y0, double z0, double phi)
-    : fX0(x0), fY0(y0), fZ0(z0), fPhi(phi)
+    : fX0(x0), fY0(y0), fZ0(z0), fPhi(phi), fSinPhi(std::sin(phi)), fCosPhi(std::cos(phi))
+  {}
+
+  /// Initializing constructor (orientation of another surface).
+  ///
+  /// Arguments:
+  ///
+  /// x0, y0, z0 - Global coordinates of local origin.
+  /// orient - Surface with the same orientation.
+  ///
+  SurfYZPlane::SurfYZPlane(double x0, double y0, double z0, const SurfYZPlane& orient)
+    : fX0(x0), fY0(y0), fZ0(z0), fPhi(orient.fPhi), fSinPhi(orient.fSinPhi), fCosPhi(orient.fCosPhi)
   {}
 
   /// Destructor.
@@ -52,8 +63,8 @@ namespace trkf {
   ///
   void SurfYZPlane::toLocal(const double xyz[3], double uvw[3]) const
   {
-    double sinphi = std::sin(fPhi);
-    double cosphi = std::cos(fPhi);
+    double sinphi = fSinPhi;
+    double cosphi = fCosPhi;
 
     // u = x-x0
     uvw[0] = xyz[0] - fX0;
@@ -74,8 +85,8 @@ namespace trkf {
   ///
   void SurfYZPlane::toGlobal(const double uvw[3], double xyz[3]) const
   {
-    double sinphi = std::sin(fPhi);
-    double cosphi = std::cos(fPhi);
+    double sinphi = fSinPhi;
+    double cosphi = fCosPhi;
 
     // x = x0 + u
     xyz[0] = fX0 + uvw[0];
@@ -147,8 +158,8 @@ namespace trkf {
 
     // Rotate momentum to global coordinte system.
 
-    double sinphi = std::sin(fPhi);
-    double cosphi = std::cos(fPhi);
+    double sinphi = fSinPhi;
+    double cosphi = fCosPhi;
 
     mom[0] = pu;
     mom[1] = pv * cosphi - pw * sinphi;
@@ -169,6 +180,10 @@ namespace trkf {
   ///
   bool SurfYZPlane::isParallel(const Surface& surf) const
   {
+    // A surface is parallel to itself (interned surfaces, see SurfaceRegistry).
+
+    if (&surf == this) return true;
+
     bool result = false;
 
     // Test if the other surface is a SurfYZPlane.
@@ -200,6 +215,8 @@ namespace trkf {
   ///
   double SurfYZPlane::distanceTo(const Surface& surf) const
   {
+    if (&surf == this) return 0.;
+
     // Check if the other surface is parallel to this one.
 
     bool parallel = isParallel(surf);
@@ -233,6 +250,8 @@ namespace trkf {
   ///
   bool SurfYZPlane::isEqual(const Surface& surf) const
   {
+    if (&surf == this) return true;
+
     bool result = false;
 
     // Test if the other surface is a SurfYZPlane.
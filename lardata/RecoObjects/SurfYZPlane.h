@@ -51,14 +51,19 @@ namespace trkf {
     /// Initializing constructor.
     SurfYZPlane(double x0, double y0, double z0, double phi);
 
+    /// Initializing constructor (orientation of another surface).
+    SurfYZPlane(double x0, double y0, double z0, const SurfYZPlane& orient);
+
     /// Destructor.
     virtual ~SurfYZPlane();
 
     // Accessors.
-    double x0() const { return fX0; }   ///< X origin.
-    double y0() const { return fY0; }   ///< Y origin.
-    double z0() const { return fZ0; }   ///< Z origin.
-    double phi() const { return fPhi; } ///< Rotation angle about x-axis.
+    double x0() const { return fX0; }         ///< X origin.
+    double y0() const { return fY0; }         ///< Y origin.
+    double z0() const { return fZ0; }         ///< Z origin.
+    double phi() const { return fPhi; }       ///< Rotation angle about x-axis.
+    double sinPhi() const { return fSinPhi; } ///< sin(phi).
+    double cosPhi() const { return fCosPhi; } ///< cos(phi).
 
     /// Clone method.
     virtual Surface* clone() const;
@@ -92,6 +97,9 @@ namespace trkf {
     /// Printout
     virtual std::ostream& Print(std::ostream& out) const;
 
+    /// Typed pointer to this surface.
+    virtual SurfaceVariant getVariant() const { return this; }
+
   private:
     // Static attributes.
 
@@ -104,6 +112,11 @@ namespace trkf {
     double fY0;  ///< Y origin.
     double fZ0;  ///< Z origin.
     double fPhi; ///< Rotation angle about x-axis.
+
+    // Cached rotation constants.
+
+    double fSinPhi; ///< sin(phi).
+    double fCosPhi; ///< cos(phi).
   };
 }
 
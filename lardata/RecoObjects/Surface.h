@@ -38,6 +38,12 @@
 /// This class doesn't have any attributes of its own, but it provides
 /// several virtual methods that derived classes can or must override.
 ///
+/// Method getVariant returns a pointer to the surface as one of the
+/// surface types known to the propagators (SurfYZLine, SurfYZPlane,
+/// SurfXYZPlane, including derived classes), held in a std::variant.
+/// Propagators dispatch on the variant (std::visit or typedSurface)
+/// instead of testing the surface type with dynamic_cast.
+///
 ////////////////////////////////////////////////////////////////////////
 
 #ifndef SURFACE_H
@@ -45,9 +51,18 @@
 
 #include "lardata/RecoObjects/KalmanLinearAlgebra.h"
 #include <iosfwd>
+#include <variant>
 
 namespace trkf {
 
+  class SurfYZLine;
+  class SurfYZPlane;
+  class SurfXYZPlane;
+
+  /// Typed pointer to a surface (std::monostate for other surface types).
+  using SurfaceVariant =
+    std::variant<std::monostate, const SurfYZLine*, const SurfYZPlane*, const SurfXYZPlane*>;
+
   class Surface {
   public:
     /// Track direction enum.
@@ -108,8 +123,19 @@ namespace trkf {
 
     /// Printout
     virtual std::ostream& Print(std::ostream& out) const = 0;
+
+    /// Typed pointer to this surface (default std::monostate).
+    virtual SurfaceVariant getVariant() const { return std::monostate{}; }
   };
 
+  /// Surface held by a SurfaceVariant if it has type T, otherwise null.
+  template <class T>
+  const T* typedSurface(const SurfaceVariant& surf)
+  {
+    const T* const* psurf = std::get_if<const T*>(&surf);
+    return psurf ? *psurf : nullptr;
+  }
+
   /// Output operator.
   std::ostream& operator<<(std::ostream& out, const Surface& surf);
 }
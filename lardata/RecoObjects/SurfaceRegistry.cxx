@@ -0,0 +1,88 @@
+///////////////////////////////////////////////////////////////////////
+///
+/// \file   SurfaceRegistry.cxx
+///
+/// \brief  Shared surfaces for readout wires.
+///
+////////////////////////////////////////////////////////////////////////
+
+#include "lardata/RecoObjects/SurfaceRegistry.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "larcore/Geometry/Geometry.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+namespace {
+
+  // Surfaces are looked up under a shared lock, so that threads finding
+  // their surface in the registry don't wait for each other; the lock is
+  // exclusive only to add a surface or to change geometry.
+  std::shared_mutex registryMutex;
+  std::map<geo::WireID, std::shared_ptr<const trkf::SurfWireX>> wireSurfaces;
+
+  // Geometry the surfaces in the registry were made from.
+  std::string registryDetector;
+  std::string registryGDMLFile;
+
+  // Whether the registry was filled with the geometry geom.
+  bool sameGeometry(const geo::Geometry& geom)
+  {
+    return registryDetector == geom.DetectorName() && registryGDMLFile == geom.GDMLFile();
+  }
+
+} // anonymous namespace
+
+namespace trkf {
+
+  /// Shared surface of a wire.
+  ///
+  /// Arguments:
+  ///
+  /// wireid - Wire id.
+  ///
+  /// If the geometry is not the one the registry was filled with
+  /// (different detector name or GDML file), the registry is cleared first.
+  ///
+  std::shared_ptr<const SurfWireX> SurfaceRegistry::getWireX(const geo::WireID& wireid)
+  {
+    art::ServiceHandle<geo::Geometry const> geom;
+    {
+      std::shared_lock<std::shared_mutex> lock(registryMutex);
+      if (sameGeometry(*geom)) {
+        auto const iSurf = wireSurfaces.find(wireid);
+        if (iSurf != wireSurfaces.end()) return iSurf->second;
+      }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(registryMutex);
+    if (!sameGeometry(*geom)) {
+      wireSurfaces.clear();
+      registryDetector = geom->DetectorName();
+      registryGDMLFile = geom->GDMLFile();
+    }
+    std::shared_ptr<const SurfWireX>& psurf = wireSurfaces[wireid];
+    if (!psurf) psurf = std::make_shared<const SurfWireX>(wireid);
+    return psurf;
+  }
+
+  /// Number of surfaces in the registry.
+  std::size_t SurfaceRegistry::size()
+  {
+    std::shared_lock<std::shared_mutex> lock(registryMutex);
+    return wireSurfaces.size();
+  }
+
+  /// Forget all surfaces.
+  void SurfaceRegistry::clear()
+  {
+    std::unique_lock<std::shared_mutex> lock(registryMutex);
+    wireSurfaces.clear();
+    registryDetector.clear();
+    registryGDMLFile.clear();
+  }
+
+} // end namespace trkf
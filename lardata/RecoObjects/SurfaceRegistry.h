@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////
+///
+/// \file   SurfaceRegistry.h
+///
+/// \brief  Shared surfaces for readout wires.
+///
+/// Class SurfaceRegistry interns SurfWireX surfaces by wire id: the
+/// surface of a wire is made from the geometry the first time it is
+/// requested, and the same surface object is returned afterwards.
+///
+/// Measurements on the same wire (KHitWireX) thus share one surface
+/// object, across KHitGroups and events.  Sharing makes surface
+/// comparisons cheap, because the surface classes test for identity
+/// before comparing parameters, and it saves the geometry lookups and
+/// the memory of one surface per measurement.
+///
+/// Surfaces are kept until the end of the job, until method clear is
+/// called, or until the geometry changes: the registry remembers the
+/// detector name and GDML file of the geometry its surfaces were made
+/// from, and it starts over when a surface is requested with a different
+/// geometry.  Surfaces already handed out stay valid.
+///
+/// The methods of this class are thread safe.  Lookups of surfaces
+/// already in the registry (the common case, once the wires of the
+/// detector have been seen) take a shared lock and do not wait for each
+/// other; only the creation of a new surface takes an exclusive lock.
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef SURFACEREGISTRY_H
+#define SURFACEREGISTRY_H
+
+#include "lardata/RecoObjects/SurfWireX.h"
+#include <cstddef>
+#include <memory>
+
+namespace trkf {
+
+  class SurfaceRegistry {
+  public:
+    /// Shared surface of wire wireid.
+    static std::shared_ptr<const SurfWireX> getWireX(const geo::WireID& wireid);
+
+    /// Number of surfaces in the registry.
+    static std::size_t size();
+
+    /// Forget all surfaces.
+    static void clear();
+  };
+}
+
+#endif
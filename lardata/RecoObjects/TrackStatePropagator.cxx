@@ -13,13 +13,15 @@ namespace trkf {
                                              int maxNit,
                                              double tcut,
                                              double wrongDirDistTolerance,
-                                             bool propPinvErr)
+                                             bool propPinvErr,
+                                             bool exactEloss)
     : fMinStep(minStep)
     , fMaxElossFrac(maxElossFrac)
     , fMaxNit(maxNit)
     , fTcut(tcut)
     , fWrongDirDistTolerance(wrongDirDistTolerance)
     , fPropPinvErr(propPinvErr)
+    , fExactEloss(exactEloss)
   {
     larprop = lar::providerFrom<detinfo::LArPropertiesService>();
   }
@@ -66,57 +68,21 @@ namespace trkf {
     pm(1, 3) = sperp;                             // dv2/d(dvdw1);
     //
     // 5- apply material effects, performing more iterations if the distance is long
-    bool arrived = false;
-    int nit = 0; // Iteration count.
+    const bool flip = origin.isTrackAlongPlaneDir() ? dw2dw1 < 0. : dw2dw1 > 0.;
     double deriv = 1.;
     SMatrixSym55 noise_matrix;
-    while (!arrived) {
-      ++nit;
-      if (nit > fMaxNit) {
-        success = false;
-        return origin;
-      }
-      // Estimate maximum step distance, such that fMaxElossFrac of initial energy is lost by dedx
-      const double mass = origin.mass();
-      const double p = 1. / par5d[4];
-      const double e = std::hypot(p, mass);
-      const double t = e - mass;
-      const double dedx = 0.001 * detProp.Eloss(std::abs(p), mass, fTcut);
-      const double range = t / dedx;
-      const double smax = std::max(fMinStep, fMaxElossFrac * range);
-      double s = distance;
-      if (domcs && smax > 0 && std::abs(s) > smax) {
-        if (fMaxNit == 1) {
-          success = false;
-          return origin;
-        }
-        s = (s > 0 ? smax : -smax);
-        distance -= s;
-      }
-      else
-        arrived = true;
-      // now apply material effects
-      if (domcs) {
-        bool flip = false;
-        if (origin.isTrackAlongPlaneDir() == true && dw2dw1 < 0.) flip = true;
-        if (origin.isTrackAlongPlaneDir() == false && dw2dw1 > 0.) flip = true;
-        bool ok = apply_mcs(detProp,
-                            par5d[2],
-                            par5d[3],
-                            par5d[4],
-                            origin.mass(),
-                            s,
-                            range,
-                            p,
-                            e * e,
-                            flip,
-                            noise_matrix);
-        if (!ok) {
-          success = false;
-          return origin;
-        }
-      }
-      if (dodedx) { apply_dedx(par5d(4), detProp, dedx, e, origin.mass(), s, deriv); }
+    if (!apply_material(detProp,
+                        ElossTable::Medium(detProp),
+                        distance,
+                        origin.mass(),
+                        flip,
+                        dodedx,
+                        domcs,
+                        par5d,
+                        deriv,
+                        noise_matrix)) {
+      success = false;
+      return origin;
     }
     if (fPropPinvErr) pm(4, 4) *= deriv;
     //
@@ -128,6 +94,122 @@ namespace trkf {
     return trackState;
   }
 
+  std::vector<TrackState> TrackStatePropagator::propagateToPlane(
+    std::vector<bool>& success,
+    const detinfo::DetectorPropertiesData& detProp,
+    const std::vector<TrackState>& origins,
+    const Plane& target,
+    bool dodedx,
+    bool domcs,
+    PropDirection dir) const
+  {
+    std::vector<TrackState> result;
+    result.reserve(origins.size());
+    success.assign(origins.size(), false);
+    //
+    // medium and target plane quantities, common to all origins
+    const ElossTable::Medium medium(detProp);
+    const Point_t& targpos = target.position();
+    const Vector_t& targdir = target.direction();
+    const double sinA2 = target.sinAlpha();
+    const double cosA2 = target.cosAlpha();
+    const double sinB2 = target.sinBeta();
+    const double cosB2 = target.cosBeta();
+    //
+    for (size_t i = 0; i < origins.size(); ++i) {
+      const TrackState& origin = origins[i];
+      const SVector5& par = origin.parameters();
+      //
+      // 1- find distance to target plane
+      const double cosdir = targdir.Dot(origin.momentum().Unit());
+      if (cosdir == 0) {
+        result.push_back(origin);
+        continue;
+      }
+      const double sperp = targdir.Dot(targpos - origin.position());
+      double distance = sperp / cosdir;
+      if ((distance < -fWrongDirDistTolerance && dir == FORWARD) ||
+          (distance > fWrongDirDistTolerance && dir == BACKWARD)) {
+        result.push_back(origin);
+        continue;
+      }
+      //
+      // 2- propagate 3d position by distance
+      const Point_t p =
+        propagatedPosByDistance(origin.position(), origin.momentum() * par[4], distance);
+      //
+      // 3- rotate direction to target plane (see rotateToPlane), position is at p
+      const double sinA1 = origin.plane().sinAlpha();
+      const double cosA1 = origin.plane().cosAlpha();
+      const double sinB1 = origin.plane().sinBeta();
+      const double cosB1 = origin.plane().cosBeta();
+      const double sindB = -sinB1 * cosB2 + cosB1 * sinB2;
+      const double cosdB = cosB1 * cosB2 + sinB1 * sinB2;
+      const double ruu = cosA1 * cosA2 + sinA1 * sinA2 * cosdB;
+      const double ruv = sinA2 * sindB;
+      const double ruw = sinA1 * cosA2 - cosA1 * sinA2 * cosdB;
+      const double rvu = -sinA1 * sindB;
+      const double rvv = cosdB;
+      const double rvw = cosA1 * sindB;
+      const double rwu = cosA1 * sinA2 - sinA1 * cosA2 * cosdB;
+      const double rwv = -cosA2 * sindB;
+      const double rww = sinA1 * sinA2 + cosA1 * cosA2 * cosdB;
+      const double dw2dw1 = par[2] * rwu + par[3] * rwv + rww;
+      if (dw2dw1 == 0.) {
+        result.push_back(origin);
+        continue;
+      }
+      const double dudw2 = (par[2] * ruu + par[3] * ruv + ruw) / dw2dw1;
+      const double dvdw2 = (par[2] * rvu + par[3] * rvv + rvw) / dw2dw1;
+      SVector5 par5d((p.X() - targpos.X()) * cosA2 + (p.Y() - targpos.Y()) * sinA2 * sinB2 -
+                       (p.Z() - targpos.Z()) * sinA2 * cosB2,
+                     (p.Y() - targpos.Y()) * cosB2 + (p.Z() - targpos.Z()) * sinB2,
+                     dudw2,
+                     dvdw2,
+                     par[4]);
+      //
+      // 4- apply material effects
+      const bool flip = origin.isTrackAlongPlaneDir() ? dw2dw1 < 0. : dw2dw1 > 0.;
+      double deriv = 1.;
+      SMatrixSym55 noise_matrix;
+      if (!apply_material(detProp,
+                          medium,
+                          distance,
+                          origin.mass(),
+                          flip,
+                          dodedx,
+                          domcs,
+                          par5d,
+                          deriv,
+                          noise_matrix)) {
+        result.push_back(origin);
+        continue;
+      }
+      //
+      // 5- jacobian of rotation followed by propagation by sperp along the rotated direction
+      SMatrix55 pm;
+      pm(0, 0) = ruu - dudw2 * rwu;            // du2/du1
+      pm(1, 0) = rvu - dvdw2 * rwu;            // dv2/du1
+      pm(0, 1) = ruv - dudw2 * rwv;            // du2/dv1
+      pm(1, 1) = rvv - dvdw2 * rwv;            // dv2/dv1
+      pm(2, 2) = (ruu - dudw2 * rwu) / dw2dw1; // d(dudw2)/d(dudw1)
+      pm(3, 2) = (rvu - dvdw2 * rwu) / dw2dw1; // d(dvdw2)/d(dudw1)
+      pm(2, 3) = (ruv - dudw2 * rwv) / dw2dw1; // d(dudw2)/d(dvdw1)
+      pm(3, 3) = (rvv - dvdw2 * rwv) / dw2dw1; // d(dvdw2)/d(dvdw1)
+      pm(0, 2) = sperp * pm(2, 2);             // du2/d(dudw1)
+      pm(1, 2) = sperp * pm(3, 2);             // dv2/d(dudw1)
+      pm(0, 3) = sperp * pm(2, 3);             // du2/d(dvdw1)
+      pm(1, 3) = sperp * pm(3, 3);             // dv2/d(dvdw1)
+      pm(4, 4) = (fPropPinvErr ? deriv : 1.);  // d(pinv2)/d(pinv1)
+      //
+      // 6- create final track state
+      SMatrixSym55 cov5d = ROOT::Math::Similarity(pm, origin.covariance()) + noise_matrix;
+      result.emplace_back(par5d, cov5d, target, origin.momentum().Dot(targdir) > 0, origin.pID());
+      success[i] = true;
+    }
+    return result;
+  }
+
   TrackState TrackStatePropagator::rotateToPlane(bool& success,
                                                  const TrackState& origin,
                                                  const Plane& target,
@@ -260,6 +342,84 @@ namespace trkf {
     return std::pair<double, double>(s, sperp);
   }
 
+  double TrackStatePropagator::eloss(detinfo::DetectorPropertiesData const& detProp,
+                                     double p,
+                                     double mass) const
+  {
+    if (fExactEloss) return detProp.Eloss(p, mass, fTcut);
+    return ElossTable::Get(detProp, mass, fTcut).Eloss(p);
+  }
+
+  double TrackStatePropagator::eloss(const ElossTable::Medium& medium, double p, double mass) const
+  {
+    if (fExactEloss) return medium.Eloss(p, mass, fTcut);
+    return ElossTable::Get(medium, mass, fTcut).Eloss(p);
+  }
+
+  bool TrackStatePropagator::apply_material(detinfo::DetectorPropertiesData const& detProp,
+                                            double distance,
+                                            double mass,
+                                            bool flipSign,
+                                            bool dodedx,
+                                            bool domcs,
+                                            SVector5& par5d,
+                                            double& deriv,
+                                            SMatrixSym55& noise_matrix) const
+  {
+    return apply_material(detProp,
+                          ElossTable::Medium(detProp),
+                          distance,
+                          mass,
+                          flipSign,
+                          dodedx,
+                          domcs,
+                          par5d,
+                          deriv,
+                          noise_matrix);
+  }
+
+  bool TrackStatePropagator::apply_material(detinfo::DetectorPropertiesData const& detProp,
+                                            const ElossTable::Medium& medium,
+                                            double distance,
+                                            double mass,
+                                            bool flipSign,
+                                            bool dodedx,
+                                            bool domcs,
+                                            SVector5& par5d,
+                                            double& deriv,
+                                            SMatrixSym55& noise_matrix) const
+  {
+    bool arrived = false;
+    int nit = 0; // Iteration count.
+    while (!arrived) {
+      ++nit;
+      if (nit > fMaxNit) return false;
+      // Estimate maximum step distance, such that fMaxElossFrac of initial energy is lost by dedx
+      const double p = 1. / par5d[4];
+      const double e = std::hypot(p, mass);
+      const double t = e - mass;
+      const double dedx = 0.001 * eloss(medium, std::abs(p), mass);
+      const double range = t / dedx;
+      const double smax = std::max(fMinStep, fMaxElossFrac * range);
+      double s = distance;
+      if (domcs && smax > 0 && std::abs(s) > smax) {
+        if (fMaxNit == 1) return false;
+        s = (s > 0 ? smax : -smax);
+        distance -= s;
+      }
+      else
+        arrived = true;
+      // now apply material effects
+      if (domcs) {
+        bool ok = apply_mcs(
+          detProp, par5d[2], par5d[3], par5d[4], mass, s, range, p, e * e, flipSign, noise_matrix);
+        if (!ok) return false;
+      }
+      if (dodedx) { apply_dedx(par5d(4), medium, dedx, e, mass, s, deriv); }
+    }
+    return true;
+  }
+
   void TrackStatePropagator::apply_dedx(double& pinv,
                                         detinfo::DetectorPropertiesData const& detProp,
                                         double dedx,
@@ -267,6 +427,17 @@ namespace trkf {
                                         double mass,
                                         double s,
                                         double& deriv) const
+  {
+    apply_dedx(pinv, ElossTable::Medium(detProp), dedx, e1, mass, s, deriv);
+  }
+
+  void TrackStatePropagator::apply_dedx(double& pinv,
+                                        const ElossTable::Medium& medium,
+                                        double dedx,
+                                        double e1,
+                                        double mass,
+                                        double s,
+                                        double& deriv) const
   {
     // For infinite initial momentum, return with infinite momentum.
     if (pinv == 0.) return;
@@ -274,7 +445,7 @@ namespace trkf {
     const double emid = e1 - 0.5 * s * dedx;
     if (emid > mass) {
       const double pmid = std::sqrt(emid * emid - mass * mass);
-      const double e2 = e1 - 0.001 * s * detProp.Eloss(pmid, mass, fTcut);
+      const double e2 = e1 - 0.001 * s * eloss(medium, pmid, mass);
       if (e2 > mass) {
         const double p2 = std::sqrt(e2 * e2 - mass * mass);
         double pinv2 = 1. / p2;
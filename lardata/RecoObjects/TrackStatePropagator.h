@@ -3,11 +3,13 @@
 
 #include "fhiclcpp/types/Atom.h"
 #include "fhiclcpp/types/Table.h"
+#include "lardata/RecoObjects/ElossTable.h"
 #include "lardata/RecoObjects/TrackState.h"
 #include "lardataobj/RecoBase/TrackingPlane.h"
 #include "lardataobj/RecoBase/TrackingTypes.h"
 
 #include <utility>
+#include <vector>
 
 namespace detinfo {
   class DetectorPropertiesData;
@@ -32,6 +34,11 @@ namespace trkf {
   /// While the propagated position can be directly computed, accounting for the material effects
   /// in the covariance matrix requires an iterative procedure in case of long propagations distances.
   ///
+  /// Many TrackStates can be propagated to a common Plane in one call (e.g. when refitting every
+  /// track in the event against the same wire planes). The batched propagateToPlane computes
+  /// the target plane quantities once, and combines the rotation and the propagation Jacobians
+  /// into one similarity transform of each covariance matrix.
+  ///
   /// For configuration options see TrackStatePropagator#Config
   ///
 
@@ -66,6 +73,10 @@ namespace trkf {
         Comment("Propagate error on 1/p or not (in order to avoid infs, it should be set to false "
                 "when 1/p not updated)."),
         false};
+      fhicl::Atom<bool> exactEloss{
+        Name("exactEloss"),
+        Comment("Use DetectorPropertiesData::Eloss instead of a dE/dx table (validation)."),
+        false};
     };
     using Parameters = fhicl::Table<Config>;
 
@@ -78,7 +89,8 @@ namespace trkf {
                          int maxNit,
                          double tcut,
                          double wrongDirDistTolerance,
-                         bool propPinvErr);
+                         bool propPinvErr,
+                         bool exactEloss = false);
 
     /// Constructor from Parameters (fhicl::Table<Config>).
     explicit TrackStatePropagator(Parameters const& p)
@@ -87,7 +99,8 @@ namespace trkf {
                              p().maxNit(),
                              p().tcut(),
                              p().wrongDirDistTolerance(),
-                             p().propPinvErr())
+                             p().propPinvErr(),
+                             p().exactEloss())
     {}
 
     /// Main function for propagation of a TrackState to a Plane
@@ -99,6 +112,18 @@ namespace trkf {
                                 bool domcs,
                                 PropDirection dir = FORWARD) const;
 
+    /// Propagation of a batch of TrackStates to a common Plane
+    ///
+    /// Same as propagateToPlane for each origin, with success[i] the success flag of origins[i].
+    /// Failed propagations return the origin state.
+    std::vector<TrackState> propagateToPlane(std::vector<bool>& success,
+                                             const detinfo::DetectorPropertiesData& detProp,
+                                             const std::vector<TrackState>& origins,
+                                             const Plane& target,
+                                             bool dodedx,
+                                             bool domcs,
+                                             PropDirection dir = FORWARD) const;
+
     /// Rotation of a TrackState to a Plane (zero distance propagation)
     TrackState rotateToPlane(bool& success, const TrackState& origin, const Plane& target) const
     {
@@ -171,10 +196,48 @@ namespace trkf {
                    bool flipSign,
                    SMatrixSym55& noise_matrix) const;
 
+    /// Apply material effects over a distance (in steps for long distances).
+    bool apply_material(detinfo::DetectorPropertiesData const& detProp,
+                        double distance,
+                        double mass,
+                        bool flipSign,
+                        bool dodedx,
+                        bool domcs,
+                        SVector5& par5d,
+                        double& deriv,
+                        SMatrixSym55& noise_matrix) const;
+
     /// get Tcut parameter used in DetectorPropertiesService Eloss method
     double getTcut() const { return fTcut; }
 
+    /// Mean energy loss (MeV/cm), from a table (see ElossTable.h) unless exactEloss is set
+    double eloss(detinfo::DetectorPropertiesData const& detProp, double p, double mass) const;
+
   private:
+    /// Apply energy loss in the given medium.
+    void apply_dedx(double& pinv,
+                    const ElossTable::Medium& medium,
+                    double dedx,
+                    double e1,
+                    double mass,
+                    double s,
+                    double& deriv) const;
+
+    /// Apply material effects over a distance, with energy loss in the given medium.
+    bool apply_material(detinfo::DetectorPropertiesData const& detProp,
+                        const ElossTable::Medium& medium,
+                        double distance,
+                        double mass,
+                        bool flipSign,
+                        bool dodedx,
+                        bool domcs,
+                        SVector5& par5d,
+                        double& deriv,
+                        SMatrixSym55& noise_matrix) const;
+
+    /// Mean energy loss (MeV/cm) in the given medium.
+    double eloss(const ElossTable::Medium& medium, double p, double mass) const;
+
     /// Rotation of a TrackState to a Plane (zero distance propagation), keeping track of dw2dw1 (needed by mcs)
     TrackState rotateToPlane(bool& success,
                              const TrackState& origin,
@@ -188,6 +251,7 @@ namespace trkf {
     double fWrongDirDistTolerance; ///< Allowed propagation distance in the wrong direction.
     bool
       fPropPinvErr; ///< Propagate error on 1/p or not (in order to avoid infs, it should be set to false when 1/p not updated)
+    bool fExactEloss; ///< Compute dE/dx with DetectorPropertiesData::Eloss instead of a table.
     const detinfo::LArProperties* larprop;
   };
 }
@@ -0,0 +1,48 @@
+////////////////////////////////////////////////////////////////////////
+/// \file   CorrelationPeak.h
+///
+/// \brief  Sub-bin position of the peak of a correlation.
+///
+/// The peak is located at the largest sample and refined in closed form
+/// from it and its two neighbours (circularly, as the correlation from a
+/// Fourier transform is periodic): a Gaussian through the three points if
+/// they are all positive, a parabola otherwise. For a Gaussian peak the
+/// result is exact, and it takes no histogram nor fit.
+////////////////////////////////////////////////////////////////////////
+
+#ifndef CORRELATIONPEAK_H
+#define CORRELATIONPEAK_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace util {
+
+  /// Returns the position of the maximum of `data`, in units of samples.
+  template <class T>
+  double CorrelationPeak(std::vector<T> const& data)
+  {
+    std::size_t const n = data.size();
+    if (n < 3) return std::max_element(data.begin(), data.end()) - data.begin();
+
+    std::size_t const maxT = std::max_element(data.begin(), data.end()) - data.begin();
+    double left = data[(maxT + n - 1) % n];
+    double center = data[maxT];
+    double right = data[(maxT + 1) % n];
+
+    if (left > 0. && center > 0. && right > 0.) {
+      left = std::log(left);
+      center = std::log(center);
+      right = std::log(right);
+    }
+
+    double const curvature = left - 2. * center + right;
+    if (curvature >= 0.) return maxT; // flat top
+    return maxT + 0.5 * (left - right) / curvature;
+  }
+
+} // namespace util
+
+#endif // CORRELATIONPEAK_H
@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////
+/// \file   KernelCache.h
+///
+/// \brief  Job-wide cache of kernels, keyed by the content they derive from.
+///
+/// Kernels (e.g. the Fourier transform of a response function, or a
+/// deconvolution kernel) are identified by a key made of all the numbers
+/// they are computed from: the transform size, the response samples, the
+/// filter, and so on. The key is hashed for the lookup, and compared in
+/// full on a hash match, so that a collision can never return a wrong
+/// kernel. Kernels are computed once and then shared, read-only, by all
+/// the channels and planes (and threads) asking for the same key.
+///
+/// The cache is bounded: when it exceeds its capacity it is emptied, and
+/// kernels still in use stay valid until their last user releases them.
+////////////////////////////////////////////////////////////////////////
+
+#ifndef KERNELCACHE_H
+#define KERNELCACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+  template <typename Kernel>
+  class KernelCache {
+  public:
+    using Key_t = std::vector<double>;
+    using KernelPtr_t = std::shared_ptr<Kernel const>;
+
+    /// What a kernel is (first element of its key).
+    enum KernelTag_t : int {
+      kResponseTransform = 1, ///< Fourier transform of a time series
+      kDeconvolutionKernel    ///< normalized filter/response ratio
+    };
+
+    static constexpr std::size_t DefaultCapacity = 256;
+
+    /// Returns the cache of this kernel type for the whole job.
+    static KernelCache& Instance()
+    {
+      static KernelCache cache;
+      return cache;
+    }
+
+    /// Returns the kernel for `key`, computing it with `make()` if needed.
+    template <typename Make>
+    KernelPtr_t Get(Key_t const& key, Make make);
+
+    std::size_t size() const;
+    std::size_t Capacity() const;
+    void SetCapacity(std::size_t capacity);
+    void Clear();
+
+    static std::size_t Hash(Key_t const& key);
+
+  private:
+    struct Entry {
+      Key_t key;
+      KernelPtr_t kernel;
+    };
+
+    mutable std::mutex fMutex;
+    std::unordered_map<std::size_t, std::vector<Entry>> fEntries;
+    std::size_t fSize = 0;
+    std::size_t fCapacity = DefaultCapacity;
+
+    KernelPtr_t Find(std::size_t hash, Key_t const& key) const;
+  };
+
+} // namespace util
+
+//----------------------------------------------------------------------
+template <typename Kernel>
+template <typename Make>
+typename util::KernelCache<Kernel>::KernelPtr_t util::KernelCache<Kernel>::Get(Key_t const& key,
+                                                                               Make make)
+{
+  std::size_t const hash = Hash(key);
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (KernelPtr_t kernel = Find(hash, key)) return kernel;
+  }
+
+  // compute outside the lock, so that different kernels are made concurrently
+  auto kernel = std::make_shared<Kernel const>(make());
+
+  std::lock_guard<std::mutex> lock(fMutex);
+  if (KernelPtr_t other = Find(hash, key)) return other; // someone was faster
+  if (fSize >= fCapacity) {
+    fEntries.clear();
+    fSize = 0;
+  }
+  fEntries[hash].push_back({key, kernel});
+  ++fSize;
+  return kernel;
+}
+
+//----------------------------------------------------------------------
+template <typename Kernel>
+std::size_t util::KernelCache<Kernel>::size() const
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  return fSize;
+}
+
+template <typename Kernel>
+std::size_t util::KernelCache<Kernel>::Capacity() const
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  return fCapacity;
+}
+
+template <typename Kernel>
+void util::KernelCache<Kernel>::SetCapacity(std::size_t capacity)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  fCapacity = capacity;
+}
+
+template <typename Kernel>
+void util::KernelCache<Kernel>::Clear()
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  fEntries.clear();
+  fSize = 0;
+}
+
+//----------------------------------------------------------------------
+template <typename Kernel>
+std::size_t util::KernelCache<Kernel>::Hash(Key_t const& key)
+{
+  return std::hash<std::string_view>()(
+    std::string_view(reinterpret_cast<char const*>(key.data()), key.size() * sizeof(double)));
+}
+
+//----------------------------------------------------------------------
+template <typename Kernel>
+typename util::KernelCache<Kernel>::KernelPtr_t util::KernelCache<Kernel>::Find(
+  std::size_t hash,
+  Key_t const& key) const
+{
+  auto const iEntries = fEntries.find(hash);
+  if (iEntries == fEntries.end()) return {};
+  for (Entry const& entry : iEntries->second)
+    if (entry.key == key) return entry.kernel;
+  return {};
+}
+
+#endif // KERNELCACHE_H
@@ -12,91 +12,153 @@
 ////////////////////////////////////////////////////////////////////////
 
 #include "lardata/Utilities/LArFFT.h"
+#include "cetlib_except/exception.h"
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
 
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+
+namespace {
+  // FFTW planner (and plan destruction) is not thread-safe
+  std::mutex plannerMutex;
+
+  // neither is ROOT fitting (Minuit)
+  std::mutex fitMutex;
+}
+
 //-----------------------------------------------
 util::LArFFT::LArFFT(fhicl::ParameterSet const& pset, art::ActivityRegistry& reg)
-  : fSize(pset.get<int>("FFTSize", 0))
-  , fOption(pset.get<std::string>("FFTOption"))
-  , fFitBins(pset.get<int>("FitBins"))
+  : fSinglePrecision(pset.get<bool>("SinglePrecision", false))
+  , fValidateSinglePrecision(pset.get<bool>("ValidateSinglePrecision", false))
+  , fValidatePeakFit(pset.get<bool>("ValidatePeakFit", false))
 {
+  int size = pset.get<int>("FFTSize", 0);
   // Default to the readout window size if the user didn't input
   // a specific size
-  if (fSize <= 0) {
+  if (size <= 0) {
     // Creating a service handle to DetectorPropertiesService not only
     // creates the service if it doesn't exist, it also guarantees
     // that its callbacks are invoked before any of LArFFT's callbacks
     // are invoked.
-    fSize = art::ServiceHandle<detinfo::DetectorPropertiesService const>()
-              ->DataForJob()
-              .ReadOutWindowSize();
+    size = art::ServiceHandle<detinfo::DetectorPropertiesService const>()
+             ->DataForJob()
+             .ReadOutWindowSize();
     reg.sPreBeginRun.watch(this, &util::LArFFT::resetSizePerRun);
   }
-  InitializeFFT();
+  ReinitializeFFT(size, pset.get<std::string>("FFTOption"), pset.get<int>("FitBins"));
 }
 
 //-----------------------------------------------
 void util::LArFFT::resetSizePerRun(art::Run const&)
 {
-  fSize = art::ServiceHandle<detinfo::DetectorPropertiesService const>()
-            ->DataForJob()
-            .ReadOutWindowSize();
-  ReinitializeFFT(fSize, fOption, fFitBins);
+  auto const config = GetConfig();
+  ReinitializeFFT(art::ServiceHandle<detinfo::DetectorPropertiesService const>()
+                    ->DataForJob()
+                    .ReadOutWindowSize(),
+                  config->fOption,
+                  config->fFitBins);
 }
 
-//-----------------------------------------------
-void util::LArFFT::InitializeFFT()
+//------------------------------------------------
+util::LArFFT::~LArFFT() = default;
+
+//------------------------------------------------
+void util::LArFFT::ReinitializeFFT(int size, std::string option, int fitbins)
+{
+  // the new configuration replaces the current one as a whole; transforms
+  // already running keep the one they started with
+  auto config = MakeConfig(size, option, fitbins);
+  {
+    std::unique_lock<std::shared_mutex> lock(fConfigMutex);
+    fConfig = std::move(config);
+  }
+
+  // the workspace of this thread is set up right away,
+  // so that the planning cost (and possible failure) is met at configuration
+  GetWorkspace();
+}
+
+//------------------------------------------------
+std::shared_ptr<util::LArFFT::Config const> util::LArFFT::MakeConfig(int size,
+                                                                   std::string const& option,
+                                                                   int fitbins)
 {
   int i;
-  for (i = 1; i < fSize; i *= 2) {}
-  fSize = i;
-  fFreqSize = fSize / 2 + 1;
+  for (i = 1; i < size; i *= 2) {}
+  return std::make_shared<Config const>(Config{i, i / 2 + 1, option, fitbins});
+}
+
+//------------------------------------------------
+std::shared_ptr<util::LArFFT::Config const> util::LArFFT::GetConfig() const
+{
+  std::shared_lock<std::shared_mutex> lock(fConfigMutex);
+  return fConfig;
+}
+
+//------------------------------------------------
+util::LArFFT::Workspace& util::LArFFT::GetWorkspace() const
+{
+  // one workspace per transform size in each thread; a workspace configured
+  // with obsolete options (see `ReinitializeFFT()`) is replaced
+  thread_local std::map<int, std::unique_ptr<Workspace>> workspaces;
+
+  auto const config = GetConfig();
+  std::unique_ptr<Workspace>& ws = workspaces[config->fSize];
+  if (!ws || (ws->fOption != config->fOption) || (ws->fFitBins != config->fFitBins))
+    ws = std::make_unique<Workspace>(*config);
+  return *ws;
+}
+
+//------------------------------------------------
+void util::LArFFT::CheckKernelSize(const SplitComplexKernel& kern, Workspace const& ws) const
+{
+  if (kern.size() != (size_t)ws.fFreqSize)
+    throw cet::exception("LArFFT") << "Bad kernel size = " << kern.size() << " (expected "
+                                   << ws.fFreqSize << ")\n";
+}
+
+//------------------------------------------------
+std::mutex& util::LArFFT::FitMutex()
+{
+  return fitMutex;
+}
+
+//------------------------------------------------
+util::LArFFT::Workspace::Workspace(Config const& config)
+  : fSize(config.fSize)
+  , fFreqSize(config.fFreqSize)
+  , fOption(config.fOption)
+  , fFitBins(config.fFitBins)
+  , fCompTemp(fFreqSize)
+  , fKern(fFreqSize)
+  , fRe(fFreqSize)
+  , fIm(fFreqSize)
+{
+  std::lock_guard<std::mutex> lock(plannerMutex);
 
   // allocate and setup Transform objects
-  fFFT = new TFFTRealComplex(fSize, false);
-  fInverseFFT = new TFFTComplexReal(fSize, false);
+  fFFT = std::make_unique<TFFTRealComplex>(fSize, false);
+  fInverseFFT = std::make_unique<TFFTComplexReal>(fSize, false);
 
   int dummy[1] = {0};
   // appears to be dummy argument from root page
   fFFT->Init(fOption.c_str(), -1, dummy);
   fInverseFFT->Init(fOption.c_str(), 1, dummy);
 
-  fPeakFit = new TF1("fPeakFit", "gaus"); //allocate function used for peak fitting
-  fConvHist = new TH1D("fConvHist",
-                       "Convolution Peak Data",
-                       fFitBins,
-                       0,
-                       fFitBins); //allocate histogram for peak fitting
-  //allocate other data vectors
-  fCompTemp.resize(fFreqSize);
-  fKern.resize(fFreqSize);
+  //allocate function used for peak fitting, kept out of ROOT global list
+  fPeakFit = std::make_unique<TF1>("fPeakFit", "gaus", 0., 1., TF1::EAddToList::kNo);
+  //allocate histogram for peak fitting, kept out of ROOT current directory
+  fConvHist = std::make_unique<TH1D>("fConvHist", "Convolution Peak Data", fFitBins, 0, fFitBins);
+  fConvHist->SetDirectory(nullptr);
 }
 
 //------------------------------------------------
-util::LArFFT::~LArFFT()
+util::LArFFT::Workspace::~Workspace()
 {
-  delete fFFT;
-  delete fInverseFFT;
-  delete fPeakFit;
-  delete fConvHist;
-}
-
-//------------------------------------------------
-void util::LArFFT::ReinitializeFFT(int size, std::string option, int fitbins)
-{
-  //delete these, which will be remade
-  delete fFFT;
-  delete fInverseFFT;
-  delete fPeakFit;
-  delete fConvHist;
-
-  //set members
-  fSize = size;
-  fOption = option;
-  fFitBins = fitbins;
-
-  //now initialize
-  InitializeFFT();
+  std::lock_guard<std::mutex> lock(plannerMutex);
+  fFFT.reset();
+  fInverseFFT.reset();
 }
 
 //-------------------------------------------------
@@ -113,11 +175,18 @@ void util::LArFFT::ReinitializeFFT(int size, std::string option, int fitbins)
 //According to the Fourier transform identity
 //f(x-a) = Inverse Transform(exp(-2*Pi*i*a*w)F(w))
 //--------------------------------------------------
-void util::LArFFT::ShiftData(std::vector<TComplex>& input, double shift)
+void util::LArFFT::ShiftData(std::vector<TComplex>& input, double shift) const
+{
+  ShiftData(input, shift, GetWorkspace());
+}
+
+void util::LArFFT::ShiftData(std::vector<TComplex>& input,
+                             double shift,
+                             Workspace const& ws) const
 {
-  double factor = -2.0 * TMath::Pi() * shift / (double)fSize;
+  double factor = -2.0 * TMath::Pi() * shift / (double)ws.fSize;
 
-  for (int i = 0; i < fFreqSize; i++)
+  for (int i = 0; i < ws.fFreqSize; i++)
     input[i] *= TComplex::Exp(TComplex(0, factor * (double)i));
 
   return;
@@ -13,13 +13,21 @@
 #include "TFFTComplexReal.h"
 #include "TFFTRealComplex.h"
 #include "TH1D.h"
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
+#include "lardata/Utilities/CorrelationPeak.h"
+#include "lardata/Utilities/KernelCache.h"
+#include "lardata/Utilities/SplitComplexKernel.h"
+
 #include "art/Framework/Services/Registry/ActivityRegistry.h"
 #include "art/Framework/Services/Registry/ServiceDeclarationMacros.h"
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "fhiclcpp/ParameterSet.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
 
 ///General LArSoft Utilities
 namespace util {
@@ -28,61 +36,158 @@ namespace util {
     LArFFT(fhicl::ParameterSet const& pset, art::ActivityRegistry& reg);
     ~LArFFT();
 
+    // All transform methods are const: the scratch space they need is held
+    // in a workspace private to the calling thread. Each call works with the
+    // configuration current when it starts, even if it is changed meanwhile
+    // (`ReinitializeFFT()`, or a new run with a different readout window).
+
+    template <class T>
+    void DoFFT(std::vector<T>& input, std::vector<TComplex>& output) const;
+
+    template <class T>
+    void DoInvFFT(std::vector<TComplex>& input, std::vector<T>& output) const;
+
     template <class T>
-    void DoFFT(std::vector<T>& input, std::vector<TComplex>& output);
+    void Deconvolute(std::vector<T>& input, std::vector<T>& respFunc) const;
 
     template <class T>
-    void DoInvFFT(std::vector<TComplex>& input, std::vector<T>& output);
+    void Deconvolute(std::vector<T>& input, std::vector<TComplex>& kern) const;
 
     template <class T>
-    void Deconvolute(std::vector<T>& input, std::vector<T>& respFunc);
+    void Convolute(std::vector<T>& input, std::vector<T>& respFunc) const;
 
     template <class T>
-    void Deconvolute(std::vector<T>& input, std::vector<TComplex>& kern);
+    void Convolute(std::vector<T>& input, std::vector<TComplex>& kern) const;
 
     template <class T>
-    void Convolute(std::vector<T>& input, std::vector<T>& respFunc);
+    void Correlate(std::vector<T>& input, std::vector<T>& respFunc) const;
 
     template <class T>
-    void Convolute(std::vector<T>& input, std::vector<TComplex>& kern);
+    void Correlate(std::vector<T>& input, std::vector<TComplex>& kern) const;
 
+    // Versions with kernels in split real/imaginary layout, applied with
+    // vectorized loops; deconvolution multiplies by the reciprocal kernel.
+    // The kernel must have the size of the frequency space (cet::exception).
     template <class T>
-    void Correlate(std::vector<T>& input, std::vector<T>& respFunc);
+    void Convolute(std::vector<T>& input, const SplitComplexKernel& kern) const;
+
+    template <class T>
+    void Deconvolute(std::vector<T>& input, const SplitComplexKernel& kern) const;
+
+    template <class T>
+    void Correlate(std::vector<T>& input, const SplitComplexKernel& kern) const;
+
+    // Transform of a fixed response function (like the ones of SignalShaping),
+    // computed once per job for each response and transform size, and shared
+    // by all the callers. The other methods never use the cache.
+    using KernelCache_t = KernelCache<std::vector<TComplex>>;
 
     template <class T>
-    void Correlate(std::vector<T>& input, std::vector<TComplex>& kern);
+    KernelCache_t::KernelPtr_t CachedResponseTransform(std::vector<T>& respFunc) const;
 
     template <class T>
-    void AlignedSum(std::vector<T>& input, std::vector<T>& output, bool add = true);
+    void AlignedSum(std::vector<T>& input, std::vector<T>& output, bool add = true) const;
 
-    void ShiftData(std::vector<TComplex>& input, double shift);
+    void ShiftData(std::vector<TComplex>& input, double shift) const;
 
     template <class T>
-    void ShiftData(std::vector<T>& input, double shift);
+    void ShiftData(std::vector<T>& input, double shift) const;
 
+    // Peak of the correlation interpolated from its three largest samples
+    // (see CorrelationPeak.h); with `ValidatePeakFit: true` a Gaussian fit
+    // of FitBins samples around it is also performed, and its result,
+    // logged with the difference, is returned instead.
     template <class T>
-    T PeakCorrelation(std::vector<T>& shape1, std::vector<T>& shape2);
+    T PeakCorrelation(std::vector<T>& shape1, std::vector<T>& shape2) const;
 
-    int FFTSize() const { return fSize; }
-    std::string FFTOptions() const { return fOption; }
-    int FFTFitBins() const { return fFitBins; }
+    int FFTSize() const { return GetConfig()->fSize; }
+    std::string FFTOptions() const { return GetConfig()->fOption; }
+    int FFTFitBins() const { return GetConfig()->fFitBins; }
+    bool SinglePrecision() const { return fSinglePrecision; }
+    bool ValidateSinglePrecision() const { return fValidateSinglePrecision; }
+    bool ValidatePeakFit() const { return fValidatePeakFit; }
 
     void ReinitializeFFT(int, std::string, int);
 
   private:
-    int fSize;                       //size of transform
-    int fFreqSize;                   //size of frequency space
-    std::string fOption;             //FFTW setting
-    int fFitBins;                    //Bins used for peak fit
-    TF1* fPeakFit;                   //Gaussian peak function
-    TH1D* fConvHist;                 //Fit data histogram
-    std::vector<TComplex> fCompTemp; //temporary complex data
-    std::vector<TComplex> fKern;     //transformed response function
-
-    TFFTRealComplex* fFFT;        ///< object to do FFT
-    TFFTComplexReal* fInverseFFT; ///< object to do Inverse FF
-
-    void InitializeFFT();
+    /// Transform configuration; never modified once published.
+    struct Config {
+      int fSize;           ///< size of transform (a power of 2)
+      int fFreqSize;       ///< size of frequency space
+      std::string fOption; ///< FFTW setting
+      int fFitBins;        ///< bins used for peak fit
+    }; // struct Config
+
+    /// Transform objects and scratch data for transforms of one size.
+    struct Workspace {
+      explicit Workspace(Config const& config);
+      ~Workspace();
+
+      int fSize;                       ///< size of transform
+      int fFreqSize;                   ///< size of frequency space
+      std::string fOption;             ///< FFTW setting
+      int fFitBins;                    ///< bins used for peak fit
+      std::vector<TComplex> fCompTemp; ///< temporary complex data
+      std::vector<TComplex> fKern;     ///< transformed response function
+      std::vector<double> fRe;         ///< real part of split complex data
+      std::vector<double> fIm;         ///< imaginary part of split complex data
+
+      std::unique_ptr<TFFTRealComplex> fFFT;        ///< object to do FFT
+      std::unique_ptr<TFFTComplexReal> fInverseFFT; ///< object to do Inverse FFT
+      std::unique_ptr<TF1> fPeakFit;                ///< Gaussian peak function
+      std::unique_ptr<TH1D> fConvHist;              ///< fit data histogram
+    }; // struct Workspace
+
+    std::shared_ptr<Config const> fConfig;  //current configuration
+    mutable std::shared_mutex fConfigMutex; //guards the replacement of fConfig
+    bool fSinglePrecision;                  //float transforms in SignalShaping
+    bool fValidateSinglePrecision;          //compare float transforms to double ones
+    bool fValidatePeakFit;                  //fit correlation peaks instead of interpolating
+
+    /// Returns the current configuration.
+    std::shared_ptr<Config const> GetConfig() const;
+
+    /// Returns the workspace of the calling thread for the current configuration.
+    Workspace& GetWorkspace() const;
+
+    /// Returns the mutex serializing the peak fits (ROOT fitting is not thread-safe).
+    static std::mutex& FitMutex();
+
+    // Implementations of the public methods, with the workspace of the call.
+
+    template <class T>
+    void DoFFT(std::vector<T>& input, std::vector<TComplex>& output, Workspace& ws) const;
+
+    template <class T>
+    void DoInvFFT(std::vector<TComplex>& input, std::vector<T>& output, Workspace& ws) const;
+
+    template <class T>
+    void Correlate(std::vector<T>& input, std::vector<T>& respFunc, Workspace& ws) const;
+
+    void ShiftData(std::vector<TComplex>& input, double shift, Workspace const& ws) const;
+
+    template <class T>
+    T PeakCorrelation(std::vector<T>& shape1, std::vector<T>& shape2, Workspace& ws) const;
+
+    /// Transforms input into the split complex data of the workspace.
+    template <class T>
+    void DoSplitFFT(std::vector<T>& input, Workspace& ws) const;
+
+    /// Transforms back the split complex data of the workspace into output.
+    template <class T>
+    void DoSplitInvFFT(Workspace& ws, std::vector<T>& output) const;
+
+    /// Throws cet::exception if kern does not cover the frequency space of ws.
+    void CheckKernelSize(const SplitComplexKernel& kern, Workspace const& ws) const;
+
+    /// Position of the correlation peak from a Gaussian fit.
+    template <class T>
+    T FitPeakCorrelation(std::vector<T>& correlation, Workspace& ws) const;
+
+    /// Returns a configuration with the size rounded up to a power of 2.
+    static std::shared_ptr<Config const> MakeConfig(int size,
+                                                    std::string const& option,
+                                                    int fitbins);
     void resetSizePerRun(art::Run const&);
 
   }; // class LArFFT
@@ -92,19 +197,27 @@ namespace util {
 // "Forward" Fourier Transform
 //--------------------------------------------------------
 template <class T>
-inline void util::LArFFT::DoFFT(std::vector<T>& input, std::vector<TComplex>& output)
+inline void util::LArFFT::DoFFT(std::vector<T>& input, std::vector<TComplex>& output) const
+{
+  DoFFT(input, output, GetWorkspace());
+}
+
+template <class T>
+inline void util::LArFFT::DoFFT(std::vector<T>& input,
+                                std::vector<TComplex>& output,
+                                Workspace& ws) const
 {
   double real = 0.;      //real value holder
   double imaginary = 0.; //imaginary value hold
 
   // set the points
   for (size_t p = 0; p < input.size(); ++p)
-    fFFT->SetPoint(p, input[p]);
+    ws.fFFT->SetPoint(p, input[p]);
 
-  fFFT->Transform();
+  ws.fFFT->Transform();
 
-  for (int i = 0; i < fFreqSize; ++i) {
-    fFFT->GetPointComplex(i, real, imaginary);
+  for (int i = 0; i < ws.fFreqSize; ++i) {
+    ws.fFFT->GetPointComplex(i, real, imaginary);
     output[i] = TComplex(real, imaginary);
   }
 
@@ -114,16 +227,24 @@ inline void util::LArFFT::DoFFT(std::vector<T>& input, std::vector<TComplex>& ou
 //Inverse Fourier Transform
 //-------------------------------------------------
 template <class T>
-inline void util::LArFFT::DoInvFFT(std::vector<TComplex>& input, std::vector<T>& output)
+inline void util::LArFFT::DoInvFFT(std::vector<TComplex>& input, std::vector<T>& output) const
 {
-  for (int i = 0; i < fFreqSize; ++i)
-    fInverseFFT->SetPointComplex(i, input[i]);
+  DoInvFFT(input, output, GetWorkspace());
+}
 
-  fInverseFFT->Transform();
-  double factor = 1.0 / (double)fSize;
+template <class T>
+inline void util::LArFFT::DoInvFFT(std::vector<TComplex>& input,
+                                   std::vector<T>& output,
+                                   Workspace& ws) const
+{
+  for (int i = 0; i < ws.fFreqSize; ++i)
+    ws.fInverseFFT->SetPointComplex(i, input[i]);
+
+  ws.fInverseFFT->Transform();
+  double factor = 1.0 / (double)ws.fSize;
 
-  for (int i = 0; i < fSize; ++i)
-    output[i] = factor * fInverseFFT->GetPointReal(i, false);
+  for (int i = 0; i < ws.fSize; ++i)
+    output[i] = factor * ws.fInverseFFT->GetPointReal(i, false);
 
   return;
 }
@@ -132,15 +253,16 @@ inline void util::LArFFT::DoInvFFT(std::vector<TComplex>& input, std::vector<T>&
 //information
 //--------------------------------------------------
 template <class T>
-inline void util::LArFFT::Deconvolute(std::vector<T>& input, std::vector<T>& respFunction)
+inline void util::LArFFT::Deconvolute(std::vector<T>& input, std::vector<T>& respFunction) const
 {
-  DoFFT(respFunction, fKern);
-  DoFFT(input, fCompTemp);
+  Workspace& ws = GetWorkspace();
+  DoFFT(respFunction, ws.fKern, ws);
+  DoFFT(input, ws.fCompTemp, ws);
 
-  for (int i = 0; i < fFreqSize; i++)
-    fCompTemp[i] /= fKern[i];
+  for (int i = 0; i < ws.fFreqSize; i++)
+    ws.fCompTemp[i] /= ws.fKern[i];
 
-  DoInvFFT(fCompTemp, input);
+  DoInvFFT(ws.fCompTemp, input, ws);
 
   return;
 }
@@ -151,14 +273,15 @@ inline void util::LArFFT::Deconvolute(std::vector<T>& input, std::vector<T>& res
 //for many consecutive transforms
 //--------------------------------------------------
 template <class T>
-inline void util::LArFFT::Deconvolute(std::vector<T>& input, std::vector<TComplex>& kern)
+inline void util::LArFFT::Deconvolute(std::vector<T>& input, std::vector<TComplex>& kern) const
 {
-  DoFFT(input, fCompTemp);
+  Workspace& ws = GetWorkspace();
+  DoFFT(input, ws.fCompTemp, ws);
 
-  for (int i = 0; i < fFreqSize; i++)
-    fCompTemp[i] /= kern[i];
+  for (int i = 0; i < ws.fFreqSize; i++)
+    ws.fCompTemp[i] /= kern[i];
 
-  DoInvFFT(fCompTemp, input);
+  DoInvFFT(ws.fCompTemp, input, ws);
 
   return;
 }
@@ -167,15 +290,16 @@ inline void util::LArFFT::Deconvolute(std::vector<T>& input, std::vector<TComple
 //information
 //--------------------------------------------------
 template <class T>
-inline void util::LArFFT::Convolute(std::vector<T>& shape1, std::vector<T>& shape2)
+inline void util::LArFFT::Convolute(std::vector<T>& shape1, std::vector<T>& shape2) const
 {
-  DoFFT(shape1, fKern);
-  DoFFT(shape2, fCompTemp);
+  Workspace& ws = GetWorkspace();
+  DoFFT(shape1, ws.fKern, ws);
+  DoFFT(shape2, ws.fCompTemp, ws);
 
-  for (int i = 0; i < fFreqSize; i++)
-    fCompTemp[i] *= fKern[i];
+  for (int i = 0; i < ws.fFreqSize; i++)
+    ws.fCompTemp[i] *= ws.fKern[i];
 
-  DoInvFFT(fCompTemp, shape1);
+  DoInvFFT(ws.fCompTemp, shape1, ws);
 
   return;
 }
@@ -186,30 +310,63 @@ inline void util::LArFFT::Convolute(std::vector<T>& shape1, std::vector<T>& shap
 //for many consecutive transforms
 //--------------------------------------------------
 template <class T>
-inline void util::LArFFT::Convolute(std::vector<T>& input, std::vector<TComplex>& kern)
+inline void util::LArFFT::Convolute(std::vector<T>& input, std::vector<TComplex>& kern) const
 {
-  DoFFT(input, fCompTemp);
+  Workspace& ws = GetWorkspace();
+  DoFFT(input, ws.fCompTemp, ws);
 
-  for (int i = 0; i < fFreqSize; i++)
-    fCompTemp[i] *= kern[i];
+  for (int i = 0; i < ws.fFreqSize; i++)
+    ws.fCompTemp[i] *= kern[i];
 
-  DoInvFFT(fCompTemp, input);
+  DoInvFFT(ws.fCompTemp, input, ws);
 
   return;
 }
 
+//Transform of a response function, looked up in the job-wide
+//kernel cache by transform size and content
+//--------------------------------------------------
+template <class T>
+inline util::LArFFT::KernelCache_t::KernelPtr_t util::LArFFT::CachedResponseTransform(
+  std::vector<T>& respFunction) const
+{
+  Workspace& ws = GetWorkspace();
+  KernelCache_t::Key_t key;
+  key.reserve(respFunction.size() + 2);
+  key.push_back(KernelCache_t::kResponseTransform);
+  key.push_back(ws.fSize);
+  key.insert(key.end(), respFunction.begin(), respFunction.end());
+
+  return KernelCache_t::Instance().Get(key, [this, &respFunction, &ws]() {
+    // pad short responses, so that the transform depends on them only
+    std::vector<T> padded(respFunction);
+    if (padded.size() < (size_t)ws.fSize) padded.resize(ws.fSize, T(0));
+    std::vector<TComplex> kern(ws.fFreqSize);
+    DoFFT(padded, kern, ws);
+    return kern;
+  });
+}
+
 //Correlation taking all time domain data
 //--------------------------------------------------
 template <class T>
-inline void util::LArFFT::Correlate(std::vector<T>& shape1, std::vector<T>& shape2)
+inline void util::LArFFT::Correlate(std::vector<T>& shape1, std::vector<T>& shape2) const
 {
-  DoFFT(shape1, fKern);
-  DoFFT(shape2, fCompTemp);
+  Correlate(shape1, shape2, GetWorkspace());
+}
 
-  for (int i = 0; i < fFreqSize; i++)
-    fCompTemp[i] *= TComplex::Conjugate(fKern[i]);
+template <class T>
+inline void util::LArFFT::Correlate(std::vector<T>& shape1,
+                                    std::vector<T>& shape2,
+                                    Workspace& ws) const
+{
+  DoFFT(shape1, ws.fKern, ws);
+  DoFFT(shape2, ws.fCompTemp, ws);
+
+  for (int i = 0; i < ws.fFreqSize; i++)
+    ws.fCompTemp[i] *= TComplex::Conjugate(ws.fKern[i]);
 
-  DoInvFFT(fCompTemp, shape1);
+  DoInvFFT(ws.fCompTemp, shape1, ws);
 
   return;
 }
@@ -220,32 +377,100 @@ inline void util::LArFFT::Correlate(std::vector<T>& shape1, std::vector<T>& shap
 //for many consecutive transforms
 //--------------------------------------------------
 template <class T>
-inline void util::LArFFT::Correlate(std::vector<T>& input, std::vector<TComplex>& kern)
+inline void util::LArFFT::Correlate(std::vector<T>& input, std::vector<TComplex>& kern) const
 {
-  DoFFT(input, fCompTemp);
+  Workspace& ws = GetWorkspace();
+  DoFFT(input, ws.fCompTemp, ws);
 
-  for (int i = 0; i < fFreqSize; i++)
-    fCompTemp[i] *= TComplex::Conjugate(kern[i]);
+  for (int i = 0; i < ws.fFreqSize; i++)
+    ws.fCompTemp[i] *= TComplex::Conjugate(kern[i]);
 
-  DoInvFFT(fCompTemp, input);
+  DoInvFFT(ws.fCompTemp, input, ws);
 
   return;
 }
 
+//Transforms into split real and imaginary parts
+//--------------------------------------------------
+template <class T>
+inline void util::LArFFT::DoSplitFFT(std::vector<T>& input, Workspace& ws) const
+{
+  for (size_t p = 0; p < input.size(); ++p)
+    ws.fFFT->SetPoint(p, input[p]);
+
+  ws.fFFT->Transform();
+  ws.fFFT->GetPointsComplex(ws.fRe.data(), ws.fIm.data());
+}
+
+//Inverse transform from split real and imaginary parts
+//--------------------------------------------------
+template <class T>
+inline void util::LArFFT::DoSplitInvFFT(Workspace& ws, std::vector<T>& output) const
+{
+  ws.fInverseFFT->SetPointsComplex(ws.fRe.data(), ws.fIm.data());
+  ws.fInverseFFT->Transform();
+  double factor = 1.0 / (double)ws.fSize;
+
+  for (int i = 0; i < ws.fSize; ++i)
+    output[i] = factor * ws.fInverseFFT->GetPointReal(i, false);
+}
+
+//Convolution with a split complex kernel
+//--------------------------------------------------
+template <class T>
+inline void util::LArFFT::Convolute(std::vector<T>& input, const SplitComplexKernel& kern) const
+{
+  Workspace& ws = GetWorkspace();
+  CheckKernelSize(kern, ws);
+  DoSplitFFT(input, ws);
+  kern.Multiply(ws.fRe.data(), ws.fIm.data());
+  DoSplitInvFFT(ws, input);
+}
+
+//Deconvolution with a split complex kernel: multiplication
+//by its precomputed reciprocal
+//--------------------------------------------------
+template <class T>
+inline void util::LArFFT::Deconvolute(std::vector<T>& input, const SplitComplexKernel& kern) const
+{
+  Workspace& ws = GetWorkspace();
+  CheckKernelSize(kern, ws);
+  DoSplitFFT(input, ws);
+  kern.Divide(ws.fRe.data(), ws.fIm.data());
+  DoSplitInvFFT(ws, input);
+}
+
+//Correlation with a split complex kernel
+//--------------------------------------------------
+template <class T>
+inline void util::LArFFT::Correlate(std::vector<T>& input, const SplitComplexKernel& kern) const
+{
+  Workspace& ws = GetWorkspace();
+  CheckKernelSize(kern, ws);
+  DoSplitFFT(input, ws);
+  kern.MultiplyConjugate(ws.fRe.data(), ws.fIm.data());
+  DoSplitInvFFT(ws, input);
+}
+
 //Scheme for adding two signals which have an arbitrary
 //relative translation.  Shape1 is translated over shape2
 //and is replaced with the sum, or the translated result
 //if add = false
 //--------------------------------------------------
 template <class T>
-inline void util::LArFFT::AlignedSum(std::vector<T>& shape1, std::vector<T>& shape2, bool add)
+inline void util::LArFFT::AlignedSum(std::vector<T>& shape1,
+                                     std::vector<T>& shape2,
+                                     bool add) const
 {
-  double shift = PeakCorrelation(shape1, shape2);
+  Workspace& ws = GetWorkspace();
+  double shift = PeakCorrelation(shape1, shape2, ws);
 
-  ShiftData(shape1, shift);
+  DoFFT(shape1, ws.fCompTemp, ws);
+  ShiftData(ws.fCompTemp, shift, ws);
+  DoInvFFT(ws.fCompTemp, shape1, ws);
 
   if (add)
-    for (int i = 0; i < fSize; i++)
+    for (int i = 0; i < ws.fSize; i++)
       shape1[i] += shape2[i];
 
   return;
@@ -254,43 +479,72 @@ inline void util::LArFFT::AlignedSum(std::vector<T>& shape1, std::vector<T>& sha
 //Shifts real vectors using above function
 //--------------------------------------------------
 template <class T>
-inline void util::LArFFT::ShiftData(std::vector<T>& input, double shift)
+inline void util::LArFFT::ShiftData(std::vector<T>& input, double shift) const
 {
-  DoFFT(input, fCompTemp);
-  ShiftData(fCompTemp, shift);
-  DoInvFFT(fCompTemp, input);
+  Workspace& ws = GetWorkspace();
+  DoFFT(input, ws.fCompTemp, ws);
+  ShiftData(ws.fCompTemp, shift, ws);
+  DoInvFFT(ws.fCompTemp, input, ws);
 
   return;
 }
 
 //Returns the length of the translation at which the correlation
 //of 2 signals is maximal.
+//As from the fit histogram, the position is the center of the bin of
+//the sample: a peak exactly at sample i is at i + 0.5.
 //--------------------------------------------------
 template <class T>
-inline T util::LArFFT::PeakCorrelation(std::vector<T>& shape1, std::vector<T>& shape2)
+inline T util::LArFFT::PeakCorrelation(std::vector<T>& shape1, std::vector<T>& shape2) const
+{
+  return PeakCorrelation(shape1, shape2, GetWorkspace());
+}
+
+template <class T>
+inline T util::LArFFT::PeakCorrelation(std::vector<T>& shape1,
+                                       std::vector<T>& shape2,
+                                       Workspace& ws) const
 {
-  fConvHist->Reset("ICE");
   std::vector<T> holder = shape1;
-  Correlate(holder, shape2);
+  Correlate(holder, shape2, ws);
+
+  T const peak = CorrelationPeak(holder) + 0.5;
+  if (!fValidatePeakFit) return peak;
+
+  T const fitPeak = FitPeakCorrelation(holder, ws);
+  mf::LogDebug("LArFFT") << "Correlation peak at " << fitPeak << " from fit, " << peak
+                         << " interpolated (difference: " << (peak - fitPeak) << ")";
+  return fitPeak;
+}
+
+//Gaussian fit of the correlation around its maximum.
+//--------------------------------------------------
+template <class T>
+inline T util::LArFFT::FitPeakCorrelation(std::vector<T>& holder, Workspace& ws) const
+{
+  ws.fConvHist->Reset("ICE");
 
   int maxT = max_element(holder.begin(), holder.end()) - holder.begin();
-  float startT = maxT - fFitBins / 2;
+  float startT = maxT - ws.fFitBins / 2;
   int offset = 0;
 
-  for (int i = 0; i < fFitBins; i++) {
+  for (int i = 0; i < ws.fFitBins; i++) {
     if (startT + i < 0)
-      offset = fSize;
-    else if (startT + i > fSize)
-      offset = -fSize;
+      offset = ws.fSize;
+    else if (startT + i > ws.fSize)
+      offset = -ws.fSize;
     else
       offset = 0;
-    fConvHist->Fill(i, holder[i + startT + offset]);
+    ws.fConvHist->Fill(i, holder[i + startT + offset]);
   }
 
-  fPeakFit->SetParameters(fConvHist->GetMaximum(), fFitBins / 2, fFitBins / 2);
-  fConvHist->Fit(fPeakFit, "QWNR", "", 0, fFitBins);
-  return fPeakFit->GetParameter(1) + startT;
+  ws.fPeakFit->SetParameters(ws.fConvHist->GetMaximum(), ws.fFitBins / 2, ws.fFitBins / 2);
+  {
+    std::lock_guard<std::mutex> lock(FitMutex());
+    ws.fConvHist->Fit(ws.fPeakFit.get(), "QWNR", "", 0, ws.fFitBins);
+  }
+  return ws.fPeakFit->GetParameter(1) + startT;
 }
 
-DECLARE_ART_SERVICE(util::LArFFT, LEGACY)
+DECLARE_ART_SERVICE(util::LArFFT, SHARED)
 #endif // LARFFT_H
@@ -2,51 +2,224 @@
 
 using std::string;
 
-util::LArFFTW::LArFFTW(int transformSize, const void* fplan, const void* rplan, int fitbins)
-  : fSize(transformSize), fPlan(fplan), rPlan(rplan), fFitBins(fitbins)
+void* util::details::FFTWAlignedAllocate(std::size_t bytes)
+{
+  void* p = fftw_malloc(bytes);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void util::details::FFTWAlignedFree(void* p)
+{
+  fftw_free(p);
+}
+
+template <typename Real>
+util::BasicLArFFTW<Real>::BasicLArFFTW(int transformSize,
+                                       const void* fplan,
+                                       const void* rplan,
+                                       int fitbins)
+  : fSize(transformSize)
+  , fPlan(fplan)
+  , rPlan(rplan)
+  , fFitBins(fitbins)
+  , fHowMany(1)
+  , fManyIn(nullptr)
+  , fManyOut(nullptr)
+  , fManyPlan(fplan)
+  , rManyPlan(rplan)
 {
 
   fFreqSize = fSize / 2 + 1;
 
   // ... Real-Complex
-  fIn = fftw_malloc(sizeof(double) * fSize);
-  fOut = fftw_malloc(sizeof(fftw_complex) * fFreqSize);
+  fIn = FFTW::Malloc(sizeof(Real) * fSize);
+  fOut = FFTW::Malloc(sizeof(Complex) * fFreqSize);
 
   // ... Complex-Real
-  rIn = fftw_malloc(sizeof(fftw_complex) * fFreqSize);
-  rOut = fftw_malloc(sizeof(double) * fSize);
+  rIn = FFTW::Malloc(sizeof(Complex) * fFreqSize);
+  rOut = FFTW::Malloc(sizeof(Real) * fSize);
 
   // ... allocate other data vectors
   fCompTemp.resize(fFreqSize);
   fKern.resize(fFreqSize);
   fConvHist.resize(fFitBins);
+
+  // ... without batched plans, batches are made of single transforms
+  fManyIn = fIn;
+  fManyOut = fOut;
 }
 
-util::LArFFTW::~LArFFTW()
+template <typename Real>
+util::BasicLArFFTW<Real>::BasicLArFFTW(const BasicLArFFTWPlan<Real>& plan, int fitbins)
+  : BasicLArFFTW(plan.Size(), plan.fPlan, plan.rPlan, fitbins)
 {
+  if (!plan.fManyPlan) return;
+
+  fHowMany = plan.HowMany();
+  fManyPlan = plan.fManyPlan;
+  rManyPlan = plan.rManyPlan;
+  fManyIn = FFTW::Malloc(sizeof(Real) * fSize * fHowMany);
+  fManyOut = FFTW::Malloc(sizeof(Complex) * fFreqSize * fHowMany);
+}
+
+template <typename Real>
+util::BasicLArFFTW<Real>::~BasicLArFFTW()
+{
+  if (fManyIn != fIn) {
+    FFTW::Free(fManyIn);
+    FFTW::Free((Complex*)fManyOut);
+  }
+  fManyIn = 0;
+  fManyOut = 0;
+  fManyPlan = 0;
+  rManyPlan = 0;
+
   fPlan = 0;
-  fftw_free(fIn);
+  FFTW::Free(fIn);
   fIn = 0;
-  fftw_free((fftw_complex*)fOut);
+  FFTW::Free((Complex*)fOut);
   fOut = 0;
 
   rPlan = 0;
-  fftw_free((fftw_complex*)rIn);
+  FFTW::Free((Complex*)rIn);
   rIn = 0;
-  fftw_free(rOut);
+  FFTW::Free(rOut);
   rOut = 0;
 }
 
+template <typename Real>
+void util::BasicLArFFTW<Real>::SetValidatePeakFit(bool validate)
+{
+  if (!validate)
+    fMarqFitAlg.reset();
+  else if (!fMarqFitAlg)
+    fMarqFitAlg = std::make_unique<gshf::MarqFitAlg>();
+}
+
 // According to the Fourier transform identity
 // f(x-a) = Inverse Transform(exp(-2*Pi*i*a*w)F(w))
 // -----------------------------------------------------------------------------
-void util::LArFFTW::ShiftData(ComplexVector& input, double shift)
+template <typename Real>
+void util::BasicLArFFTW<Real>::ShiftData(ComplexVector& input, double shift)
 {
-  double factor = -2.0 * std::acos(-1) * shift / (double)fSize;
+  Real factor = -2.0 * std::acos(-1) * shift / (Real)fSize;
 
   for (int i = 0; i < fFreqSize; i++) {
-    input[i] *= std::exp(std::complex<double>(0, factor * (double)i));
+    input[i] *= std::exp(std::complex<Real>(0, factor * (Real)i));
   }
 
   return;
 }
+
+template <typename Real>
+void util::BasicLArFFTW<Real>::CheckKernelSize(const ComplexVector& kern) const
+{
+  int n = kern.size();
+  if (n != fFreqSize) { throw cet::exception("LArFFTW") << "Bad kernel size = " << n << "\n"; }
+}
+
+template <typename Real>
+void util::BasicLArFFTW<Real>::CheckAligned(const void* buffer) const
+{
+  if (!IsAligned(buffer)) {
+    throw cet::exception("LArFFTW") << "Buffer " << buffer << " is not aligned for FFTW\n";
+  }
+}
+
+template <typename Real>
+bool util::BasicLArFFTW<Real>::IsAligned(const void* buffer)
+{
+  return FFTW::AlignmentOf((Real*)buffer) == 0;
+}
+
+// -----------------------------------------------------------------------------
+// ~~~~ Zero-copy transforms: the caller buffers take the place of fIn and rIn
+//      in the new-array execution, and the internal fOut is the only scratch
+// -----------------------------------------------------------------------------
+template <typename Real>
+void util::BasicLArFFTW<Real>::DoFFT(Real* input, std::complex<Real>* output)
+{
+  CheckAligned(input);
+  CheckAligned(output);
+  FFTW::ExecuteR2C(fPlan, input, reinterpret_cast<Complex*>(output));
+}
+
+template <typename Real>
+void util::BasicLArFFTW<Real>::DoInvFFT(std::complex<Real>* input, Real* output)
+{
+  CheckAligned(input);
+  CheckAligned(output);
+  FFTW::ExecuteC2R(rPlan, reinterpret_cast<Complex*>(input), output);
+
+  Real factor = 1.0 / (Real)fSize;
+  for (int i = 0; i < fSize; ++i)
+    output[i] *= factor;
+}
+
+// the 1/fSize normalization of the inverse transform is folded in the kernel
+template <typename Real>
+void util::BasicLArFFTW<Real>::Convolute(Real* func, const ComplexVector& kern)
+{
+  CheckKernelSize(kern);
+  CheckAligned(func);
+
+  Complex* spectrum = (Complex*)fOut;
+  FFTW::ExecuteR2C(fPlan, func, spectrum);
+
+  Real factor = 1.0 / (Real)fSize;
+  for (int i = 0; i < fFreqSize; ++i) {
+    Real re = spectrum[i][0] * factor;
+    Real im = spectrum[i][1] * factor;
+    spectrum[i][0] = re * kern[i].real() - im * kern[i].imag();
+    spectrum[i][1] = re * kern[i].imag() + im * kern[i].real();
+  }
+
+  FFTW::ExecuteC2R(rPlan, spectrum, func);
+}
+
+template <typename Real>
+void util::BasicLArFFTW<Real>::Deconvolute(Real* func, const ComplexVector& kern)
+{
+  CheckKernelSize(kern);
+  CheckAligned(func);
+
+  Complex* spectrum = (Complex*)fOut;
+  FFTW::ExecuteR2C(fPlan, func, spectrum);
+
+  Real a, b, c, d, e;
+  for (int i = 0; i < fFreqSize; ++i) {
+    a = spectrum[i][0];
+    b = spectrum[i][1];
+    c = kern[i].real();
+    d = kern[i].imag();
+    e = 1. / ((c * c + d * d) * fSize);
+    spectrum[i][0] = (a * c + b * d) * e;
+    spectrum[i][1] = (b * c - a * d) * e;
+  }
+
+  FFTW::ExecuteC2R(rPlan, spectrum, func);
+}
+
+template <typename Real>
+void util::BasicLArFFTW<Real>::Correlate(Real* func, const ComplexVector& kern)
+{
+  CheckKernelSize(kern);
+  CheckAligned(func);
+
+  Complex* spectrum = (Complex*)fOut;
+  FFTW::ExecuteR2C(fPlan, func, spectrum);
+
+  Real factor = 1.0 / (Real)fSize;
+  for (int i = 0; i < fFreqSize; ++i) {
+    Real re = spectrum[i][0] * factor;
+    Real im = spectrum[i][1] * factor;
+    spectrum[i][0] = re * kern[i].real() + im * kern[i].imag();
+    spectrum[i][1] = -re * kern[i].imag() + im * kern[i].real();
+  }
+
+  FFTW::ExecuteC2R(rPlan, spectrum, func);
+}
+
+template class util::BasicLArFFTW<double>;
+template class util::BasicLArFFTW<float>;
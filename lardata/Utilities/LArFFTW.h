@@ -4,26 +4,73 @@
 // C/C++ standard libraries
 #include <algorithm>
 #include <complex>
+#include <memory>
+#include <new>
 #include <string>
 #include <vector>
 
 #include "fftw3.h"
 
 #include "cetlib_except/coded_exception.h"
+#include "lardata/Utilities/CorrelationPeak.h"
+#include "lardata/Utilities/LArFFTWPlan.h"
 #include "larvecutils/MarqFitAlg/MarqFitAlg.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
 namespace util {
 
-  class LArFFTW {
+  namespace details {
+    // ... fftw_malloc() and fftw_free(), defined in LArFFTW.cxx;
+    //     the allocation throws std::bad_alloc on failure.
+    void* FFTWAlignedAllocate(std::size_t bytes);
+    void FFTWAlignedFree(void* p);
+  }
+
+  // ... Allocator of memory with the SIMD alignment FFTW plans are made for.
+  template <class T>
+  struct FFTWAllocator {
+    using value_type = T;
+
+    FFTWAllocator() = default;
+    template <class U>
+    FFTWAllocator(const FFTWAllocator<U>&)
+    {}
+
+    T* allocate(std::size_t n)
+    {
+      return static_cast<T*>(details::FFTWAlignedAllocate(sizeof(T) * n));
+    }
+    void deallocate(T* p, std::size_t) { details::FFTWAlignedFree(p); }
+
+    template <class U>
+    bool operator==(const FFTWAllocator<U>&) const
+    {
+      return true;
+    }
+    template <class U>
+    bool operator!=(const FFTWAllocator<U>&) const
+    {
+      return false;
+    }
+  };
+
+  template <typename Real>
+  class BasicLArFFTW {
+
+    using FFTW = details::FFTWLib<Real>;
 
   public:
     using FloatVector = std::vector<float>;
     using DoubleVector = std::vector<double>;
-    using ComplexVector = std::vector<std::complex<double>>;
+    using Complex = typename FFTW::Complex;
+    using ComplexVector = std::vector<std::complex<Real>>;
+    using AlignedRealVector = std::vector<Real, FFTWAllocator<Real>>;
+    using AlignedComplexVector = std::vector<std::complex<Real>, FFTWAllocator<std::complex<Real>>>;
 
-    LArFFTW(int transformSize, const void* fplan, const void* rplan, int fitbins);
-    ~LArFFTW();
+    BasicLArFFTW(int transformSize, const void* fplan, const void* rplan, int fitbins);
+    // ... uses also the batched plans of `plan`, if any
+    BasicLArFFTW(const BasicLArFFTWPlan<Real>& plan, int fitbins);
+    ~BasicLArFFTW();
 
     template <class T>
     void DoFFT(std::vector<T>& input);
@@ -58,8 +105,58 @@ namespace util {
 
     template <class T>
     void AlignedSum(std::vector<T>& input, std::vector<T>& output, bool add = true);
+    // ... Peak of the correlation, interpolated from its three largest
+    //     samples; in validation mode it is also fitted with a Gaussian over
+    //     the fit bins, and the fit result (logged with the difference) is
+    //     returned instead.
     template <class T>
     T PeakCorrelation(std::vector<T>& shape1, std::vector<T>& shape2);
+    void SetValidatePeakFit(bool validate);
+    bool ValidatePeakFit() const { return fMarqFitAlg != nullptr; }
+
+    // ... Batched convolution and deconvolution of many waveforms with the same
+    //     kernel, either a channel-major block (block[channel * size + tick])
+    //     or a list of waveforms; HowMany() waveforms are transformed together.
+    template <class T>
+    void ConvoluteMany(std::vector<T>& block, const ComplexVector& kern);
+    template <class T>
+    void ConvoluteMany(std::vector<std::vector<T>>& funcs, const ComplexVector& kern);
+    template <class T>
+    void DeconvoluteMany(std::vector<T>& block, const ComplexVector& kern);
+    template <class T>
+    void DeconvoluteMany(std::vector<std::vector<T>>& funcs, const ComplexVector& kern);
+
+    int HowMany() const { return fHowMany; }
+
+    // ... Streaming (overlap-save) convolution and deconvolution of time
+    //     series of any length, in blocks of the transform size. The impulse
+    //     response of the kernel must be negligible outside [-nPre, nPost]
+    //     ticks (negative times wrapped at the end, as in the circular
+    //     transforms). Each transform yields Size() - nPre - nPost ticks of
+    //     output; the series is taken as null outside its range, i.e. the
+    //     convolution is linear, not circular.
+    template <class T>
+    void ConvoluteStream(std::vector<T>& func, const ComplexVector& kern, int nPost, int nPre = 0);
+    template <class T>
+    void DeconvoluteStream(std::vector<T>& func,
+                           const ComplexVector& kern,
+                           int nPost,
+                           int nPre = 0);
+
+    int Size() const { return fSize; }
+
+    // ... Zero-copy versions working directly on caller-owned buffers of
+    //     the transform size (real) or frequency size (complex); buffers must
+    //     be aligned as from fftw_malloc() (e.g. AlignedRealVector).
+    //     The inverse transform overwrites its input spectrum.
+    void DoFFT(Real* input, std::complex<Real>* output);
+    void DoInvFFT(std::complex<Real>* input, Real* output);
+    void Convolute(Real* func, const ComplexVector& kern);
+    void Deconvolute(Real* func, const ComplexVector& kern);
+    void Correlate(Real* func, const ComplexVector& kern);
+
+    // ... whether the buffer can be used by the zero-copy transforms
+    static bool IsAligned(const void* buffer);
 
   private:
     ComplexVector fKern;          // transformed response function
@@ -75,24 +172,48 @@ namespace util {
     const void* rPlan;
     int fFitBins; // Bins used for peak fit
 
-    gshf::MarqFitAlg* fMarqFitAlg;
+    // ... batched transforms (falling back to the single transform plans)
+    int fHowMany;
+    void* fManyIn;
+    void* fManyOut;
+    const void* fManyPlan;
+    const void* rManyPlan;
+
+    std::unique_ptr<gshf::MarqFitAlg> fMarqFitAlg; // only in validation mode
+
+    template <class T>
+    std::vector<T*> BlockWaveforms(std::vector<T>& block) const;
+    template <class T>
+    std::vector<T*> ListWaveforms(std::vector<std::vector<T>>& funcs) const;
+    void CheckKernelSize(const ComplexVector& kern) const;
+    void CheckAligned(const void* buffer) const;
+    template <class T>
+    T FitPeakCorrelation(std::vector<T>& correlation);
+    template <class T, class Op>
+    void TransformMany(const std::vector<T*>& waveforms, Op kernelOp);
+    template <class T, class Op>
+    void OverlapSave(std::vector<T>& func, int nPost, int nPre, Op kernelOp);
   };
 
+  using LArFFTW = BasicLArFFTW<double>; // double precision transforms
+  using LArFFTWF = BasicLArFFTW<float>; // single precision transforms
+
 } // end namespace util
 
 // -----------------------------------------------------------------------------
 // ~~~~ Do Forward Fourier Transform - DoFFT( REAL In )
 // -----------------------------------------------------------------------------
+template <typename Real>
 template <class T>
-inline void util::LArFFTW::DoFFT(std::vector<T>& input)
+inline void util::BasicLArFFTW<Real>::DoFFT(std::vector<T>& input)
 {
   // ..set point
   for (size_t p = 0; p < input.size(); ++p) {
-    ((double*)fIn)[p] = input[p];
+    ((Real*)fIn)[p] = input[p];
   }
 
   // ..transform (using the New-array Execute Functions)
-  fftw_execute_dft_r2c((fftw_plan)fPlan, (double*)fIn, (fftw_complex*)fOut);
+  FFTW::ExecuteR2C(fPlan, (Real*)fIn, (Complex*)fOut);
 
   return;
 }
@@ -100,20 +221,21 @@ inline void util::LArFFTW::DoFFT(std::vector<T>& input)
 // -----------------------------------------------------------------------------
 // ~~~~ Do Forward Fourier Transform - DoFFT( REAL In, COMPLEX Out )
 // -----------------------------------------------------------------------------
+template <typename Real>
 template <class T>
-inline void util::LArFFTW::DoFFT(std::vector<T>& input, ComplexVector& output)
+inline void util::BasicLArFFTW<Real>::DoFFT(std::vector<T>& input, ComplexVector& output)
 {
   // ..set point
   for (size_t p = 0; p < input.size(); ++p) {
-    ((double*)fIn)[p] = input[p];
+    ((Real*)fIn)[p] = input[p];
   }
 
   // ..transform (using the New-array Execute Functions)
-  fftw_execute_dft_r2c((fftw_plan)fPlan, (double*)fIn, (fftw_complex*)fOut);
+  FFTW::ExecuteR2C(fPlan, (Real*)fIn, (Complex*)fOut);
 
   for (int i = 0; i < fFreqSize; ++i) {
-    output[i].real(((fftw_complex*)fOut)[i][0]);
-    output[i].imag(((fftw_complex*)fOut)[i][1]);
+    output[i].real(((Complex*)fOut)[i][0]);
+    output[i].imag(((Complex*)fOut)[i][1]);
   }
 
   return;
@@ -122,15 +244,16 @@ inline void util::LArFFTW::DoFFT(std::vector<T>& input, ComplexVector& output)
 // -----------------------------------------------------------------------------
 // ~~~~ Do Inverse Fourier Transform - DoInvFFT( REAL Out )
 // -----------------------------------------------------------------------------
+template <typename Real>
 template <class T>
-inline void util::LArFFTW::DoInvFFT(std::vector<T>& output)
+inline void util::BasicLArFFTW<Real>::DoInvFFT(std::vector<T>& output)
 {
   // ..transform (using the New-array Execute Functions)
-  fftw_execute_dft_c2r((fftw_plan)rPlan, (fftw_complex*)rIn, (double*)rOut);
+  FFTW::ExecuteC2R(rPlan, (Complex*)rIn, (Real*)rOut);
 
   // ..get point real
-  double factor = 1.0 / (double)fSize;
-  const double* array = (const double*)(rOut);
+  Real factor = 1.0 / (Real)fSize;
+  const Real* array = (const Real*)(rOut);
   for (int i = 0; i < fSize; ++i) {
     output[i] = factor * array[i];
   }
@@ -141,21 +264,22 @@ inline void util::LArFFTW::DoInvFFT(std::vector<T>& output)
 // -----------------------------------------------------------------------------
 // ~~~~ Do Inverse Fourier Transform - DoInvFFT( COMPLEX In, REAL Out )
 // -----------------------------------------------------------------------------
+template <typename Real>
 template <class T>
-inline void util::LArFFTW::DoInvFFT(ComplexVector& input, std::vector<T>& output)
+inline void util::BasicLArFFTW<Real>::DoInvFFT(ComplexVector& input, std::vector<T>& output)
 {
   // ..set point complex
   for (int i = 0; i < fFreqSize; ++i) {
-    ((fftw_complex*)rIn)[i][0] = input[i].real();
-    ((fftw_complex*)rIn)[i][1] = input[i].imag();
+    ((Complex*)rIn)[i][0] = input[i].real();
+    ((Complex*)rIn)[i][1] = input[i].imag();
   }
 
   // ..transform (using the New-array Execute Functions)
-  fftw_execute_dft_c2r((fftw_plan)rPlan, (fftw_complex*)rIn, (double*)rOut);
+  FFTW::ExecuteC2R(rPlan, (Complex*)rIn, (Real*)rOut);
 
   // ..get point real
-  double factor = 1.0 / (double)fSize;
-  const double* array = (const double*)(rOut);
+  Real factor = 1.0 / (Real)fSize;
+  const Real* array = (const Real*)(rOut);
   for (int i = 0; i < fSize; ++i) {
     output[i] = factor * array[i];
   }
@@ -166,8 +290,9 @@ inline void util::LArFFTW::DoInvFFT(ComplexVector& input, std::vector<T>& output
 // -----------------------------------------------------------------------------
 // ~~~~ Do Convolution: using transformed response function
 // -----------------------------------------------------------------------------
+template <typename Real>
 template <class T>
-inline void util::LArFFTW::Convolute(std::vector<T>& func, const ComplexVector& kern)
+inline void util::BasicLArFFTW<Real>::Convolute(std::vector<T>& func, const ComplexVector& kern)
 {
 
   // ... Make sure that time series and kernel have the correct size.
@@ -180,10 +305,10 @@ inline void util::LArFFTW::Convolute(std::vector<T>& func, const ComplexVector&
 
   // ..perform the convolution
   for (int i = 0; i < fFreqSize; ++i) {
-    double re = ((fftw_complex*)fOut)[i][0];
-    double im = ((fftw_complex*)fOut)[i][1];
-    ((fftw_complex*)rIn)[i][0] = re * kern[i].real() - im * kern[i].imag();
-    ((fftw_complex*)rIn)[i][1] = re * kern[i].imag() + im * kern[i].real();
+    Real re = ((Complex*)fOut)[i][0];
+    Real im = ((Complex*)fOut)[i][1];
+    ((Complex*)rIn)[i][0] = re * kern[i].real() - im * kern[i].imag();
+    ((Complex*)rIn)[i][1] = re * kern[i].imag() + im * kern[i].real();
   }
 
   DoInvFFT(func);
@@ -192,8 +317,9 @@ inline void util::LArFFTW::Convolute(std::vector<T>& func, const ComplexVector&
 // -----------------------------------------------------------------------------
 // ~~~~ Do Convolution: using all time-domain information
 // -----------------------------------------------------------------------------
+template <typename Real>
 template <class T>
-inline void util::LArFFTW::Convolute(std::vector<T>& func1, std::vector<T>& func2)
+inline void util::BasicLArFFTW<Real>::Convolute(std::vector<T>& func1, std::vector<T>& func2)
 {
 
   // ... Make sure that time series has the correct size.
@@ -204,17 +330,17 @@ inline void util::LArFFTW::Convolute(std::vector<T>& func1, std::vector<T>& func
 
   DoFFT(func2);
   for (int i = 0; i < fFreqSize; ++i) {
-    fKern[i].real(((fftw_complex*)fOut)[i][0]);
-    fKern[i].imag(((fftw_complex*)fOut)[i][1]);
+    fKern[i].real(((Complex*)fOut)[i][0]);
+    fKern[i].imag(((Complex*)fOut)[i][1]);
   }
   DoFFT(func1);
 
   // ..perform the convolution
   for (int i = 0; i < fFreqSize; ++i) {
-    double re = ((fftw_complex*)fOut)[i][0];
-    double im = ((fftw_complex*)fOut)[i][1];
-    ((fftw_complex*)rIn)[i][0] = re * fKern[i].real() - im * fKern[i].imag();
-    ((fftw_complex*)rIn)[i][1] = re * fKern[i].imag() + im * fKern[i].real();
+    Real re = ((Complex*)fOut)[i][0];
+    Real im = ((Complex*)fOut)[i][1];
+    ((Complex*)rIn)[i][0] = re * fKern[i].real() - im * fKern[i].imag();
+    ((Complex*)rIn)[i][1] = re * fKern[i].imag() + im * fKern[i].real();
   }
 
   DoInvFFT(func1);
@@ -223,8 +349,9 @@ inline void util::LArFFTW::Convolute(std::vector<T>& func1, std::vector<T>& func
 // -----------------------------------------------------------------------------
 // ~~~~ Do Deconvolution: using transformed response function
 // -----------------------------------------------------------------------------
+template <typename Real>
 template <class T>
-inline void util::LArFFTW::Deconvolute(std::vector<T>& func, const ComplexVector& kern)
+inline void util::BasicLArFFTW<Real>::Deconvolute(std::vector<T>& func, const ComplexVector& kern)
 {
 
   // ... Make sure that time series and kernel have the correct size.
@@ -236,15 +363,15 @@ inline void util::LArFFTW::Deconvolute(std::vector<T>& func, const ComplexVector
   DoFFT(func);
 
   // ..perform the deconvolution
-  double a, b, c, d, e;
+  Real a, b, c, d, e;
   for (int i = 0; i < fFreqSize; ++i) {
-    a = ((fftw_complex*)fOut)[i][0];
-    b = ((fftw_complex*)fOut)[i][1];
+    a = ((Complex*)fOut)[i][0];
+    b = ((Complex*)fOut)[i][1];
     c = kern[i].real();
     d = kern[i].imag();
     e = 1. / (c * c + d * d);
-    ((fftw_complex*)rIn)[i][0] = (a * c + b * d) * e;
-    ((fftw_complex*)rIn)[i][1] = (b * c - a * d) * e;
+    ((Complex*)rIn)[i][0] = (a * c + b * d) * e;
+    ((Complex*)rIn)[i][1] = (b * c - a * d) * e;
   }
 
   DoInvFFT(func);
@@ -253,8 +380,9 @@ inline void util::LArFFTW::Deconvolute(std::vector<T>& func, const ComplexVector
 // -----------------------------------------------------------------------------
 // ~~~~ Do Deconvolution: using all time domain information
 // -----------------------------------------------------------------------------
+template <typename Real>
 template <class T>
-inline void util::LArFFTW::Deconvolute(std::vector<T>& func, std::vector<T>& resp)
+inline void util::BasicLArFFTW<Real>::Deconvolute(std::vector<T>& func, std::vector<T>& resp)
 {
 
   // ... Make sure that time series has the correct size.
@@ -265,21 +393,21 @@ inline void util::LArFFTW::Deconvolute(std::vector<T>& func, std::vector<T>& res
 
   DoFFT(resp);
   for (int i = 0; i < fFreqSize; ++i) {
-    fKern[i].real(((fftw_complex*)fOut)[i][0]);
-    fKern[i].imag(((fftw_complex*)fOut)[i][1]);
+    fKern[i].real(((Complex*)fOut)[i][0]);
+    fKern[i].imag(((Complex*)fOut)[i][1]);
   }
   DoFFT(func);
 
   // ..perform the deconvolution
-  double a, b, c, d, e;
+  Real a, b, c, d, e;
   for (int i = 0; i < fFreqSize; ++i) {
-    a = ((fftw_complex*)fOut)[i][0];
-    b = ((fftw_complex*)fOut)[i][1];
+    a = ((Complex*)fOut)[i][0];
+    b = ((Complex*)fOut)[i][1];
     c = fKern[i].real();
     d = fKern[i].imag();
     e = 1. / (c * c + d * d);
-    ((fftw_complex*)rIn)[i][0] = (a * c + b * d) * e;
-    ((fftw_complex*)rIn)[i][1] = (b * c - a * d) * e;
+    ((Complex*)rIn)[i][0] = (a * c + b * d) * e;
+    ((Complex*)rIn)[i][1] = (b * c - a * d) * e;
   }
 
   DoInvFFT(func);
@@ -288,8 +416,9 @@ inline void util::LArFFTW::Deconvolute(std::vector<T>& func, std::vector<T>& res
 // -----------------------------------------------------------------------------
 // ~~~~ Do Deconvolution: using transformed response function
 // -----------------------------------------------------------------------------
+template <typename Real>
 template <class T>
-inline void util::LArFFTW::Correlate(std::vector<T>& func, const ComplexVector& kern)
+inline void util::BasicLArFFTW<Real>::Correlate(std::vector<T>& func, const ComplexVector& kern)
 {
 
   // ... Make sure that time series and kernel have the correct size.
@@ -302,10 +431,10 @@ inline void util::LArFFTW::Correlate(std::vector<T>& func, const ComplexVector&
 
   // ..perform the correlation
   for (int i = 0; i < fFreqSize; ++i) {
-    double re = ((fftw_complex*)fOut)[i][0];
-    double im = ((fftw_complex*)fOut)[i][1];
-    ((fftw_complex*)rIn)[i][0] = re * kern[i].real() + im * kern[i].imag();
-    ((fftw_complex*)rIn)[i][1] = -re * kern[i].imag() + im * kern[i].real();
+    Real re = ((Complex*)fOut)[i][0];
+    Real im = ((Complex*)fOut)[i][1];
+    ((Complex*)rIn)[i][0] = re * kern[i].real() + im * kern[i].imag();
+    ((Complex*)rIn)[i][1] = -re * kern[i].imag() + im * kern[i].real();
   }
 
   DoInvFFT(func);
@@ -314,8 +443,9 @@ inline void util::LArFFTW::Correlate(std::vector<T>& func, const ComplexVector&
 // -----------------------------------------------------------------------------
 // ~~~~ Do Correlation: using all time domain information
 // -----------------------------------------------------------------------------
+template <typename Real>
 template <class T>
-inline void util::LArFFTW::Correlate(std::vector<T>& func1, std::vector<T>& func2)
+inline void util::BasicLArFFTW<Real>::Correlate(std::vector<T>& func1, std::vector<T>& func2)
 {
 
   // ... Make sure that time series has the correct size.
@@ -326,17 +456,17 @@ inline void util::LArFFTW::Correlate(std::vector<T>& func1, std::vector<T>& func
 
   DoFFT(func2);
   for (int i = 0; i < fFreqSize; ++i) {
-    fKern[i].real(((fftw_complex*)fOut)[i][0]);
-    fKern[i].imag(((fftw_complex*)fOut)[i][1]);
+    fKern[i].real(((Complex*)fOut)[i][0]);
+    fKern[i].imag(((Complex*)fOut)[i][1]);
   }
   DoFFT(func1);
 
   // ..perform the correlation
   for (int i = 0; i < fFreqSize; ++i) {
-    double re = ((fftw_complex*)fOut)[i][0];
-    double im = ((fftw_complex*)fOut)[i][1];
-    ((fftw_complex*)rIn)[i][0] = re * fKern[i].real() + im * fKern[i].imag();
-    ((fftw_complex*)rIn)[i][1] = -re * fKern[i].imag() + im * fKern[i].real();
+    Real re = ((Complex*)fOut)[i][0];
+    Real im = ((Complex*)fOut)[i][1];
+    ((Complex*)rIn)[i][0] = re * fKern[i].real() + im * fKern[i].imag();
+    ((Complex*)rIn)[i][1] = -re * fKern[i].imag() + im * fKern[i].real();
   }
 
   DoInvFFT(func1);
@@ -345,8 +475,9 @@ inline void util::LArFFTW::Correlate(std::vector<T>& func1, std::vector<T>& func
 // -----------------------------------------------------------------------------
 // ~~~~ Shifts real vectors using above ShiftData function
 // -----------------------------------------------------------------------------
+template <typename Real>
 template <class T>
-inline void util::LArFFTW::ShiftData(std::vector<T>& input, double shift)
+inline void util::BasicLArFFTW<Real>::ShiftData(std::vector<T>& input, double shift)
 {
   DoFFT(input, fCompTemp);
   ShiftData(fCompTemp, shift);
@@ -360,8 +491,11 @@ inline void util::LArFFTW::ShiftData(std::vector<T>& input, double shift)
 //      translation.  Shape1 is translated over shape2 and is replaced with the
 //      sum, or the translated result if add = false
 // -----------------------------------------------------------------------------
+template <typename Real>
 template <class T>
-inline void util::LArFFTW::AlignedSum(std::vector<T>& shape1, std::vector<T>& shape2, bool add)
+inline void util::BasicLArFFTW<Real>::AlignedSum(std::vector<T>& shape1,
+                                                 std::vector<T>& shape2,
+                                                 bool add)
 {
   double shift = PeakCorrelation(shape1, shape2);
 
@@ -376,19 +510,36 @@ inline void util::LArFFTW::AlignedSum(std::vector<T>& shape1, std::vector<T>& sh
 
 // -----------------------------------------------------------------------------
 // ~~~~ Returns the length of the translation at which the correlation
-//      of 2 signals is maximal.
+//      of 2 signals is maximal (a peak exactly at sample i is at i + 0.5).
+// -----------------------------------------------------------------------------
+template <typename Real>
+template <class T>
+inline T util::BasicLArFFTW<Real>::PeakCorrelation(std::vector<T>& shape1, std::vector<T>& shape2)
+{
+  std::vector<T> holder = shape1;
+  Correlate(holder, shape2);
+
+  T const peak = CorrelationPeak(holder) + 0.5;
+  if (!fMarqFitAlg) return peak;
+
+  T const fitPeak = FitPeakCorrelation(holder);
+  mf::LogDebug("LArFFTW") << "Correlation peak at " << fitPeak << " from fit, " << peak
+                          << " interpolated (difference: " << (peak - fitPeak) << ")";
+  return fitPeak;
+}
+
+// -----------------------------------------------------------------------------
+// ~~~~ Gaussian fit of the correlation around its maximum.
 // -----------------------------------------------------------------------------
+template <typename Real>
 template <class T>
-inline T util::LArFFTW::PeakCorrelation(std::vector<T>& shape1, std::vector<T>& shape2)
+inline T util::BasicLArFFTW<Real>::FitPeakCorrelation(std::vector<T>& holder)
 {
   float chiSqr = std::numeric_limits<float>::max();
   float dchiSqr = std::numeric_limits<float>::max();
   const float chiCut = 1e-3;
   float lambda = 0.001; // Marquardt damping parameter
-  std::vector<float> p;
-
-  std::vector<T> holder = shape1;
-  Correlate(holder, shape2);
+  std::vector<float> p(3);
 
   int maxT = max_element(holder.begin(), holder.end()) - holder.begin();
   float startT = maxT - fFitBins / 2;
@@ -430,4 +581,233 @@ inline T util::LArFFTW::PeakCorrelation(std::vector<T>& shape1, std::vector<T>&
 
   return p1 + 0.5 + startT;
 }
+
+// -----------------------------------------------------------------------------
+// ~~~~ Batched transforms: waveform pointers
+// -----------------------------------------------------------------------------
+template <typename Real>
+template <class T>
+inline std::vector<T*> util::BasicLArFFTW<Real>::BlockWaveforms(std::vector<T>& block) const
+{
+  if (block.size() % fSize != 0) {
+    throw cet::exception("LArFFTW") << "Bad block size = " << block.size()
+                                    << " (not a multiple of " << fSize << ")\n";
+  }
+  std::vector<T*> waveforms(block.size() / fSize);
+  for (std::size_t c = 0; c < waveforms.size(); ++c)
+    waveforms[c] = block.data() + c * fSize;
+  return waveforms;
+}
+
+template <typename Real>
+template <class T>
+inline std::vector<T*> util::BasicLArFFTW<Real>::ListWaveforms(
+  std::vector<std::vector<T>>& funcs) const
+{
+  std::vector<T*> waveforms(funcs.size());
+  for (std::size_t c = 0; c < funcs.size(); ++c) {
+    int n = funcs[c].size();
+    if (n != fSize) {
+      throw cet::exception("LArFFTW") << "Bad time series size = " << n << " (#" << c << ")\n";
+    }
+    waveforms[c] = funcs[c].data();
+  }
+  return waveforms;
+}
+
+// -----------------------------------------------------------------------------
+// ~~~~ Batched transforms: forward, kernel operation and inverse on each batch
+// -----------------------------------------------------------------------------
+template <typename Real>
+template <class T, class Op>
+inline void util::BasicLArFFTW<Real>::TransformMany(const std::vector<T*>& waveforms, Op kernelOp)
+{
+  Real* real = (Real*)fManyIn;
+  Complex* spectra = (Complex*)fManyOut;
+  const Real factor = 1.0 / (Real)fSize;
+
+  for (std::size_t first = 0; first < waveforms.size(); first += fHowMany) {
+    const std::size_t n = std::min<std::size_t>(fHowMany, waveforms.size() - first);
+
+    // ..set points; the unused waveforms of the last batch are zeroed
+    for (std::size_t c = 0; c < n; ++c)
+      std::copy(waveforms[first + c], waveforms[first + c] + fSize, real + c * fSize);
+    std::fill(real + n * fSize, real + fHowMany * fSize, 0.);
+
+    FFTW::ExecuteR2C(fManyPlan, real, spectra);
+
+    for (std::size_t c = 0; c < n; ++c) {
+      Complex* spectrum = spectra + c * fFreqSize;
+      for (int i = 0; i < fFreqSize; ++i)
+        kernelOp(spectrum[i], i);
+    }
+
+    FFTW::ExecuteC2R(rManyPlan, spectra, real);
+
+    // ..get points real
+    for (std::size_t c = 0; c < n; ++c) {
+      const Real* array = real + c * fSize;
+      T* output = waveforms[first + c];
+      for (int i = 0; i < fSize; ++i)
+        output[i] = factor * array[i];
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// ~~~~ Batched convolution: using transformed response function
+// -----------------------------------------------------------------------------
+template <typename Real>
+template <class T>
+inline void util::BasicLArFFTW<Real>::ConvoluteMany(std::vector<T>& block,
+                                                    const ComplexVector& kern)
+{
+  CheckKernelSize(kern);
+  TransformMany(BlockWaveforms(block), [&kern](Complex& z, int i) {
+    Real re = z[0];
+    Real im = z[1];
+    z[0] = re * kern[i].real() - im * kern[i].imag();
+    z[1] = re * kern[i].imag() + im * kern[i].real();
+  });
+}
+
+template <typename Real>
+template <class T>
+inline void util::BasicLArFFTW<Real>::ConvoluteMany(std::vector<std::vector<T>>& funcs,
+                                                    const ComplexVector& kern)
+{
+  CheckKernelSize(kern);
+  TransformMany(ListWaveforms(funcs), [&kern](Complex& z, int i) {
+    Real re = z[0];
+    Real im = z[1];
+    z[0] = re * kern[i].real() - im * kern[i].imag();
+    z[1] = re * kern[i].imag() + im * kern[i].real();
+  });
+}
+
+// -----------------------------------------------------------------------------
+// ~~~~ Batched deconvolution: using transformed response function
+// -----------------------------------------------------------------------------
+template <typename Real>
+template <class T>
+inline void util::BasicLArFFTW<Real>::DeconvoluteMany(std::vector<T>& block,
+                                                      const ComplexVector& kern)
+{
+  CheckKernelSize(kern);
+  TransformMany(BlockWaveforms(block), [&kern](Complex& z, int i) {
+    Real a = z[0];
+    Real b = z[1];
+    Real c = kern[i].real();
+    Real d = kern[i].imag();
+    Real e = 1. / (c * c + d * d);
+    z[0] = (a * c + b * d) * e;
+    z[1] = (b * c - a * d) * e;
+  });
+}
+
+template <typename Real>
+template <class T>
+inline void util::BasicLArFFTW<Real>::DeconvoluteMany(std::vector<std::vector<T>>& funcs,
+                                                      const ComplexVector& kern)
+{
+  CheckKernelSize(kern);
+  TransformMany(ListWaveforms(funcs), [&kern](Complex& z, int i) {
+    Real a = z[0];
+    Real b = z[1];
+    Real c = kern[i].real();
+    Real d = kern[i].imag();
+    Real e = 1. / (c * c + d * d);
+    z[0] = (a * c + b * d) * e;
+    z[1] = (b * c - a * d) * e;
+  });
+}
+
+
+// -----------------------------------------------------------------------------
+// ~~~~ Overlap-save: the output ticks [s, s + step) come from the circular
+//      transform of the input ticks [s - nPost, s + step + nPre), where they
+//      are free of wrap-around; the func ticks still needed as input after
+//      being overwritten by the output are kept in `history`
+// -----------------------------------------------------------------------------
+template <typename Real>
+template <class T, class Op>
+inline void util::BasicLArFFTW<Real>::OverlapSave(std::vector<T>& func,
+                                                  int nPost,
+                                                  int nPre,
+                                                  Op kernelOp)
+{
+  const int step = fSize - nPre - nPost;
+  if (nPre < 0 || nPost < 0 || step <= 0) {
+    throw cet::exception("LArFFTW") << "Bad kernel extent [-" << nPre << ", " << nPost
+                                    << "] for transform size " << fSize << "\n";
+  }
+
+  Real* segment = (Real*)fIn;
+  Complex* spectrum = (Complex*)fOut;
+  Real* output = (Real*)rOut;
+  const Real factor = 1.0 / (Real)fSize;
+  const std::size_t length = func.size();
+  std::vector<Real> history(nPost, 0.);
+
+  for (std::size_t s = 0; s < length; s += step) {
+
+    // ..set points: past ticks, then the ones of this block and its look-ahead
+    std::copy(history.begin(), history.end(), segment);
+    for (int j = 0; j < step + nPre; ++j)
+      segment[nPost + j] = (s + j < length) ? (Real)func[s + j] : 0.;
+    std::copy(segment + step, segment + step + nPost, history.begin());
+
+    FFTW::ExecuteR2C(fPlan, segment, spectrum);
+    for (int i = 0; i < fFreqSize; ++i)
+      kernelOp(spectrum[i], i);
+    FFTW::ExecuteC2R(rPlan, spectrum, output);
+
+    // ..get points real, past the ticks affected by the wrap-around
+    const std::size_t n = std::min<std::size_t>(step, length - s);
+    for (std::size_t j = 0; j < n; ++j)
+      func[s + j] = factor * output[nPost + j];
+  }
+}
+
+// -----------------------------------------------------------------------------
+// ~~~~ Streaming convolution: using transformed response function
+// -----------------------------------------------------------------------------
+template <typename Real>
+template <class T>
+inline void util::BasicLArFFTW<Real>::ConvoluteStream(std::vector<T>& func,
+                                                      const ComplexVector& kern,
+                                                      int nPost,
+                                                      int nPre)
+{
+  CheckKernelSize(kern);
+  OverlapSave(func, nPost, nPre, [&kern](Complex& z, int i) {
+    Real re = z[0];
+    Real im = z[1];
+    z[0] = re * kern[i].real() - im * kern[i].imag();
+    z[1] = re * kern[i].imag() + im * kern[i].real();
+  });
+}
+
+// -----------------------------------------------------------------------------
+// ~~~~ Streaming deconvolution: using transformed response function
+// -----------------------------------------------------------------------------
+template <typename Real>
+template <class T>
+inline void util::BasicLArFFTW<Real>::DeconvoluteStream(std::vector<T>& func,
+                                                        const ComplexVector& kern,
+                                                        int nPost,
+                                                        int nPre)
+{
+  CheckKernelSize(kern);
+  OverlapSave(func, nPost, nPre, [&kern](Complex& z, int i) {
+    Real a = z[0];
+    Real b = z[1];
+    Real c = kern[i].real();
+    Real d = kern[i].imag();
+    Real e = 1. / (c * c + d * d);
+    z[0] = (a * c + b * d) * e;
+    z[1] = (b * c - a * d) * e;
+  });
+}
+
 #endif
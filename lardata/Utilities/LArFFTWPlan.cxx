@@ -1,48 +1,272 @@
 #include "lardata/Utilities/LArFFTWPlan.h"
 
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
 using std::string;
-std::mutex util::LArFFTWPlan::mutex_;
 
-util::LArFFTWPlan::LArFFTWPlan(int transformSize, const std::string& option)
-  : fSize(transformSize), fOption(option)
+namespace {
+  string WisdomDirFromEnvironment()
+  {
+    const char* dir = std::getenv("LARFFTW_WISDOM_DIR");
+    return dir ? dir : "";
+  }
+}
+
+void* util::details::FFTWLib<double>::Malloc(std::size_t n)
+{
+  return fftw_malloc(n);
+}
+
+void util::details::FFTWLib<double>::Free(void* p)
+{
+  fftw_free(p);
+}
+
+void util::details::FFTWLib<double>::DestroyPlan(void* plan)
+{
+  fftw_destroy_plan((Plan)plan);
+}
+
+int util::details::FFTWLib<double>::ImportWisdom(const char* path)
+{
+  return fftw_import_wisdom_from_filename(path);
+}
+
+int util::details::FFTWLib<double>::ExportWisdom(const char* path)
+{
+  return fftw_export_wisdom_to_filename(path);
+}
+
+int util::details::FFTWLib<double>::AlignmentOf(double* p)
+{
+  return fftw_alignment_of(p);
+}
+
+auto util::details::FFTWLib<double>::PlanManyR2C(int n,
+                                                  int howMany,
+                                                  double* in,
+                                                  Complex* out,
+                                                  unsigned int flags) -> Plan
+{
+  return fftw_plan_many_dft_r2c(
+    1, &n, howMany, in, nullptr, 1, n, out, nullptr, 1, n / 2 + 1, flags);
+}
+
+auto util::details::FFTWLib<double>::PlanManyC2R(int n,
+                                                  int howMany,
+                                                  Complex* in,
+                                                  double* out,
+                                                  unsigned int flags) -> Plan
+{
+  return fftw_plan_many_dft_c2r(
+    1, &n, howMany, in, nullptr, 1, n / 2 + 1, out, nullptr, 1, n, flags);
+}
+
+void util::details::FFTWLib<double>::ExecuteR2C(const void* plan, double* in, Complex* out)
+{
+  fftw_execute_dft_r2c((Plan)plan, in, out);
+}
+
+void util::details::FFTWLib<double>::ExecuteC2R(const void* plan, Complex* in, double* out)
+{
+  fftw_execute_dft_c2r((Plan)plan, in, out);
+}
+
+void* util::details::FFTWLib<float>::Malloc(std::size_t n)
 {
+  return fftwf_malloc(n);
+}
 
+void util::details::FFTWLib<float>::Free(void* p)
+{
+  fftwf_free(p);
+}
+
+void util::details::FFTWLib<float>::DestroyPlan(void* plan)
+{
+  fftwf_destroy_plan((Plan)plan);
+}
+
+int util::details::FFTWLib<float>::ImportWisdom(const char* path)
+{
+  return fftwf_import_wisdom_from_filename(path);
+}
+
+int util::details::FFTWLib<float>::ExportWisdom(const char* path)
+{
+  return fftwf_export_wisdom_to_filename(path);
+}
+
+int util::details::FFTWLib<float>::AlignmentOf(float* p)
+{
+  return fftwf_alignment_of(p);
+}
+
+auto util::details::FFTWLib<float>::PlanManyR2C(int n,
+                                                 int howMany,
+                                                 float* in,
+                                                 Complex* out,
+                                                 unsigned int flags) -> Plan
+{
+  return fftwf_plan_many_dft_r2c(
+    1, &n, howMany, in, nullptr, 1, n, out, nullptr, 1, n / 2 + 1, flags);
+}
+
+auto util::details::FFTWLib<float>::PlanManyC2R(int n,
+                                                 int howMany,
+                                                 Complex* in,
+                                                 float* out,
+                                                 unsigned int flags) -> Plan
+{
+  return fftwf_plan_many_dft_c2r(
+    1, &n, howMany, in, nullptr, 1, n / 2 + 1, out, nullptr, 1, n, flags);
+}
+
+void util::details::FFTWLib<float>::ExecuteR2C(const void* plan, float* in, Complex* out)
+{
+  fftwf_execute_dft_r2c((Plan)plan, in, out);
+}
+
+void util::details::FFTWLib<float>::ExecuteC2R(const void* plan, Complex* in, float* out)
+{
+  fftwf_execute_dft_c2r((Plan)plan, in, out);
+}
+
+std::mutex util::LArFFTWPlanBase::mutex_;
+string util::LArFFTWPlanBase::fWisdomDir = WisdomDirFromEnvironment();
+
+void util::LArFFTWPlanBase::SetWisdomDirectory(const string& dir)
+{
   std::lock_guard<std::mutex> lock(mutex_);
+  fWisdomDir = dir;
+}
+
+string util::LArFFTWPlanBase::WisdomDirectory()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return fWisdomDir;
+}
+
+string util::LArFFTWPlanBase::CPUFeatures()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) return "avx512";
+  if (__builtin_cpu_supports("avx2")) return __builtin_cpu_supports("fma") ? "avx2fma" : "avx2";
+  if (__builtin_cpu_supports("avx")) return "avx";
+  return "sse2";
+#elif defined(__aarch64__)
+  return "neon";
+#else
+  return "generic";
+#endif
+}
+
+template <typename Real>
+util::BasicLArFFTWPlan<Real>::BasicLArFFTWPlan(int transformSize,
+                                               const std::string& option,
+                                               int howMany)
+  : fManyPlan(nullptr)
+  , rManyPlan(nullptr)
+  , fManyIn(nullptr)
+  , fManyOut(nullptr)
+  , rManyIn(nullptr)
+  , rManyOut(nullptr)
+  , fSize(transformSize)
+  , fHowMany(std::max(howMany, 1))
+  , fOption(option)
+{
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  using Complex = typename FFTW::Complex;
 
   fFreqSize = fSize / 2 + 1;
   fN = new int[1];
   fN[0] = fSize;
 
-  fIn = fftw_malloc(sizeof(double) * fSize);
-  fOut = fftw_malloc(sizeof(fftw_complex) * fFreqSize);
-  fPlan = (void*)fftw_plan_dft_r2c(1, fN, (double*)fIn, (fftw_complex*)fOut, MapFFTWOption());
+  const unsigned int flags = MapFFTWOption();
+
+  // ... reuse the planning of previous jobs, if cached
+  const string wisdomFile = WisdomFile(flags);
+  const bool haveWisdom = !wisdomFile.empty() && FFTW::ImportWisdom(wisdomFile.c_str());
+
+  fIn = FFTW::Malloc(sizeof(Real) * fSize);
+  fOut = FFTW::Malloc(sizeof(Complex) * fFreqSize);
+  fPlan = (void*)FFTW::PlanManyR2C(fSize, 1, (Real*)fIn, (Complex*)fOut, flags);
+
+  rIn = FFTW::Malloc(sizeof(Complex) * fFreqSize);
+  rOut = FFTW::Malloc(sizeof(Real) * fSize);
+  rPlan = (void*)FFTW::PlanManyC2R(fSize, 1, (Complex*)rIn, (Real*)rOut, flags);
 
-  rIn = fftw_malloc(sizeof(fftw_complex) * fFreqSize);
-  rOut = fftw_malloc(sizeof(double) * fSize);
-  rPlan = (void*)fftw_plan_dft_c2r(1, fN, (fftw_complex*)rIn, (double*)rOut, MapFFTWOption());
+  if (fHowMany > 1) {
+    // ... batched plans: waveform i starts at i * fSize (real) or i * fFreqSize (complex)
+    fManyIn = FFTW::Malloc(sizeof(Real) * fSize * fHowMany);
+    fManyOut = FFTW::Malloc(sizeof(Complex) * fFreqSize * fHowMany);
+    fManyPlan =
+      (void*)FFTW::PlanManyR2C(fSize, fHowMany, (Real*)fManyIn, (Complex*)fManyOut, flags);
+
+    rManyIn = FFTW::Malloc(sizeof(Complex) * fFreqSize * fHowMany);
+    rManyOut = FFTW::Malloc(sizeof(Real) * fSize * fHowMany);
+    rManyPlan =
+      (void*)FFTW::PlanManyC2R(fSize, fHowMany, (Complex*)rManyIn, (Real*)rManyOut, flags);
+  }
+
+  // ... save the new wisdom; write and rename, so that concurrent jobs never
+  //     read a partial file
+  if (wisdomFile.empty() || haveWisdom) return;
+  const string tmpFile = wisdomFile + ".tmp" + std::to_string(::getpid());
+  if (!FFTW::ExportWisdom(tmpFile.c_str()) || std::rename(tmpFile.c_str(), wisdomFile.c_str())) {
+    std::remove(tmpFile.c_str());
+    mf::LogWarning("LArFFTWPlan") << "Could not save FFTW wisdom into '" << wisdomFile << "'";
+  }
 }
 
-util::LArFFTWPlan::~LArFFTWPlan()
+template <typename Real>
+util::BasicLArFFTWPlan<Real>::~BasicLArFFTWPlan()
 {
-  fftw_destroy_plan((fftw_plan)fPlan);
+  using Complex = typename FFTW::Complex;
+
+  FFTW::DestroyPlan(fPlan);
   fPlan = 0;
-  fftw_free(fIn);
+  FFTW::Free(fIn);
   fIn = 0;
-  fftw_free((fftw_complex*)fOut);
+  FFTW::Free((Complex*)fOut);
   fOut = 0;
 
-  fftw_destroy_plan((fftw_plan)rPlan);
+  FFTW::DestroyPlan(rPlan);
   rPlan = 0;
-  fftw_free((fftw_complex*)rIn);
+  FFTW::Free((Complex*)rIn);
   rIn = 0;
-  fftw_free(rOut);
+  FFTW::Free(rOut);
   rOut = 0;
 
+  if (fManyPlan) {
+    FFTW::DestroyPlan(fManyPlan);
+    fManyPlan = 0;
+    FFTW::Free(fManyIn);
+    fManyIn = 0;
+    FFTW::Free((Complex*)fManyOut);
+    fManyOut = 0;
+
+    FFTW::DestroyPlan(rManyPlan);
+    rManyPlan = 0;
+    FFTW::Free((Complex*)rManyIn);
+    rManyIn = 0;
+    FFTW::Free(rManyOut);
+    rManyOut = 0;
+  }
+
   delete[] fN;
   fN = 0;
 }
 
-unsigned int util::LArFFTWPlan::MapFFTWOption()
+template <typename Real>
+unsigned int util::BasicLArFFTWPlan<Real>::MapFFTWOption()
 {
   std::transform(fOption.begin(), fOption.end(), fOption.begin(), ::toupper);
   if (fOption.find("ES") != string::npos) return FFTW_ESTIMATE;
@@ -51,3 +275,25 @@ unsigned int util::LArFFTWPlan::MapFFTWOption()
   if (fOption.find("EX") != string::npos) return FFTW_EXHAUSTIVE;
   return FFTW_ESTIMATE;
 }
+
+// Wisdom is kept in one file per precision, size, batch, planning flags and
+// CPU; estimated plans do not benefit from it and get no file.
+template <typename Real>
+string util::BasicLArFFTWPlan<Real>::WisdomFile(unsigned int flags) const
+{
+  if (fWisdomDir.empty() || flags == FFTW_ESTIMATE) return {};
+
+  string rigor;
+  switch (flags) {
+  case FFTW_MEASURE: rigor = "measure"; break;
+  case FFTW_PATIENT: rigor = "patient"; break;
+  case FFTW_EXHAUSTIVE: rigor = "exhaustive"; break;
+  default: rigor = std::to_string(flags);
+  }
+
+  return fWisdomDir + "/larfftw_" + FFTW::Tag + "_" + std::to_string(fSize) + "x" +
+         std::to_string(fHowMany) + "_" + rigor + "_" + CPUFeatures() + ".wisdom";
+}
+
+template class util::BasicLArFFTWPlan<double>;
+template class util::BasicLArFFTWPlan<float>;
@@ -3,6 +3,7 @@
 
 // C/C++ standard libraries
 #include <algorithm>
+#include <cstddef>
 #include <mutex>
 #include <string>
 
@@ -10,11 +11,82 @@
 
 namespace util {
 
-  class LArFFTWPlan {
+  namespace details {
+
+    // ... Binding to the double (fftw_) or single (fftwf_) precision FFTW library.
+    //     The functions are defined in LArFFTWPlan.cxx, so that only this
+    //     library links to FFTW.
+    template <typename Real>
+    struct FFTWLib;
+
+    template <>
+    struct FFTWLib<double> {
+      using Complex = fftw_complex;
+      using Plan = fftw_plan;
+      static constexpr const char* Tag = "d";
+
+      static void* Malloc(std::size_t n);
+      static void Free(void* p);
+      static void DestroyPlan(void* plan);
+      static int ImportWisdom(const char* path);
+      static int ExportWisdom(const char* path);
+      static int AlignmentOf(double* p);
+
+      static Plan PlanManyR2C(int n, int howMany, double* in, Complex* out, unsigned int flags);
+      static Plan PlanManyC2R(int n, int howMany, Complex* in, double* out, unsigned int flags);
+      static void ExecuteR2C(const void* plan, double* in, Complex* out);
+      static void ExecuteC2R(const void* plan, Complex* in, double* out);
+    };
+
+    template <>
+    struct FFTWLib<float> {
+      using Complex = fftwf_complex;
+      using Plan = fftwf_plan;
+      static constexpr const char* Tag = "f";
+
+      static void* Malloc(std::size_t n);
+      static void Free(void* p);
+      static void DestroyPlan(void* plan);
+      static int ImportWisdom(const char* path);
+      static int ExportWisdom(const char* path);
+      static int AlignmentOf(float* p);
+
+      static Plan PlanManyR2C(int n, int howMany, float* in, Complex* out, unsigned int flags);
+      static Plan PlanManyC2R(int n, int howMany, Complex* in, float* out, unsigned int flags);
+      static void ExecuteR2C(const void* plan, float* in, Complex* out);
+      static void ExecuteC2R(const void* plan, Complex* in, float* out);
+    };
+
+  } // namespace details
+
+  // ... Settings common to the plans of all precisions.
+  class LArFFTWPlanBase {
 
   public:
-    LArFFTWPlan(int transformSize, const std::string& option);
-    ~LArFFTWPlan();
+    // ... Directory of the persistent FFTW wisdom cache; empty disables it.
+    //     It defaults to the value of the LARFFTW_WISDOM_DIR environment variable.
+    //     Plans other than FFTW_ESTIMATE import the wisdom for their size,
+    //     precision, planning flags and CPU features from there, and save it
+    //     there when it was not available yet.
+    static void SetWisdomDirectory(const std::string& dir);
+    static std::string WisdomDirectory();
+
+    // ... Short tag of the SIMD instruction sets of this CPU.
+    static std::string CPUFeatures();
+
+  protected:
+    static std::mutex mutex_;
+    static std::string fWisdomDir;
+  };
+
+  template <typename Real>
+  class BasicLArFFTWPlan : public LArFFTWPlanBase {
+
+  public:
+    // ... howMany > 1 also plans batched transforms of howMany contiguous
+    //     waveforms (channel-major), available as fManyPlan and rManyPlan.
+    BasicLArFFTWPlan(int transformSize, const std::string& option, int howMany = 1);
+    ~BasicLArFFTWPlan();
     void* fPlan;
     void* rPlan;
     void* fIn;
@@ -22,16 +94,33 @@ namespace util {
     void* rIn;
     void* rOut;
 
+    // ... batched plans (null if not requested)
+    void* fManyPlan;
+    void* rManyPlan;
+    void* fManyIn;
+    void* fManyOut;
+    void* rManyIn;
+    void* rManyOut;
+
+    int Size() const { return fSize; }
+    int HowMany() const { return fHowMany; }
+
   private:
-    static std::mutex mutex_;
+    using FFTW = details::FFTWLib<Real>;
+
     int fSize;     // size of transform
     int fFreqSize; // size of frequency space
+    int fHowMany;  // number of transforms in a batch
     int* fN;
     std::string fOption; // FFTW setting
 
     unsigned int MapFFTWOption();
+    std::string WisdomFile(unsigned int flags) const;
   };
 
+  using LArFFTWPlan = BasicLArFFTWPlan<double>; // double precision plans
+  using LArFFTWFPlan = BasicLArFFTWPlan<float>; // single precision plans
+
 } // end namespace util
 
 #endif
@@ -10,7 +10,53 @@
 
 #include "lardata/Utilities/SignalShaping.h"
 #include "cetlib_except/exception.h"
+#include "lardata/Utilities/LArFFTW.h"
+#include "lardata/Utilities/LArFFTWPlan.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
 #include <cmath>
+#include <memory>
+#include <mutex>
+
+//----------------------------------------------------------------------
+// Single precision transforms: plans shared by a pool of engines,
+// each used by one caller at a time.
+class util::SignalShaping::SinglePrecisionFFT {
+public:
+  using ComplexVector = util::LArFFTWF::ComplexVector;
+
+  SinglePrecisionFFT(int size, const std::string& option, bool validate);
+  ~SinglePrecisionFFT();
+
+  int Size() const { return fPlan.Size(); }
+  bool Validate() const { return fValidate; }
+  double MaxDeviation() const;
+  void RecordDeviation(double deviation);
+
+  template <class T>
+  void Convolute(std::vector<T>& func, const ComplexVector& kern);
+
+private:
+  util::LArFFTWFPlan fPlan;
+  bool fValidate;
+  mutable std::mutex fMutex;
+  std::vector<std::unique_ptr<util::LArFFTWF>> fIdle;
+  double fMaxDeviation;
+  unsigned int fNValidated;
+
+  std::unique_ptr<util::LArFFTWF> Acquire();
+  void Release(std::unique_ptr<util::LArFFTWF> engine);
+};
+
+//----------------------------------------------------------------------
+// Convolute a time series using one of the pooled engines.
+template <class T>
+void util::SignalShaping::SinglePrecisionFFT::Convolute(std::vector<T>& func,
+                                                        const ComplexVector& kern)
+{
+  std::unique_ptr<util::LArFFTWF> engine = Acquire();
+  engine->Convolute(func, kern);
+  Release(std::move(engine));
+}
 
 //----------------------------------------------------------------------
 // Constructor.
@@ -44,6 +90,11 @@ void util::SignalShaping::Reset()
   fConvKernel.clear();
   fFilter.clear();
   fDeconvKernel.clear();
+  fConvKernelSplit = SplitComplexKernel();
+  fDeconvKernelSplit = SplitComplexKernel();
+  fSinglePrecisionFFT.reset();
+  fConvKernelF.clear();
+  fDeconvKernelF.clear();
   //Set deconvolution polarity to + as default
   fDeconvKernelPolarity = +1;
 }
@@ -74,16 +125,14 @@ void util::SignalShaping::AddResponseFunction(const std::vector<double>& resp, b
     // This is the first response function.
     // Just calculate the fourier transform.
 
-    fConvKernel.resize(nticks / 2 + 1);
-    fft->DoFFT(fResponse, fConvKernel);
+    fConvKernel = *fft->CachedResponseTransform(fResponse);
   }
   else {
 
     // Not the first response function.
     // Calculate the fourier transform of new response function.
 
-    std::vector<TComplex> kern(nticks / 2 + 1);
-    fft->DoFFT(fResponse, kern);
+    std::vector<TComplex> const& kern = *fft->CachedResponseTransform(fResponse);
 
     // Update overall convolution kernel.
 
@@ -221,6 +270,20 @@ void util::SignalShaping::LockResponse() const
         << __func__ << ": unexpected FFT size, " << n << " vs. expected "
         << (2 * (fConvKernel.size() - 1)) << "\n";
 
+    // Prepare the split layout kernel.
+
+    fConvKernelSplit = SplitComplexKernel(fConvKernel);
+
+    // Prepare single precision transforms, if requested.
+
+    if (fft->SinglePrecision()) {
+      if (!fSinglePrecisionFFT || fSinglePrecisionFFT->Size() != fft->FFTSize()) {
+        fSinglePrecisionFFT = std::make_shared<SinglePrecisionFFT>(
+          fft->FFTSize(), fft->FFTOptions(), fft->ValidateSinglePrecision());
+      }
+      fConvKernelF = SinglePrecisionKernel(fConvKernel);
+    }
+
     // Set the lock flag.
 
     fResponseLocked = true;
@@ -259,16 +322,54 @@ void util::SignalShaping::CalculateDeconvKernel() const
                                             << " vs. " << fConvKernel.size() << "\n";
     }
 
+  // Look up the deconvolution kernel of this configuration, computing it
+  // if no other channel has done it yet.
+
+  using KernelCache_t = util::LArFFT::KernelCache_t;
+  KernelCache_t::Key_t key;
+  key.reserve(2 * (fConvKernel.size() + fFilter.size()) + fResponse.size() + 4);
+  key.push_back(KernelCache_t::kDeconvolutionKernel);
+  key.push_back(n);
+  key.push_back(fNorm);
+  key.push_back(fDeconvKernelPolarity);
+  key.insert(key.end(), fResponse.begin(), fResponse.end());
+  for (TComplex const& c : fConvKernel) {
+    key.push_back(c.Re());
+    key.push_back(c.Im());
+  }
+  for (TComplex const& c : fFilter) {
+    key.push_back(c.Re());
+    key.push_back(c.Im());
+  }
+  fDeconvKernel = *KernelCache_t::Instance().Get(
+    key, [this, &fft]() { return ComputeDeconvKernel(*fft); });
+
+  fDeconvKernelSplit = SplitComplexKernel(fDeconvKernel);
+  if (fSinglePrecisionFFT) fDeconvKernelF = SinglePrecisionKernel(fDeconvKernel);
+
+  // Set the lock flag.
+
+  fFilterLocked = true;
+}
+
+//----------------------------------------------------------------------
+// Deconvolution kernel: ratio of the filter function and the convolution
+// kernel, normalized so that the peak of the deconvoluted response matches
+// the peak of the response.
+std::vector<TComplex> util::SignalShaping::ComputeDeconvKernel(util::LArFFT const& fft) const
+{
+  unsigned int n = fft.FFTSize();
+
   // Calculate deconvolution kernel as the ratio of the
   // filter function and the convolution kernel.
 
-  fDeconvKernel = fFilter;
-  for (unsigned int i = 0; i < fDeconvKernel.size(); ++i) {
+  std::vector<TComplex> deconvKernel = fFilter;
+  for (unsigned int i = 0; i < deconvKernel.size(); ++i) {
     if (std::abs(fConvKernel[i].Re()) <= 0.0001 && std::abs(fConvKernel[i].Im()) <= 0.0001) {
-      fDeconvKernel[i] = 0.;
+      deconvKernel[i] = 0.;
     }
     else {
-      fDeconvKernel[i] /= fConvKernel[i];
+      deconvKernel[i] /= fConvKernel[i];
     }
   }
 
@@ -278,7 +379,7 @@ void util::SignalShaping::CalculateDeconvKernel() const
   // (inverse FFT of filter function).
 
   std::vector<double> deconv(n, 0.);
-  fft->DoInvFFT(const_cast<std::vector<TComplex>&>(fFilter), deconv);
+  fft.DoInvFFT(const_cast<std::vector<TComplex>&>(fFilter), deconv);
 
   if (fNorm) {
     // Find the peak value of the response
@@ -315,10 +416,115 @@ void util::SignalShaping::CalculateDeconvKernel() const
     // (Peak of response) = (Peak of deconvoluted response).
 
     double ratio = peak_response / peak_deconv;
-    for (unsigned int i = 0; i < fDeconvKernel.size(); ++i)
-      fDeconvKernel[i] *= ratio;
+    for (unsigned int i = 0; i < deconvKernel.size(); ++i)
+      deconvKernel[i] *= ratio;
   }
-  // Set the lock flag.
 
-  fFilterLocked = true;
+  return deconvKernel;
+}
+
+//----------------------------------------------------------------------
+// Convolute a time series with a single precision kernel.
+void util::SignalShaping::ConvoluteSinglePrecision(std::vector<double>& func,
+                                                   const std::vector<std::complex<float>>& kernF,
+                                                   const std::vector<TComplex>& kern) const
+{
+  DoConvoluteSinglePrecision(func, kernF, kern);
+}
+
+void util::SignalShaping::ConvoluteSinglePrecision(std::vector<float>& func,
+                                                   const std::vector<std::complex<float>>& kernF,
+                                                   const std::vector<TComplex>& kern) const
+{
+  DoConvoluteSinglePrecision(func, kernF, kern);
+}
+
+template <class T>
+void util::SignalShaping::DoConvoluteSinglePrecision(
+  std::vector<T>& func,
+  const std::vector<std::complex<float>>& kernF,
+  const std::vector<TComplex>& kern) const
+{
+  if (!fSinglePrecisionFFT->Validate()) {
+    fSinglePrecisionFFT->Convolute(func, kernF);
+    return;
+  }
+
+  std::vector<double> reference(func.begin(), func.end());
+  art::ServiceHandle<util::LArFFT const>()->Convolute(reference,
+                                                      const_cast<std::vector<TComplex>&>(kern));
+
+  fSinglePrecisionFFT->Convolute(func, kernF);
+
+  double deviation = 0.;
+  for (std::size_t i = 0; i < func.size(); ++i)
+    deviation = std::max(deviation, std::abs(func[i] - reference[i]));
+  fSinglePrecisionFFT->RecordDeviation(deviation);
+}
+
+//----------------------------------------------------------------------
+// Largest deviation of single precision results from double precision ones.
+double util::SignalShaping::MaxSinglePrecisionDeviation() const
+{
+  return fSinglePrecisionFFT ? fSinglePrecisionFFT->MaxDeviation() : 0.;
+}
+
+//----------------------------------------------------------------------
+// Single precision copy of a kernel.
+std::vector<std::complex<float>> util::SignalShaping::SinglePrecisionKernel(
+  const std::vector<TComplex>& kern)
+{
+  std::vector<std::complex<float>> kernF(kern.size());
+  for (unsigned int i = 0; i < kern.size(); ++i)
+    kernF[i] = std::complex<float>(kern[i].Re(), kern[i].Im());
+  return kernF;
+}
+
+//----------------------------------------------------------------------
+// Single precision transforms.
+util::SignalShaping::SinglePrecisionFFT::SinglePrecisionFFT(int size,
+                                                            const std::string& option,
+                                                            bool validate)
+  : fPlan(size, option), fValidate(validate), fMaxDeviation(0.), fNValidated(0)
+{}
+
+util::SignalShaping::SinglePrecisionFFT::~SinglePrecisionFFT()
+{
+  if (fValidate) {
+    mf::LogInfo("SignalShaping") << "Single precision transforms of size " << Size()
+                                 << ": max deviation from double precision " << fMaxDeviation
+                                 << " in " << fNValidated << " transforms";
+  }
+}
+
+double util::SignalShaping::SinglePrecisionFFT::MaxDeviation() const
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  return fMaxDeviation;
+}
+
+void util::SignalShaping::SinglePrecisionFFT::RecordDeviation(double deviation)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  fMaxDeviation = std::max(fMaxDeviation, deviation);
+  ++fNValidated;
+}
+
+std::unique_ptr<util::LArFFTWF> util::SignalShaping::SinglePrecisionFFT::Acquire()
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (!fIdle.empty()) {
+      std::unique_ptr<util::LArFFTWF> engine = std::move(fIdle.back());
+      fIdle.pop_back();
+      return engine;
+    }
+  }
+  return std::make_unique<util::LArFFTWF>(fPlan, 0);
+}
+
+void util::SignalShaping::SinglePrecisionFFT::Release(std::unique_ptr<util::LArFFTWF> engine)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  fIdle.push_back(std::move(engine));
 }
@@ -53,6 +53,24 @@
 /// * X. Qian 2015/01/06 <br/>
 ///     Add the time offset variable<br/>
 ///     Need to add the set and extraction code
+///
+/// Single precision
+/// -----------------
+///
+/// If the LArFFT service is configured with `SinglePrecision: true`,
+/// Convolute() and Deconvolute() use single precision (fftwf) transforms
+/// with std::complex<float> copies of the kernels, made when the
+/// configuration is locked. With `ValidateSinglePrecision: true` each
+/// of them is also run with the double precision kernels, and the largest
+/// deviation is reported (see MaxSinglePrecisionDeviation()).
+///
+/// Kernel cache
+/// -------------
+///
+/// The transforms of the response functions and the deconvolution kernels
+/// are looked up in a job-wide KernelCache, keyed by everything they are
+/// computed from (transform size, response, filter, normalization).
+/// Channels and planes sharing a configuration compute them only once.
 ////////////////////////////////////////////////////////////////////////
 
 #ifndef SIGNALSHAPING_H
@@ -63,6 +81,7 @@
 
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "lardata/Utilities/LArFFT.h"
+#include "lardata/Utilities/SplitComplexKernel.h"
 
 namespace util {
 
@@ -78,6 +97,8 @@ namespace util {
     const std::vector<TComplex>& ConvKernel() const { return fConvKernel; }
     const std::vector<TComplex>& Filter() const { return fFilter; }
     const std::vector<TComplex>& DeconvKernel() const { return fDeconvKernel; }
+    const SplitComplexKernel& SplitConvKernel() const { return fConvKernelSplit; }
+    const SplitComplexKernel& SplitDeconvKernel() const { return fDeconvKernelSplit; }
     /* const int GetTimeOffset() const {return fTimeOffset;} */
 
     // Signal shaping methods.
@@ -133,7 +154,40 @@ namespace util {
     // Fully locks configuration.
     void CalculateDeconvKernel() const;
 
+    // Largest deviation of single from double precision results so far
+    // (only with single precision validation).
+    double MaxSinglePrecisionDeviation() const;
+
   private:
+    // Single precision transforms: plans shared by a pool of engines,
+    // each used by one caller at a time (defined in SignalShaping.cxx).
+    class SinglePrecisionFFT;
+
+    // Convolute with single precision kernel, validating against double;
+    // time series of types other than double and float are copied to double.
+    void ConvoluteSinglePrecision(std::vector<double>& func,
+                                  const std::vector<std::complex<float>>& kernF,
+                                  const std::vector<TComplex>& kern) const;
+    void ConvoluteSinglePrecision(std::vector<float>& func,
+                                  const std::vector<std::complex<float>>& kernF,
+                                  const std::vector<TComplex>& kern) const;
+    template <class T>
+    void ConvoluteSinglePrecision(std::vector<T>& func,
+                                  const std::vector<std::complex<float>>& kernF,
+                                  const std::vector<TComplex>& kern) const;
+
+    // Implementation of the double and float versions (in SignalShaping.cxx).
+    template <class T>
+    void DoConvoluteSinglePrecision(std::vector<T>& func,
+                                    const std::vector<std::complex<float>>& kernF,
+                                    const std::vector<TComplex>& kern) const;
+
+    // Deconvolution kernel from the current configuration (not cached).
+    std::vector<TComplex> ComputeDeconvKernel(util::LArFFT const& fft) const;
+
+    static std::vector<std::complex<float>> SinglePrecisionKernel(
+      const std::vector<TComplex>& kern);
+
     // Attributes.
     // unused double fMinConvKernelFrac;  ///< minimum value of convKernel/peak for deconvolution
 
@@ -161,6 +215,16 @@ namespace util {
 
     // Xin added */
     bool fNorm;
+
+    // Kernels in split real/imaginary layout, used by Convolute/Deconvolute
+    // (set when the configuration is locked).
+    mutable SplitComplexKernel fConvKernelSplit;
+    mutable SplitComplexKernel fDeconvKernelSplit;
+
+    // Single precision transforms and kernels (if enabled in LArFFT).
+    mutable std::shared_ptr<SinglePrecisionFFT> fSinglePrecisionFFT;
+    mutable std::vector<std::complex<float>> fConvKernelF;
+    mutable std::vector<std::complex<float>> fDeconvKernelF;
   };
 
 }
@@ -173,13 +237,16 @@ inline void util::SignalShaping::Convolute(std::vector<T>& func) const
   // Make sure response configuration is locked.
   if (!fResponseLocked) LockResponse();
 
-  art::ServiceHandle<util::LArFFT> fft;
+  art::ServiceHandle<util::LArFFT const> fft;
 
   // Make sure that time series has the correct size.
   if (int const n = func.size(); n != fft->FFTSize())
     throw cet::exception("SignalShaping") << "Bad time series size = " << n << "\n";
 
-  fft->Convolute(func, const_cast<std::vector<TComplex>&>(fConvKernel));
+  if (fSinglePrecisionFFT)
+    ConvoluteSinglePrecision(func, fConvKernelF, fConvKernel);
+  else
+    fft->Convolute(func, fConvKernelSplit);
 }
 
 //----------------------------------------------------------------------
@@ -190,13 +257,30 @@ inline void util::SignalShaping::Deconvolute(std::vector<T>& func) const
   // Make sure deconvolution kernel is configured.
   if (!fFilterLocked) CalculateDeconvKernel();
 
-  art::ServiceHandle<util::LArFFT> fft;
+  art::ServiceHandle<util::LArFFT const> fft;
 
   // Make sure that time series has the correct size.
   if (int const n = func.size(); n != fft->FFTSize())
     throw cet::exception("SignalShaping") << "Bad time series size = " << n << "\n";
 
-  fft->Convolute(func, fDeconvKernel);
+  if (fSinglePrecisionFFT)
+    ConvoluteSinglePrecision(func, fDeconvKernelF, fDeconvKernel);
+  else
+    fft->Convolute(func, fDeconvKernelSplit);
+}
+
+//----------------------------------------------------------------------
+// Convolute a time series of another type with a single precision kernel.
+template <class T>
+inline void util::SignalShaping::ConvoluteSinglePrecision(
+  std::vector<T>& func,
+  const std::vector<std::complex<float>>& kernF,
+  const std::vector<TComplex>& kern) const
+{
+  std::vector<double> values(func.begin(), func.end());
+  ConvoluteSinglePrecision(values, kernF, kern);
+  for (std::size_t i = 0; i < func.size(); ++i)
+    func[i] = values[i];
 }
 
 #endif
@@ -0,0 +1,234 @@
+/**
+ * @file   AssociatedData_test.cc
+ * @brief  Unit tests on grouping of associations for associated data.
+ * @see    lardata/RecoBaseProxy/ProxyBase/AssociatedData.h
+ *         lardata/RecoBaseProxy/ProxyBase/AssociationRangeCache.h
+ */
+
+// Boost libraries
+#define BOOST_TEST_MODULE (AssociatedData_test)
+#include <boost/test/unit_test.hpp>
+
+// LArSoft libraries
+#include "lardata/RecoBaseProxy/ProxyBase/AssociatedData.h"
+#include "lardata/RecoBaseProxy/ProxyBase/AssociationRangeCache.h"
+
+// framework libraries
+#include "canvas/Persistency/Common/Assns.h"
+#include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::shuffle()
+#include <cstddef>   // std::size_t
+#include <random>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  using Assns_t = art::Assns<int, double>;
+
+  /// Returns an association with `keys` as main keys, and their position as value key.
+  Assns_t makeAssns(std::vector<std::size_t> const& keys)
+  {
+    Assns_t assns;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      assns.addSingle(art::Ptr<int>(art::ProductID(1), keys[i], nullptr),
+                      art::Ptr<double>(art::ProductID(2), i, nullptr));
+    }
+    return assns;
+  }
+
+  /// Checks that `assData` has ranges with the specified association `values`.
+  template <typename AssData>
+  void checkRanges(AssData const& assData, std::vector<std::vector<std::size_t>> const& values)
+  {
+    std::size_t iRange = 0;
+    for (auto const& range : assData) {
+      BOOST_TEST_REQUIRE(iRange < values.size());
+      std::vector<std::size_t> const& expected = values[iRange];
+      BOOST_TEST_REQUIRE(range.size() == expected.size());
+      BOOST_TEST(assData[iRange].size() == expected.size());
+      std::size_t i = 0;
+      for (auto const& node : range) {
+        BOOST_TEST(node.key() == expected[i]);
+        BOOST_TEST(range[i].key() == expected[i]);
+        ++i;
+      }
+      ++iRange;
+    }
+    BOOST_TEST(iRange == values.size());
+  }
+
+  /// Checks that `assData` has ranges of `sizes` elements, in association order.
+  template <typename AssData>
+  void checkRanges(AssData const& assData, std::vector<std::size_t> const& sizes)
+  {
+    std::vector<std::vector<std::size_t>> values;
+    std::size_t iValue = 0;
+    for (std::size_t size : sizes) {
+      values.emplace_back();
+      while (values.back().size() < size)
+        values.back().push_back(iValue++);
+    }
+    checkRanges(assData, values);
+  }
+
+  /// Event with an ID, like `art::Event`.
+  struct TestEvent {
+    struct ID_t {
+      unsigned int run() const { return 1; }
+      unsigned int subRun() const { return 0; }
+      unsigned int event() const { return number; }
+      unsigned int number;
+    };
+    ID_t id() const { return {number}; }
+    unsigned int number = 1;
+  };
+
+  /// Handle to an association with the ID of its data product.
+  struct TestHandle {
+    Assns_t const& operator*() const { return *assns; }
+    art::ProductID id() const { return art::ProductID(3); }
+    Assns_t const* assns;
+  };
+
+  /// Handle without product ID (not cacheable).
+  struct PlainHandle {
+    Assns_t const& operator*() const { return *assns; }
+    Assns_t const* assns;
+  };
+
+} // local namespace
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(AssociationRanges_test)
+{
+  Assns_t const assns = makeAssns({0, 0, 1, 3, 3, 3});
+
+  auto const groups =
+    proxy::details::associationRangeBoundaries<0U>(assns.begin(), assns.end(), 6U);
+  BOOST_TEST(groups.sorted());
+  BOOST_TEST(groups.offsets == proxy::details::BoundaryOffsets_t({0, 2, 3, 3, 6, 6, 6}),
+             boost::test_tools::per_element());
+
+  // main elements #4 and #5 are not associated
+  checkRanges(proxy::makeAssociatedData(assns, std::size_t(6)), {2, 1, 0, 3, 0, 0});
+  checkRanges(proxy::makeAssociatedData(assns), {2, 1, 0, 3});
+
+  Assns_t const empty;
+  checkRanges(proxy::makeAssociatedData(empty, std::size_t(2)), {0, 0});
+
+}
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(UnsortedAssociationRanges_test)
+{
+  // association values are grouped by key, in association order within the key
+  Assns_t const unsorted = makeAssns({3, 0, 3, 1, 0, 3});
+
+  auto const groups =
+    proxy::details::associationRangeBoundaries<0U>(unsorted.begin(), unsorted.end(), 5U);
+  BOOST_TEST(!groups.sorted());
+  BOOST_TEST(groups.offsets == proxy::details::BoundaryOffsets_t({0, 2, 3, 3, 6, 6}),
+             boost::test_tools::per_element());
+  BOOST_TEST(groups.order == proxy::details::BoundaryOffsets_t({1, 4, 3, 0, 2, 5}),
+             boost::test_tools::per_element());
+
+  checkRanges(proxy::makeAssociatedData(unsorted, std::size_t(5)),
+              {{1, 4}, {3}, {}, {0, 2, 5}, {}});
+  checkRanges(proxy::makeAssociatedData(unsorted), {{1, 4}, {3}, {}, {0, 2, 5}});
+
+  // a range is still valid after its associated data is gone
+  auto const range = proxy::makeAssociatedData(unsorted, std::size_t(5))[3];
+  BOOST_TEST_REQUIRE(range.size() == 3U);
+  BOOST_TEST(range[0].key() == 0U);
+  BOOST_TEST(range[1].key() == 2U);
+  BOOST_TEST(range[2].key() == 5U);
+}
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ParallelAssociationRanges_test)
+{
+  // large enough to be grouped in parallel chunks
+  std::size_t const nMain = 1000;
+  std::size_t const nAssns = 2 * proxy::details::ParallelGroupingMin;
+
+  std::vector<std::size_t> keys(nAssns);
+  for (std::size_t i = 0; i < nAssns; ++i)
+    keys[i] = (i * 7) % nMain;
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(12345));
+  Assns_t const assns = makeAssns(keys);
+
+  // expected values: positions in the association, by key
+  std::vector<std::vector<std::size_t>> expected(nMain + 2);
+  for (std::size_t i = 0; i < nAssns; ++i)
+    expected[keys[i]].push_back(i);
+
+  checkRanges(proxy::makeAssociatedData(assns, nMain + 2), expected);
+
+  // many more groups than elements per group
+  std::vector<std::size_t> sparseKeys(nAssns);
+  for (std::size_t i = 0; i < nAssns; ++i)
+    sparseKeys[i] = (i * 7919) % (4 * nAssns);
+  std::vector<std::vector<std::size_t>> sparseExpected(4 * nAssns);
+  for (std::size_t i = 0; i < nAssns; ++i)
+    sparseExpected[sparseKeys[i]].push_back(i);
+  checkRanges(proxy::makeAssociatedData(makeAssns(sparseKeys), 4 * nAssns), sparseExpected);
+}
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(AssociationRangeCache_test)
+{
+  auto& cache = proxy::details::AssociationRangeCache::instance();
+  Assns_t const assns = makeAssns({0, 1, 1, 2});
+  TestEvent event;
+  TestHandle const handle{&assns};
+
+  // the cache is opt-in
+  BOOST_TEST(!cache.enabled());
+  checkRanges(proxy::details::makeCachedAssociatedData<double>(event, handle, 4U), {1, 2, 1, 0});
+  BOOST_TEST(cache.size() == 0U);
+
+  cache.setEnabled(true);
+  cache.clear();
+
+  // the second proxy on the same association reuses the boundaries
+  checkRanges(proxy::details::makeCachedAssociatedData<double>(event, handle, 4U), {1, 2, 1, 0});
+  BOOST_TEST(cache.size() == 1U);
+  BOOST_TEST(cache.nHits() == 0U);
+  checkRanges(proxy::details::makeCachedAssociatedData<double>(event, handle, 4U), {1, 2, 1, 0});
+  BOOST_TEST(cache.size() == 1U);
+  BOOST_TEST(cache.nHits() == 1U);
+
+  // a different minimum size needs different boundaries
+  checkRanges(proxy::details::makeCachedAssociatedData<double>(event, handle, 3U), {1, 2, 1});
+  BOOST_TEST(cache.size() == 2U);
+
+  // a different association object with the same key is not served from cache
+  Assns_t const other = makeAssns({0, 0, 0, 1});
+  checkRanges(proxy::details::makeCachedAssociatedData<double>(event, TestHandle{&other}, 3U),
+              {3, 1, 0});
+  BOOST_TEST(cache.nHits() == 1U);
+
+  // without product ID, nothing is cached
+  checkRanges(proxy::details::makeCachedAssociatedData<double>(event, PlainHandle{&assns}, 4U),
+              {1, 2, 1, 0});
+  BOOST_TEST(cache.size() == 2U);
+  BOOST_TEST(cache.nHits() == 1U);
+
+  // only the most recent events are kept
+  for (std::size_t i = 0; i < proxy::details::AssociationRangeCache::MaxEvents; ++i) {
+    ++event.number;
+    proxy::details::makeCachedAssociatedData<double>(event, handle, 4U);
+  }
+  BOOST_TEST(cache.size() == proxy::details::AssociationRangeCache::MaxEvents);
+
+  cache.setEnabled(false);
+  BOOST_TEST(cache.size() == 0U);
+  checkRanges(proxy::details::makeCachedAssociatedData<double>(event, handle, 4U), {1, 2, 1, 0});
+  BOOST_TEST(cache.size() == 0U);
+}
+
+// -----------------------------------------------------------------------------
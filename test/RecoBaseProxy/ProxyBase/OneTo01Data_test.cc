@@ -0,0 +1,119 @@
+/**
+ * @file   OneTo01Data_test.cc
+ * @brief  Unit tests on one-to-(zero-or-one) associated data.
+ * @see    lardata/RecoBaseProxy/ProxyBase/OneTo01Data.h
+ */
+
+// Boost libraries
+#define BOOST_TEST_MODULE (OneTo01Data_test)
+#include <boost/test/unit_test.hpp>
+
+// LArSoft libraries
+#include "lardata/RecoBaseProxy/ProxyBase/OneTo01Data.h"
+
+// framework libraries
+#include "canvas/Persistency/Common/Assns.h"
+#include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
+
+// C/C++ standard libraries
+#include <cstddef> // std::size_t
+#include <utility> // std::pair
+#include <vector>
+
+// -----------------------------------------------------------------------------
+namespace {
+
+  using Assns_t = art::Assns<int, double>;
+
+  /// Returns an association of each main key with the value key paired to it.
+  Assns_t makeAssns(std::vector<std::pair<std::size_t, std::size_t>> const& keys)
+  {
+    Assns_t assns;
+    for (auto const& [mainKey, auxKey] : keys) {
+      assns.addSingle(art::Ptr<int>(art::ProductID(1), mainKey, nullptr),
+                      art::Ptr<double>(art::ProductID(2), auxKey, nullptr));
+    }
+    return assns;
+  }
+
+  /// Checks that `data` has the value keys `expected` (negative: no value).
+  template <typename Data>
+  void checkData(Data const& data, std::vector<int> const& expected)
+  {
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      BOOST_TEST_CONTEXT("element #" << i)
+      {
+        if (expected[i] < 0) {
+          BOOST_TEST(!data.has(i));
+          BOOST_TEST(data[i].isNull());
+        }
+        else {
+          BOOST_TEST(data.has(i));
+          BOOST_TEST(data[i].key() == std::size_t(expected[i]));
+        }
+      }
+    }
+  }
+
+} // local namespace
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(OneTo01DataStorage_test)
+{
+  // main element #2 is not associated; keys are not required to be sorted
+  Assns_t const assns = makeAssns({{0, 5}, {3, 7}, {1, 6}});
+  std::vector<int> const expected{5, 6, -1, 7, -1, -1};
+
+  auto const full = proxy::makeOneTo01data(assns, std::size_t(6), proxy::OneTo01Storage::Full);
+  BOOST_TEST(!full.compact());
+  checkData(full, expected);
+
+  auto const compact =
+    proxy::makeOneTo01data(assns, std::size_t(6), proxy::OneTo01Storage::Compact);
+  BOOST_TEST(compact.compact());
+  checkData(compact, expected);
+
+  // full storage is the default
+  BOOST_TEST(!proxy::makeOneTo01data(assns, std::size_t(6)).compact());
+
+  // half of the elements are associated: too many for automatic compact storage;
+  // one in four is few enough
+  auto const automatic = proxy::OneTo01Storage::Automatic;
+  BOOST_TEST(!proxy::makeOneTo01data(assns, std::size_t(6), automatic).compact());
+  auto const quarter = proxy::makeOneTo01data(assns, std::size_t(12), automatic);
+  BOOST_TEST(quarter.compact());
+  checkData(quarter, {5, 6, -1, 7, -1, -1, -1, -1, -1, -1, -1, -1});
+
+  // the association may extend beyond the requested size
+  checkData(proxy::makeOneTo01data(assns, std::size_t(2), proxy::OneTo01Storage::Compact),
+            {5, 6, -1, 7});
+}
+
+// -----------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(SparseOneTo01Data_test)
+{
+  // few associations across several bitmap blocks
+  std::size_t const nMain = 1000;
+  std::vector<std::pair<std::size_t, std::size_t>> keys;
+  std::vector<int> expected(nMain, -1);
+  for (std::size_t i = 3; i < nMain; i += 37) {
+    keys.emplace_back(i, 2 * i);
+    expected[i] = 2 * i;
+  }
+  Assns_t const assns = makeAssns(keys);
+
+  auto const data = proxy::makeOneTo01data(assns, nMain, proxy::OneTo01Storage::Automatic);
+  BOOST_TEST(data.compact());
+  checkData(data, expected);
+  auto const full = proxy::makeOneTo01data(assns, nMain);
+  BOOST_TEST(!full.compact());
+  checkData(full, expected);
+
+  Assns_t const empty;
+  checkData(proxy::makeOneTo01data(empty, std::size_t(3)), {-1, -1, -1});
+  checkData(proxy::makeOneTo01data(empty, std::size_t(3), proxy::OneTo01Storage::Automatic),
+            {-1, -1, -1});
+}
+
+// -----------------------------------------------------------------------------
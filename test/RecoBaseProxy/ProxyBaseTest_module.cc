@@ -88,6 +88,9 @@ private:
   /// Tests proxy composition.
   void testProxyComposition(art::Event const& event) const;
 
+  /// Tests auxiliary data loaded on first access.
+  void testLazyLoading(art::Event const& event) const;
+
   /// Performs the actual test.
   void testTracks(art::Event const& event) const;
 
@@ -149,6 +152,7 @@ namespace tag {
   struct DirectFitInfo {};
   struct TrackSubproxy {};
   struct FitInfoProxy {};
+  struct CompactTrajectory {};
 }
 
 //------------------------------------------------------------------------------
@@ -283,6 +287,55 @@ void ProxyBaseTest::testProxyComposition(art::Event const& event) const
 
 } // ProxyBaseTest::testProxyComposition()
 
+//------------------------------------------------------------------------------
+void ProxyBaseTest::testLazyLoading(art::Event const& event) const
+{
+
+  auto expectedTracksHandle = event.getValidHandle<std::vector<recob::Track>>(tracksTag);
+  auto const& expectedFitHitInfo =
+    *(event.getValidHandle<std::vector<std::vector<recob::TrackFitHitInfo>>>(tracksTag));
+
+  art::FindManyP<recob::Hit> hitsPerTrack(expectedTracksHandle, event, tracksTag);
+
+  auto tracks = proxy::getCollection<std::vector<recob::Track>>(
+    event,
+    tracksTag,
+    proxy::lazy(proxy::withAssociated<recob::Hit>()),
+    proxy::lazy(proxy::withParallelData<std::vector<recob::TrackFitHitInfo>>()));
+
+  static_assert(tracks.has<recob::Hit>());
+  static_assert(tracks.has<std::vector<recob::TrackFitHitInfo>>());
+  BOOST_TEST(!proxy::isAuxDataLoaded<recob::Hit>(tracks));
+  BOOST_TEST(!proxy::isAuxDataLoaded<std::vector<recob::TrackFitHitInfo>>(tracks));
+
+  // creating the elements does not load anything
+  std::vector<decltype(tracks)::element_proxy_t> trackProxies;
+  for (auto const& trackProxy : tracks)
+    trackProxies.push_back(trackProxy);
+  BOOST_TEST(trackProxies.size() == expectedTracksHandle->size());
+  BOOST_TEST(!proxy::isAuxDataLoaded<recob::Hit>(tracks));
+
+  // accessing one type of data loads only that one
+  for (auto const& trackProxy : trackProxies) {
+    auto const& expectedHits = hitsPerTrack.at(trackProxy.index());
+    auto const hits = trackProxy.get<recob::Hit>();
+    BOOST_TEST(hits.size() == expectedHits.size());
+    for (art::Ptr<recob::Hit> const& hitPtr : hits)
+      BOOST_TEST(indexOf(expectedHits, hitPtr) != std::numeric_limits<std::size_t>::max());
+  } // for
+  BOOST_TEST(proxy::isAuxDataLoaded<recob::Hit>(tracks));
+  BOOST_TEST(!proxy::isAuxDataLoaded<std::vector<recob::TrackFitHitInfo>>(tracks));
+
+  BOOST_TEST(tracks.get<std::vector<recob::TrackFitHitInfo>>().data() ==
+             std::addressof(expectedFitHitInfo));
+  BOOST_TEST(proxy::isAuxDataLoaded<std::vector<recob::TrackFitHitInfo>>(tracks));
+  for (auto const& trackProxy : trackProxies) {
+    BOOST_TEST(std::addressof(trackProxy.get<std::vector<recob::TrackFitHitInfo>>()) ==
+               std::addressof(expectedFitHitInfo[trackProxy.index()]));
+  } // for
+
+} // ProxyBaseTest::testLazyLoading()
+
 //------------------------------------------------------------------------------
 void ProxyBaseTest::testTracks(art::Event const& event) const
 {
@@ -321,7 +374,9 @@ void ProxyBaseTest::testTracks(art::Event const& event) const
     proxy::wrapAssociatedAs<tag::DirectHitAssns>(expectedTrackHitAssns),
     proxy::wrapParallelDataAs<tag::DirectFitInfo>(expectedTrackFitHitInfo),
     proxy::wrapParallelDataAs<tag::TrackSubproxy>(directTracks),
-    proxy::withZeroOrOne<recob::TrackTrajectory>(tracksTag));
+    proxy::withZeroOrOne<recob::TrackTrajectory>(tracksTag),
+    proxy::withZeroOrOneAs<recob::TrackTrajectory, tag::CompactTrajectory>(
+      tracksTag, proxy::OneTo01Storage::Compact));
 
   //
   // we try to access something we did not "register" in the proxy: space points
@@ -347,6 +402,10 @@ void ProxyBaseTest::testTracks(art::Event const& event) const
 
   BOOST_TEST(tracks.get<tag::TrackSubproxy>().data() == std::addressof(directTracks));
 
+  // the storage requested for the trajectories is used
+  BOOST_TEST(!tracks.get<recob::TrackTrajectory>().compact());
+  BOOST_TEST(tracks.get<tag::CompactTrajectory>().compact());
+
   auto fitHitInfoSize = std::distance(allFitHitInfo.begin(), allFitHitInfo.end());
   BOOST_TEST(fitHitInfoSize == expectedTrackFitHitInfo.size());
 
@@ -526,6 +585,8 @@ void ProxyBaseTest::testTracks(art::Event const& event) const
     else {
       BOOST_TEST(trackProxy.get<recob::TrackTrajectory>(), expectedTrajPtr);
     }
+    BOOST_TEST(trackProxy.has<tag::CompactTrajectory>() == !expectedTrajPtr.isNull());
+    BOOST_TEST(trackProxy.get<tag::CompactTrajectory>() == expectedTrajPtr);
     ++iExpectedTrack;
   } // for
   BOOST_TEST(iExpectedTrack == expectedTracks.size());
@@ -549,6 +610,9 @@ void ProxyBaseTest::analyze(art::Event const& event)
   // test proxy composition
   testProxyComposition(event);
 
+  // test loading on first access
+  testLazyLoading(event);
+
   // "test" that track proxies survive their collection (part II)
   mf::LogVerbatim("ProxyBaseTest")
     << longTracks.size() << " tracks are longer than " << minLength << " cm:";
@@ -311,6 +311,53 @@ void TrackProxyTest::testTracks(art::Event const& event)
   } // for
   BOOST_TEST(iExpectedTrack == expectedTracks.size());
 
+  //
+  // columnar point information
+  //
+  proxy::TrackPointColumns const columns = proxy::makeTrackPointColumns(tracks);
+  BOOST_TEST(columns.nTracks() == tracks.size());
+  BOOST_TEST(columns.hasFitInfo());
+  BOOST_TEST(columns.hitPtrs().size() == columns.nPoints());
+  BOOST_TEST(columns.fitInfoPtrs().size() == columns.nPoints());
+  for (auto const& trackProxy : tracks) {
+    std::size_t const iTrack = trackProxy.index();
+    BOOST_TEST_CHECKPOINT("Columns of track #" << iTrack);
+
+    BOOST_TEST(columns.nPoints(iTrack) == trackProxy.nPoints());
+    auto const positions = columns.positions(iTrack);
+    auto const momenta = columns.momenta(iTrack);
+    auto const flags = columns.flags(iTrack);
+    auto const hits = columns.hitPtrs(iTrack);
+    auto const fitInfo = columns.fitInfoPtrs(iTrack);
+    BOOST_TEST(positions.size() == trackProxy.nPoints());
+
+    std::size_t iPoint = 0;
+    for (auto const& pointInfo : trackProxy.points()) {
+      BOOST_TEST(positions[iPoint] == pointInfo.position());
+      BOOST_TEST(momenta[iPoint] == pointInfo.momentum());
+      BOOST_TEST(flags[iPoint] == pointInfo.flags());
+      BOOST_TEST(hits[iPoint] == pointInfo.hitPtr());
+      BOOST_TEST(fitInfo[iPoint] == pointInfo.fitInfoPtr());
+      ++iPoint;
+    } // for points
+  }   // for tracks
+
+  //
+  // columnar point information from a proxy without fit information
+  //
+  auto const plainTracks = proxy::getCollection<proxy::Tracks>(event, tracksTag);
+  proxy::TrackPointColumns const plainColumns = proxy::makeTrackPointColumns(plainTracks);
+  BOOST_TEST(plainColumns.nTracks() == plainTracks.size());
+  BOOST_TEST(!plainColumns.hasFitInfo());
+  BOOST_TEST(plainColumns.nPoints() == columns.nPoints());
+  BOOST_TEST(plainColumns.fitInfoPtrs().empty());
+  for (std::size_t iTrack = 0; iTrack < plainColumns.nTracks(); ++iTrack) {
+    BOOST_TEST_CHECKPOINT("Columns without fit information of track #" << iTrack);
+    BOOST_TEST(plainColumns.nPoints(iTrack) == columns.nPoints(iTrack));
+    BOOST_TEST(plainColumns.positions(iTrack).size() == plainColumns.nPoints(iTrack));
+    BOOST_TEST(plainColumns.fitInfoPtrs(iTrack).empty());
+  } // for tracks
+
 } // TrackProxyTest::testTracks()
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,108 @@
+#define BOOST_TEST_MODULE (ElossTableTest)
+#include "boost/test/unit_test.hpp"
+
+//
+// File: ElossTableTest.cxx
+//
+// Purpose: Unit test for ElossTable, against a Bethe-Bloch dE/dx in
+//          liquid argon like the one of DetectorPropertiesStandard,
+//          and of the identification of the medium of shared tables.
+//
+
+#include "lardata/RecoObjects/ElossTable.h"
+#include <cmath>
+
+using boost::test_tools::tolerance;
+
+namespace {
+
+  const double mumass = 0.105658367; // Muon
+  const double pmass = 0.938272;     // Proton
+
+  /// Bethe-Bloch mean energy loss (MeV/cm) in liquid argon, tcut = 10 MeV.
+  double bethe(double mom, double mass, double ionization = 188.0e-6 /* MeV */)
+  {
+    const double K = 0.307075;     // 4 pi N_A r_e^2 m_e c^2 (MeV cm^2/mol).
+    const double me = 0.510998918; // Electron mass (MeV/c^2).
+    const double density = 1.3954; // g/cm^3.
+    const double zovera = 18. / 39.948;
+    const double x0 = 0.2000, x1 = 3.0000, cbar = 5.2146, a = 0.1956, k = 3.0000;
+
+    double bg = mom / mass;
+    double gamma = std::sqrt(1. + bg * bg);
+    double beta = bg / gamma;
+    double mer = 0.001 * me / mass;
+    double tmax = 2. * me * bg * bg / (1. + 2. * gamma * mer + mer * mer);
+    double tcut = std::min(10., tmax);
+
+    double x = std::log10(bg);
+    double delta = 0.;
+    if (x >= x0) {
+      delta = 2. * std::log(10.) * x - cbar;
+      if (x < x1) delta += a * std::pow(x1 - x, k);
+    }
+
+    double B = 0.5 * std::log(2. * me * bg * bg * tcut / (ionization * ionization)) -
+               0.5 * beta * beta * (1. + tcut / tmax) - 0.5 * delta;
+    if (B < 1.) B = 1.;
+    return density * K * zovera / (beta * beta) * B;
+  }
+
+} // local namespace
+
+BOOST_AUTO_TEST_CASE(Interpolation)
+{
+  for (double mass : {mumass, pmass}) {
+    trkf::ElossTable table([mass](double p) { return bethe(p, mass); }, mass);
+    BOOST_TEST(table.Mass() == mass);
+
+    // Exact at grid points, close in between (tolerances in percent).
+    // Below about 30 MeV/c the stopping number reaches its lower limit,
+    // where the interpolation error can reach a few percent.
+
+    double const step = std::pow(10., 1. / trkf::ElossTable::NPerDecade);
+    for (double p = trkf::ElossTable::PMin; p <= trkf::ElossTable::PMax; p *= step)
+      BOOST_TEST(table.Eloss(p) == bethe(p, mass), 1.e-9 % tolerance());
+    for (double p = 0.0523; p < 500.; p *= 1.0371)
+      BOOST_TEST(table.Eloss(p) == bethe(p, mass), 1.e-2 % tolerance());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Extrapolation)
+{
+  trkf::ElossTable table([](double p) { return bethe(p, mumass); }, mumass);
+
+  // Continuous at the ends of the grid, and following dE/dx outside.
+
+  double const pmin = trkf::ElossTable::PMin;
+  double const pmax = trkf::ElossTable::PMax;
+  BOOST_TEST(table.Eloss(pmin * 0.999) == table.Eloss(pmin * 1.001), 1. % tolerance());
+  BOOST_TEST(table.Eloss(pmax * 1.1) == bethe(pmax * 1.1, mumass), 0.1 % tolerance());
+  BOOST_TEST(table.Eloss(0.5 * pmin) > table.Eloss(pmin));
+}
+
+BOOST_AUTO_TEST_CASE(SharedTables)
+{
+  // Media differing only in the mean excitation energy.
+
+  const double density = 1.3954;
+  trkf::ElossTable::Medium const lar(density,
+                                     [](double p, double mass, double) { return bethe(p, mass); });
+  trkf::ElossTable::Medium const other(
+    density, [](double p, double mass, double) { return bethe(p, mass, 197.0e-6); });
+  BOOST_TEST((lar == trkf::ElossTable::Medium(lar)));
+  BOOST_TEST((lar != other));
+
+  // Tables are shared within a medium, and made again for a new one.
+
+  const trkf::ElossTable& table = trkf::ElossTable::Get(lar, mumass, 10.);
+  BOOST_TEST(&trkf::ElossTable::Get(lar, mumass, 10.) == &table);
+  BOOST_TEST(&trkf::ElossTable::Get(lar, pmass, 10.) != &table);
+  BOOST_TEST(trkf::ElossTable::Get(lar, mumass, 10.).Eloss(1.) == bethe(1., mumass),
+             1.e-9 % tolerance());
+  BOOST_TEST(trkf::ElossTable::Get(other, mumass, 10.).Eloss(1.) ==
+               bethe(1., mumass, 197.0e-6),
+             1.e-9 % tolerance());
+  BOOST_TEST(trkf::ElossTable::Get(lar, mumass, 10.).Eloss(1.) == bethe(1., mumass),
+             1.e-9 % tolerance());
+}
@@ -0,0 +1,194 @@
+#define BOOST_TEST_MODULE (KGTrackTest)
+#include "boost/test/unit_test.hpp"
+
+//
+// File: KGTrackTest.cxx
+//
+// Purpose: Unit test for KGTrack (ordering of the flat KHitTrack
+//          collection, and the multimap adapter).
+//
+
+#include "KalmanTestGenerators.h"
+#include "cetlib_except/exception.h"
+#include "lardata/RecoObjects/KGTrack.h"
+#include "lardata/RecoObjects/SurfYZPlane.h"
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  using trkf::test::TestHit;
+
+  /// Make a KHitTrack at path distance s, tagged by plane index.
+  trkf::KHitTrack makeTrack(double s, int plane)
+  {
+    auto psurf = std::make_shared<trkf::SurfYZPlane>(0., 0., s, 0.);
+    trkf::TrackVector vec(5);
+    trkf::TrackError err(5);
+    vec.clear();
+    err.clear();
+    vec(4) = 1.;
+    trkf::KETrack tre(psurf, vec, err, trkf::Surface::FORWARD);
+    trkf::KFitTrack trf(tre, s);
+    return trkf::KHitTrack(trf, std::make_shared<TestHit>(psurf, plane));
+  }
+
+  /// Plane tags in collection order.
+  std::vector<int> planes(const trkf::KGTrack& trg)
+  {
+    std::vector<int> result;
+    for (const trkf::KHitTrack& trh : trg.getTracks())
+      result.push_back(trh.getHit()->getMeasPlane());
+    return result;
+  }
+
+  /// Path distances and plane tags in multimap order.
+  std::pair<std::vector<double>, std::vector<int>> mapContent(const trkf::KGTrack& trg)
+  {
+    std::pair<std::vector<double>, std::vector<int>> result;
+    for (auto const& ele : trg.getTrackMap()) {
+      result.first.push_back(ele.first);
+      result.second.push_back(ele.second.getHit()->getMeasPlane());
+    }
+    return result;
+  }
+
+} // local namespace
+
+// Tracks are ordered by path distance, equal distances in order of
+// insertion, as in a std::multimap.
+
+BOOST_AUTO_TEST_CASE(Order)
+{
+  trkf::KGTrack trg(0);
+  BOOST_TEST(!trg.isValid());
+  BOOST_CHECK_THROW(trg.startTrack(), cet::exception);
+
+  std::multimap<double, int> ref;
+  int tag = 0;
+  for (double s : {3., 1., 2., 1., 5., 3., 0.}) {
+    trg.addTrack(makeTrack(s, tag));
+    ref.emplace(s, tag);
+    ++tag;
+  }
+  BOOST_TEST(trg.numHits() == ref.size());
+
+  std::vector<int> reftags;
+  std::vector<double> refpaths;
+  for (auto const& ele : ref) {
+    refpaths.push_back(ele.first);
+    reftags.push_back(ele.second);
+  }
+  BOOST_TEST(trg.getPaths() == refpaths, boost::test_tools::per_element());
+  BOOST_TEST(planes(trg) == reftags, boost::test_tools::per_element());
+  BOOST_TEST(trg.startTrack().getHit()->getMeasPlane() == 6);
+  BOOST_TEST(trg.endTrack().getHit()->getMeasPlane() == 4);
+
+  // Multimap copy has the same contents.
+
+  const trkf::KGTrack& ctrg = trg;
+  const std::multimap<double, trkf::KHitTrack>& trackmap = ctrg.getTrackMap();
+  BOOST_TEST(trackmap.size() == ref.size());
+  auto it = ref.begin();
+  for (auto const& ele : trackmap) {
+    BOOST_TEST(ele.first == it->first);
+    BOOST_TEST(ele.second.getHit()->getMeasPlane() == it->second);
+    ++it;
+  }
+}
+
+// The modifiable multimap replaces the collection when released.
+
+BOOST_AUTO_TEST_CASE(ModifiableMap)
+{
+  trkf::KGTrack trg(0);
+  for (int i = 0; i < 4; ++i)
+    trg.addTrack(makeTrack(double(i), i));
+  BOOST_TEST(mapContent(trg).second == std::vector<int>({0, 1, 2, 3}),
+             boost::test_tools::per_element());
+
+  {
+    trkf::KGTrack::ModifiableTrackMap trackmap = trg.modifiableTrackMap();
+    trackmap->erase(trackmap->begin());
+    trackmap->begin()->second.setPath(10.);
+
+    // The track is unchanged until the multimap is released.
+
+    BOOST_TEST(trg.numHits() == 4u);
+    BOOST_TEST(trg.startTrack().getPath() == 0.);
+
+    trackmap.release();
+    BOOST_TEST(trg.numHits() == 3u);
+    BOOST_TEST(trg.startTrack().getPath() == 10.);
+    BOOST_TEST(mapContent(trg).second == std::vector<int>({1, 2, 3}),
+               boost::test_tools::per_element());
+
+    // Changes after the release are not applied.
+
+    trackmap->clear();
+  }
+  BOOST_TEST(trg.numHits() == 3u);
+
+  // Recalibrate offsets paths to the first track, and resorts.
+
+  trg.recalibrate();
+  std::vector<double> paths{-8., -7., 0.};
+  BOOST_TEST(trg.getPaths() == paths, boost::test_tools::per_element());
+  BOOST_TEST(planes(trg) == std::vector<int>({2, 3, 1}), boost::test_tools::per_element());
+  auto const content = mapContent(trg);
+  BOOST_TEST(content.first == paths, boost::test_tools::per_element());
+  BOOST_TEST(content.second == std::vector<int>({2, 3, 1}), boost::test_tools::per_element());
+
+  trg.clear();
+  BOOST_TEST(!trg.isValid());
+  BOOST_TEST(trg.getTrackMap().empty());
+}
+
+// The modifiable multimap is released on destruction, only once if moved.
+
+BOOST_AUTO_TEST_CASE(ReleaseOnDestruction)
+{
+  trkf::KGTrack trg(0);
+  for (int i = 0; i < 3; ++i)
+    trg.addTrack(makeTrack(double(i), i));
+
+  {
+    trkf::KGTrack::ModifiableTrackMap trackmap = trg.modifiableTrackMap();
+    trackmap->emplace(5., makeTrack(5., 7));
+    trackmap->emplace(-1., makeTrack(-1., 8));
+    trkf::KGTrack::ModifiableTrackMap moved(std::move(trackmap));
+    (*moved).emplace(1.5, makeTrack(1.5, 9));
+    BOOST_TEST(trg.numHits() == 3u);
+  }
+
+  BOOST_TEST(trg.numHits() == 6u);
+  BOOST_TEST(trg.startTrack().getHit()->getMeasPlane() == 8);
+  BOOST_TEST(trg.endTrack().getHit()->getMeasPlane() == 7);
+  BOOST_TEST(planes(trg) == std::vector<int>({8, 0, 1, 9, 2, 7}), boost::test_tools::per_element());
+  BOOST_TEST(mapContent(trg).second == std::vector<int>({8, 0, 1, 9, 2, 7}),
+             boost::test_tools::per_element());
+  BOOST_TEST(trg.getPaths() == std::vector<double>({-1., 0., 1., 1.5, 2., 5.}),
+             boost::test_tools::per_element());
+}
+
+// Copies are independent.
+
+BOOST_AUTO_TEST_CASE(Copy)
+{
+  trkf::KGTrack trg(0);
+  for (int i = 0; i < 3; ++i)
+    trg.addTrack(makeTrack(double(i), i));
+
+  trkf::KGTrack copy(trg);
+  trg.modifiableTrackMap()->emplace(5., makeTrack(5., 7));
+  BOOST_TEST(copy.numHits() == 3u);
+  BOOST_TEST(trg.numHits() == 4u);
+
+  trkf::KGTrack assigned(0);
+  assigned = trg;
+  BOOST_TEST(planes(assigned) == std::vector<int>({0, 1, 2, 7}), boost::test_tools::per_element());
+  BOOST_TEST(mapContent(assigned).second == std::vector<int>({0, 1, 2, 7}),
+             boost::test_tools::per_element());
+}
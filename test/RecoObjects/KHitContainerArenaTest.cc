@@ -0,0 +1,109 @@
+#define BOOST_TEST_MODULE (KHitContainerArenaTest)
+#include "boost/test/unit_test.hpp"
+
+//
+// File: KHitContainerArenaTest.cxx
+//
+// Purpose: Unit test for KHitContainerArena (filling, plane counting
+//          and measurement lifetime).
+//
+
+#include "KalmanTestGenerators.h"
+#include "cetlib_except/exception.h"
+#include "lardata/RecoObjects/KHitContainerArena.h"
+#include "lardata/RecoObjects/SurfYZPlane.h"
+
+namespace {
+
+  using trkf::test::TestHit;
+
+  /// Container filled by hand.
+  class TestContainer : public trkf::KHitContainerArena {
+  public:
+    void fill(detinfo::DetectorPropertiesData const&,
+              const art::PtrVector<recob::Hit>&,
+              int) override
+    {}
+
+    /// Add a group with nhits measurements in the given plane.
+    std::size_t add(int plane, int nhits, int* count)
+    {
+      auto psurf = std::make_shared<trkf::SurfYZPlane>(0., 0., double(size()), 0.);
+      std::size_t igr = addGroup();
+      for (int i = 0; i < nhits; ++i)
+        getGroup(igr).addHit(makeHit<TestHit>(psurf, plane, count));
+      return igr;
+    }
+  };
+
+} // local namespace
+
+BOOST_AUTO_TEST_CASE(Fill)
+{
+  int count = 0;
+  TestContainer cont;
+  for (int plane : {0, 1, 2, 1, 2}) {
+    std::size_t igr = cont.add(plane, 2, &count);
+    BOOST_TEST(igr == cont.size() - 1);
+  }
+  BOOST_TEST(count == 10);
+  BOOST_TEST(cont.size() == 5u);
+  BOOST_TEST(cont.numUnsorted() == 5u);
+  BOOST_TEST(cont.numSorted() == 0u);
+  BOOST_TEST(cont.numUnused() == 0u);
+
+  // New groups are appended to the unsorted list.
+
+  for (std::size_t i = 0; i < cont.size(); ++i) {
+    BOOST_TEST(&cont.getUnsorted(i) == &cont.getGroup(i));
+    BOOST_TEST(cont.getUnsorted(i).getHits().size() == 2u);
+  }
+  BOOST_CHECK_THROW(cont.moveToUnused(0), cet::exception);
+
+  // A group only accepts measurements on its own surface.
+
+  BOOST_CHECK_THROW(cont.getGroup(0).addHit(cont.getGroup(1).getHits().front()),
+                    cet::exception);
+}
+
+BOOST_AUTO_TEST_CASE(PreferredPlane)
+{
+  int count = 0;
+  TestContainer cont;
+  cont.add(0, 1, &count);
+  BOOST_TEST(cont.getPreferredPlane() == 0u);
+  cont.add(1, 1, &count);
+  cont.add(2, 3, &count);
+  cont.add(1, 1, &count);
+  BOOST_TEST(cont.getPreferredPlane() == 1u);
+
+  // Ties go to the last plane.
+
+  cont.add(2, 1, &count);
+  BOOST_TEST(cont.getPreferredPlane() == 2u);
+}
+
+BOOST_AUTO_TEST_CASE(Clear)
+{
+  int count = 0;
+  TestContainer cont;
+  cont.add(0, 3, &count);
+  cont.add(1, 3, &count);
+
+  // Measurements outlive the container contents.
+
+  std::shared_ptr<const trkf::KHitBase> hit = cont.getGroup(1).getHits().back();
+  cont.clear();
+  BOOST_TEST(cont.size() == 0u);
+  BOOST_TEST(cont.numUnsorted() == 0u);
+  BOOST_TEST(count == 1);
+  BOOST_TEST(hit->getMeasPlane() == 1);
+  hit.reset();
+  BOOST_TEST(count == 0);
+
+  // The container is reusable.
+
+  cont.add(2, 1, &count);
+  BOOST_TEST(cont.numUnsorted() == 1u);
+  BOOST_TEST(cont.getPreferredPlane() == 2u);
+}
@@ -0,0 +1,268 @@
+/**
+ * @file   KHitContainerTest_module.cc
+ * @brief  Test of KHitContainerArena against KHitContainer, and of parallel sorting
+ * @see    KHitContainer.h KHitContainerArena.h
+ *
+ * A KHitContainer and a KHitContainerArena are filled with the same
+ * measurements, and they are driven through the same random sequence of
+ * operations (`sort()` from random tracks, in all directions and with and
+ * without the unsorted groups; `reset()`; moving a sorted group to the
+ * unused list). After each operation, the sorted, unsorted and unused lists
+ * of the two containers must hold the same groups (same surface, same
+ * measurements and same path distance) in the same order, and the preferred
+ * plane must be the same.
+ *
+ * Another pair of containers with parallel sorting enabled goes through the
+ * same operations: the parallel arena must match the serial list container,
+ * and the parallel list container must match the serial arena.
+ *
+ * Sorting needs a propagator, and then the detector properties service;
+ * the test is run in `beginJob()`, so no event is needed.
+ * Any difference is reported, and the job fails.
+ *
+ * Configuration parameters
+ * =========================
+ *
+ * - `Containers` (default: 200): number of container sets to test
+ * - `Operations` (default: 30): number of operations on each container
+ */
+
+// test utilities
+#include "KalmanTestGenerators.h"
+
+// LArSoft libraries
+#include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
+#include "lardata/RecoObjects/KHitContainer.h"
+#include "lardata/RecoObjects/KHitContainerArena.h"
+#include "lardata/RecoObjects/PropYZPlane.h"
+#include "lardata/RecoObjects/SurfYZPlane.h"
+#include "lardataalg/DetectorInfo/DetectorPropertiesData.h"
+
+// framework libraries
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/ParameterSet.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// C/C++ standard libraries
+#include <cmath>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+
+//------------------------------------------------------------------------------
+namespace {
+
+  using trkf::test::TestHit;
+
+  /// List container filled by hand.
+  class TestListContainer : public trkf::KHitContainer {
+  public:
+    void fill(detinfo::DetectorPropertiesData const&,
+              const art::PtrVector<recob::Hit>&,
+              int) override
+    {}
+  };
+
+  /// Arena container filled by hand.
+  class TestArenaContainer : public trkf::KHitContainerArena {
+  public:
+    void fill(detinfo::DetectorPropertiesData const&,
+              const art::PtrVector<recob::Hit>&,
+              int) override
+    {}
+  };
+
+  /// Returns whether two groups have the same surface, measurements and path.
+  bool sameGroup(trkf::KHitGroup const& a, trkf::KHitGroup const& b)
+  {
+    return (a.getSurface() == b.getSurface()) && (a.getHits() == b.getHits()) &&
+           (a.getHasPath() == b.getHasPath()) && (a.getPath() == b.getPath());
+  }
+
+} // local namespace
+
+//------------------------------------------------------------------------------
+namespace trkf {
+
+  class KHitContainerTest : public art::EDAnalyzer {
+  public:
+    explicit KHitContainerTest(fhicl::ParameterSet const& pset);
+
+  private:
+    /// No event-dependent work.
+    void analyze(art::Event const&) override {}
+
+    /// Runs the tests; throws if any of them fails.
+    void beginJob() override;
+
+    /// Returns a description of the first difference between the containers.
+    std::string compare(KHitContainer const& list, KHitContainerArena const& arena) const;
+
+    /// Records the difference `msg` after operation `op` of container `i`; true if none.
+    bool check(std::size_t i, std::string const& op, std::string const& msg);
+
+    std::size_t fContainers;
+    std::size_t fOperations;
+
+    unsigned int fChecks = 0;   ///< Number of comparisons.
+    unsigned int fFailures = 0; ///< Number of failed comparisons.
+  }; // KHitContainerTest
+
+  DEFINE_ART_MODULE(KHitContainerTest)
+
+  //----------------------------------------------------------------------------
+  KHitContainerTest::KHitContainerTest(fhicl::ParameterSet const& pset)
+    : EDAnalyzer(pset)
+    , fContainers(pset.get<std::size_t>("Containers", 200))
+    , fOperations(pset.get<std::size_t>("Operations", 30))
+  {}
+
+  //----------------------------------------------------------------------------
+  void KHitContainerTest::beginJob()
+  {
+    auto const detProp =
+      art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataForJob();
+    PropYZPlane const prop(detProp, 10., false);
+
+    std::mt19937 engine(3);
+    auto uniform = [&engine](double a, double b) {
+      return std::uniform_real_distribution<double>(a, b)(engine);
+    };
+
+    for (std::size_t iCont = 0; iCont < fContainers; ++iCont) {
+
+      // Up to 200 groups on few z positions (many ties), some of them
+      // parallel to the tracks (no path); sorting is parallel from 64 groups.
+
+      TestListContainer list;
+      TestArenaContainer arena;
+      TestListContainer parallelList;
+      TestArenaContainer parallelArena;
+      parallelList.setParallelSort(true);
+      parallelArena.setParallelSort(true);
+      auto checkAll = [&](std::string const& op) {
+        return check(iCont, op, compare(list, arena)) &&
+               check(iCont, op + " (parallel arena)", compare(list, parallelArena)) &&
+               check(iCont, op + " (parallel list)", compare(parallelList, arena));
+      };
+      std::size_t const nGroups = 1 + engine() % 200;
+      for (std::size_t i = 0; i < nGroups; ++i) {
+        double const phi = (engine() % 7 == 0) ? 0.5 * M_PI : 0.;
+        auto const psurf = std::make_shared<SurfYZPlane const>(0., 0., double(engine() % 10), phi);
+        auto const hit = std::make_shared<TestHit const>(psurf, int(engine() % 3));
+        for (TestListContainer* cont : {&list, &parallelList}) {
+          cont->getUnsorted().emplace_back();
+          cont->getUnsorted().back().addHit(hit);
+        }
+        for (TestArenaContainer* cont : {&arena, &parallelArena})
+          cont->getGroup(cont->addGroup()).addHit(hit);
+      }
+      if (!checkAll("fill")) continue;
+
+      for (std::size_t iOp = 0; iOp < fOperations; ++iOp) {
+        std::string op;
+        switch (engine() % 4) {
+        case 0:
+        case 1: {
+          auto const psurf = std::make_shared<SurfYZPlane const>(
+            0., uniform(-1., 1.), uniform(-3., 3.), 0.);
+          TrackVector vec(5);
+          vec(0) = uniform(-1., 1.);
+          vec(1) = uniform(-1., 1.);
+          vec(2) = uniform(-0.3, 0.3);
+          vec(3) = uniform(-0.3, 0.3);
+          vec(4) = 1.;
+          Surface::TrackDirection const trkDir =
+            (engine() % 2) ? Surface::FORWARD : Surface::BACKWARD;
+          KTrack const trk(psurf, vec, trkDir, 13);
+          bool const addUnsorted = engine() % 2;
+          auto const dir = Propagator::PropDirection(engine() % 3);
+          for (TestListContainer* cont : {&list, &parallelList})
+            cont->sort(trk, addUnsorted, prop, dir);
+          for (TestArenaContainer* cont : {&arena, &parallelArena})
+            cont->sort(trk, addUnsorted, prop, dir);
+          op = "sort";
+          break;
+        }
+        case 2:
+          for (TestListContainer* cont : {&list, &parallelList})
+            cont->reset();
+          for (TestArenaContainer* cont : {&arena, &parallelArena})
+            cont->reset();
+          op = "reset";
+          break;
+        case 3: {
+          if (arena.numSorted() == 0) continue;
+          std::size_t const i = engine() % arena.numSorted();
+          for (TestListContainer* cont : {&list, &parallelList}) {
+            cont->getUnused().splice(
+              cont->getUnused().end(), cont->getSorted(), std::next(cont->getSorted().begin(), i));
+          }
+          for (TestArenaContainer* cont : {&arena, &parallelArena})
+            cont->moveToUnused(i);
+          op = "moveToUnused";
+          break;
+        }
+        } // switch
+        // containers differing once are not tested further
+        if (!checkAll(op)) break;
+      } // for operations
+    }   // for containers
+
+    if (fFailures > 0) {
+      throw cet::exception("KHitContainerTest")
+        << fFailures << " out of " << fChecks << " comparisons failed\n";
+    }
+    mf::LogInfo("KHitContainerTest") << "All " << fChecks << " comparisons passed";
+  }
+
+  //----------------------------------------------------------------------------
+  std::string KHitContainerTest::compare(KHitContainer const& list,
+                                         KHitContainerArena const& arena) const
+  {
+    auto compareList = [](std::string const& name,
+                          std::list<KHitGroup> const& groups,
+                          std::size_t n,
+                          auto getGroup) -> std::string {
+      if (groups.size() != n)
+        return name + " list has " + std::to_string(n) + " groups instead of " +
+               std::to_string(groups.size());
+      std::size_t i = 0;
+      for (KHitGroup const& group : groups) {
+        if (!sameGroup(group, getGroup(i)))
+          return name + " group #" + std::to_string(i) + " differs";
+        ++i;
+      }
+      return {};
+    };
+
+    auto sorted = [&arena](std::size_t i) -> auto const& { return arena.getSorted(i); };
+    auto unsorted = [&arena](std::size_t i) -> auto const& { return arena.getUnsorted(i); };
+    auto unused = [&arena](std::size_t i) -> auto const& { return arena.getUnused(i); };
+
+    std::string msg = compareList("sorted", list.getSorted(), arena.numSorted(), sorted);
+    if (msg.empty())
+      msg = compareList("unsorted", list.getUnsorted(), arena.numUnsorted(), unsorted);
+    if (msg.empty()) msg = compareList("unused", list.getUnused(), arena.numUnused(), unused);
+    if (msg.empty() && (list.getPreferredPlane() != arena.getPreferredPlane()))
+      msg = "preferred plane " + std::to_string(arena.getPreferredPlane()) + " instead of " +
+            std::to_string(list.getPreferredPlane());
+    return msg;
+  }
+
+  //----------------------------------------------------------------------------
+  bool KHitContainerTest::check(std::size_t i, std::string const& op, std::string const& msg)
+  {
+    ++fChecks;
+    if (msg.empty()) return true;
+    if (++fFailures <= 20)
+      mf::LogError("KHitContainerTest") << "container #" << i << " after " << op << ": " << msg;
+    return false;
+  }
+
+} // namespace trkf
@@ -0,0 +1,49 @@
+/**
+ * @file   KalmanAllocationCounter.cc
+ * @brief  Counter of the memory allocations, for the Kalman kernels benchmark
+ * @see    KalmanBenchmark_module.cc
+ *
+ * This library replaces the global `operator new` with one counting the
+ * calls. The replacement takes effect in the whole process only when the
+ * library is preloaded (`LD_PRELOAD`); the benchmark looks for
+ * `lar_allocation_count()` at run time, and it reports allocations only if it
+ * finds it.
+ *
+ * All the other forms of `operator new` of the standard library, and all
+ * forms of `operator delete`, end up with these two functions or with the C
+ * allocator, so they need no replacement.
+ * Memory allocated directly with `malloc()` is not counted.
+ */
+
+// C/C++ standard libraries
+#include <atomic>
+#include <cstdlib> // std::malloc(), std::aligned_alloc()
+#include <new>
+
+namespace {
+
+  std::atomic<unsigned long long> allocations{0};
+
+} // local namespace
+
+/// Returns the number of calls to `operator new` since the start of the process.
+extern "C" unsigned long long lar_allocation_count()
+{
+  return allocations.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  std::size_t const alignment = static_cast<std::size_t>(align);
+  std::size_t const rounded = ((size ? size : 1) + alignment - 1) / alignment * alignment;
+  if (void* p = std::aligned_alloc(alignment, rounded)) return p;
+  throw std::bad_alloc();
+}
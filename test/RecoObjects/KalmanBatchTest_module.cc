@@ -0,0 +1,384 @@
+/**
+ * @file   KalmanBatchTest_module.cc
+ * @brief  Test of the batch propagation of the RecoObjects Kalman kernels
+ * @see    Propagator.h KTrackBatch.h TrackStatePropagator.h
+ *
+ * Synthetic tracks are propagated both in batches (`KTrackBatch`) and one at
+ * a time, and the results are compared track by track:
+ *
+ * - batch `vec_prop`, `err_prop` and `noise_prop` of PropYZPlane,
+ *   PropXYZPlane, PropYZLine and PropAny (with dE/dx), against the single
+ *   track methods, in all directions, both with a destination surface per
+ *   track and with one destination for all of them;
+ * - batch `propagateToPlane` of TrackStatePropagator, against the single
+ *   state one to the same target plane, with and without dE/dx and multiple
+ *   scattering, in all directions.
+ *
+ * Success flags and destination surfaces must be the same; propagation
+ * distances, track parameters and error (covariance) matrices must agree
+ * within a relative tolerance.
+ * The services are needed for the detector properties and the LAr radiation
+ * length (multiple scattering); the test is run in `beginJob()`, so no event
+ * is needed. Any difference is reported, and the job fails.
+ *
+ * Configuration parameters
+ * =========================
+ *
+ * - `Tracks` (default: 500): number of synthetic tracks per test
+ * - `Tolerance` (default: `1e-9`): relative tolerance of the comparisons
+ */
+
+// test utilities
+#include "KalmanTestGenerators.h"
+
+// LArSoft libraries
+#include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
+#include "lardata/RecoObjects/KETrack.h"
+#include "lardata/RecoObjects/KTrackBatch.h"
+#include "lardata/RecoObjects/PropAny.h"
+#include "lardata/RecoObjects/PropXYZPlane.h"
+#include "lardata/RecoObjects/PropYZLine.h"
+#include "lardata/RecoObjects/PropYZPlane.h"
+#include "lardata/RecoObjects/TrackStatePropagator.h"
+#include "lardataalg/DetectorInfo/DetectorPropertiesData.h"
+
+// framework libraries
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/ParameterSet.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// C/C++ standard libraries
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits> // std::is_base_of_v<>
+#include <vector>
+
+//------------------------------------------------------------------------------
+//--- Synthetic tracks
+//---
+namespace {
+
+  using trkf::test::Generator;
+  using trkf::test::SurfaceKind;
+  using trkf::test::surfaceName;
+
+  /// Name of a propagation direction (of Propagator or TrackStatePropagator).
+  template <typename Direction>
+  std::string directionName(Direction dir)
+  {
+    switch (dir) {
+    case Direction::FORWARD: return "FORWARD";
+    case Direction::BACKWARD: return "BACKWARD";
+    case Direction::UNKNOWN: return "UNKNOWN";
+    }
+    return "";
+  }
+
+} // local namespace
+
+//------------------------------------------------------------------------------
+//--- Module
+//---
+namespace trkf {
+
+  class KalmanBatchTest : public art::EDAnalyzer {
+  public:
+    explicit KalmanBatchTest(fhicl::ParameterSet const& pset);
+
+  private:
+    /// No event-dependent work.
+    void analyze(art::Event const&) override {}
+
+    /// Runs the tests; throws if any of them fails.
+    void beginJob() override;
+
+    /// Compares batch and single track propagation of `Propagator`.
+    void testPropagators(detinfo::DetectorPropertiesData const& detProp);
+
+    /// Compares batch and single state `TrackStatePropagator::propagateToPlane()`.
+    void testTrackStatePropagator(detinfo::DetectorPropertiesData const& detProp);
+
+    /// Returns whether `a` and `b` agree within the tolerance.
+    bool close(double a, double b) const;
+
+    /// Describes the first difference of lane `i` of `batch` from `trk` (empty if none).
+    template <typename Track>
+    std::string compare(std::optional<double> const& dist,
+                        Track const& trk,
+                        std::optional<double> const& batchDist,
+                        KTrackBatch const& batch,
+                        std::size_t i) const;
+
+    /// Describes the first difference of `batchState` from `state` (empty if none).
+    std::string compare(TrackState const& state, TrackState const& batchState) const;
+
+    /// Records a failure of the test `what` on track `i`.
+    void fail(std::string const& what, std::size_t i, std::string const& msg);
+
+    std::size_t fTracks;
+    double fTolerance;
+
+    unsigned int fChecks = 0;   ///< Number of comparisons.
+    unsigned int fFailures = 0; ///< Number of failed comparisons.
+  }; // KalmanBatchTest
+
+  DEFINE_ART_MODULE(KalmanBatchTest)
+
+  //----------------------------------------------------------------------------
+  KalmanBatchTest::KalmanBatchTest(fhicl::ParameterSet const& pset)
+    : EDAnalyzer(pset)
+    , fTracks(pset.get<std::size_t>("Tracks", 500))
+    , fTolerance(pset.get<double>("Tolerance", 1e-9))
+  {
+    if (fTracks == 0) throw cet::exception("KalmanBatchTest") << "Tracks must be positive\n";
+  }
+
+  //----------------------------------------------------------------------------
+  void KalmanBatchTest::beginJob()
+  {
+    auto const detProp =
+      art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataForJob();
+
+    testPropagators(detProp);
+    testTrackStatePropagator(detProp);
+
+    if (fFailures > 0) {
+      throw cet::exception("KalmanBatchTest")
+        << fFailures << " out of " << fChecks << " batch results differ from single track ones\n";
+    }
+    mf::LogInfo("KalmanBatchTest") << "All " << fChecks << " batch results agree";
+  }
+
+  //----------------------------------------------------------------------------
+  bool KalmanBatchTest::close(double a, double b) const
+  {
+    return std::abs(a - b) <= fTolerance * std::max({1., std::abs(a), std::abs(b)});
+  }
+
+  //----------------------------------------------------------------------------
+  template <typename Track>
+  std::string KalmanBatchTest::compare(std::optional<double> const& dist,
+                                       Track const& trk,
+                                       std::optional<double> const& batchDist,
+                                       KTrackBatch const& batch,
+                                       std::size_t i) const
+  {
+    if (!dist != !batchDist)
+      return dist ? "batch propagation failed" : "batch propagation succeeded";
+    if (!dist) return {}; // the track state after a failure is not specified
+    if (!close(*dist, *batchDist))
+      return "distance " + std::to_string(*batchDist) + " instead of " + std::to_string(*dist);
+    if (batch.getSurface(i) != trk.getSurface()) return "wrong destination surface";
+    if (batch.getDirection(i) != trk.getDirection()) return "wrong direction";
+    for (int k = 0; k < KTrackBatch::NPar; ++k) {
+      if (!close(trk.getVector()(k), batch.par(k)[i]))
+        return "track parameter #" + std::to_string(k) + " differs";
+    }
+    if constexpr (std::is_base_of_v<KETrack, Track>) {
+      // the batch stores the packed lower triangle, like TrackError::data()
+      for (int k = 0; k < KTrackBatch::NErr; ++k) {
+        if (!close(trk.getError().data()[k], batch.err(k)[i]))
+          return "error matrix element #" + std::to_string(k) + " differs";
+      }
+    }
+    return {};
+  }
+
+  //----------------------------------------------------------------------------
+  std::string KalmanBatchTest::compare(TrackState const& state, TrackState const& batchState) const
+  {
+    Plane const& plane = state.plane();
+    Plane const& batchPlane = batchState.plane();
+    if (!close(plane.position().X(), batchPlane.position().X()) ||
+        !close(plane.position().Y(), batchPlane.position().Y()) ||
+        !close(plane.position().Z(), batchPlane.position().Z()) ||
+        !close(plane.direction().X(), batchPlane.direction().X()) ||
+        !close(plane.direction().Y(), batchPlane.direction().Y()) ||
+        !close(plane.direction().Z(), batchPlane.direction().Z()))
+      return "wrong target plane";
+    if (batchState.isTrackAlongPlaneDir() != state.isTrackAlongPlaneDir())
+      return "wrong direction";
+    for (unsigned int k = 0; k < 5; ++k) {
+      if (!close(state.parameters()[k], batchState.parameters()[k]))
+        return "track parameter #" + std::to_string(k) + " differs";
+    }
+    for (unsigned int k = 0; k < 5; ++k) {
+      for (unsigned int l = 0; l <= k; ++l) {
+        if (!close(state.covariance()(k, l), batchState.covariance()(k, l)))
+          return "covariance element (" + std::to_string(k) + ", " + std::to_string(l) +
+                 ") differs";
+      }
+    }
+    return {};
+  }
+
+  //----------------------------------------------------------------------------
+  void KalmanBatchTest::fail(std::string const& what, std::size_t i, std::string const& msg)
+  {
+    if (++fFailures <= 20)
+      mf::LogError("KalmanBatchTest") << what << " track #" << i << ": " << msg;
+  }
+
+  //----------------------------------------------------------------------------
+  void KalmanBatchTest::testPropagators(detinfo::DetectorPropertiesData const& detProp)
+  {
+    double const tcut = 10.;
+    PropYZPlane const propYZPlane(detProp, tcut, true);
+    PropXYZPlane const propXYZPlane(detProp, tcut, true);
+    PropYZLine const propYZLine(detProp, tcut, true);
+    PropAny const propAny(detProp, tcut, true);
+
+    struct Case_t {
+      std::string name;
+      Propagator const* prop;
+      SurfaceKind kind;
+    };
+    std::vector<Case_t> const cases{
+      {"PropYZPlane", &propYZPlane, SurfaceKind::YZPlane},
+      {"PropXYZPlane", &propXYZPlane, SurfaceKind::XYZPlane},
+      {"PropYZLine", &propYZLine, SurfaceKind::YZLine},
+      {"PropAny", &propAny, SurfaceKind::YZPlane},
+      {"PropAny", &propAny, SurfaceKind::XYZPlane},
+      {"PropAny", &propAny, SurfaceKind::YZLine},
+    };
+    std::vector<Propagator::PropDirection> const dirs{
+      Propagator::FORWARD, Propagator::BACKWARD, Propagator::UNKNOWN};
+    enum Mode_t { VecProp, ErrProp, NoiseProp };
+
+    for (Case_t const& c : cases) {
+      Generator gen(12345);
+      std::vector<KETrack> tracks;
+      std::vector<std::shared_ptr<const Surface>> dests;
+      for (std::size_t i = 0; i < fTracks; ++i) {
+        tracks.push_back(gen.track(c.kind));
+        dests.push_back(gen.destination(c.kind, tracks.back(), -50., 50.));
+      }
+      Propagator const& prop = *c.prop;
+
+      for (Propagator::PropDirection dir : dirs) {
+        for (bool const shared : {false, true}) {
+          // a destination per track, or the first one for all tracks
+          std::vector<std::shared_ptr<const Surface>> const batchDests =
+            shared ? std::vector<std::shared_ptr<const Surface>>{dests.front()} : dests;
+          auto dest = [&](std::size_t i) { return batchDests[shared ? 0 : i]; };
+
+          for (Mode_t const mode : {VecProp, ErrProp, NoiseProp}) {
+            std::string const what =
+              c.name + "(" + surfaceName(c.kind) + ") " +
+              (mode == VecProp ? "vec_prop" : (mode == ErrProp ? "err_prop" : "noise_prop")) +
+              " " + directionName(dir) + (shared ? " (shared destination)" : "");
+
+            KTrackBatch batch(mode != VecProp);
+            for (KETrack const& tre : tracks)
+              batch.push_back(tre);
+            std::vector<std::optional<double>> const batchDists =
+              (mode == VecProp) ? prop.vec_prop(batch, batchDests, dir, true) :
+              (mode == ErrProp) ? prop.err_prop(batch, batchDests, dir, true) :
+                                  prop.noise_prop(batch, batchDests, dir, true);
+            if (batchDists.size() != fTracks) {
+              fail(what, 0, std::to_string(batchDists.size()) + " results");
+              continue;
+            }
+
+            for (std::size_t i = 0; i < fTracks; ++i) {
+              ++fChecks;
+              std::string msg;
+              if (mode == VecProp) {
+                KTrack trk = tracks[i];
+                msg = compare(prop.vec_prop(trk, dest(i), dir, true), trk, batchDists[i], batch, i);
+              }
+              else {
+                KETrack tre = tracks[i];
+                std::optional<double> const dist = (mode == ErrProp) ?
+                                                     prop.err_prop(tre, dest(i), dir, true) :
+                                                     prop.noise_prop(tre, dest(i), dir, true);
+                msg = compare(dist, tre, batchDists[i], batch, i);
+              }
+              if (!msg.empty()) fail(what, i, msg);
+            } // for tracks
+          }   // for modes
+        }     // for shared
+      }       // for directions
+    }         // for cases
+  }
+
+  //----------------------------------------------------------------------------
+  void KalmanBatchTest::testTrackStatePropagator(detinfo::DetectorPropertiesData const& detProp)
+  {
+    // Groups of states about the same point, each group with a target plane
+    // up to 30 cm upstream or downstream of it.
+
+    std::size_t const batchSize = 50;
+    std::size_t const nBatches = (fTracks + batchSize - 1) / batchSize;
+    Generator gen(45678);
+    std::vector<std::vector<TrackState>> batches(nBatches);
+    std::vector<Plane> targets;
+    for (std::size_t b = 0; b < nBatches; ++b) {
+      double const x0 = gen.uniform(-100., 100.);
+      double const y0 = gen.uniform(-100., 100.);
+      double const z0 = gen.uniform(0., 500.);
+      for (std::size_t i = b * batchSize; i < std::min((b + 1) * batchSize, fTracks); ++i) {
+        Plane const plane = gen.plane(x0, y0, z0 + gen.uniform(-20., 20.));
+        SVector5 const par = gen.parameters();
+        SMatrixSym55 const cov = gen.covariance();
+        bool const along = gen.uniform(0., 1.) < 0.8;
+        batches[b].emplace_back(par, cov, plane, along, (i % 3 == 0) ? 2212 : 13);
+      }
+      targets.push_back(gen.plane(x0, y0, z0 + gen.uniform(-30., 30.)));
+    }
+
+    std::vector<TrackStatePropagator::PropDirection> const dirs{
+      TrackStatePropagator::FORWARD, TrackStatePropagator::BACKWARD, TrackStatePropagator::UNKNOWN};
+
+    for (bool const propPinvErr : {false, true}) {
+      TrackStatePropagator const prop(1., 0.1, 10, 10., 0.01, propPinvErr);
+      for (bool const dodedx : {false, true}) {
+        for (bool const domcs : {false, true}) {
+          for (TrackStatePropagator::PropDirection const dir : dirs) {
+            std::string const what = std::string("TrackStatePropagator propagateToPlane ") +
+                                     directionName(dir) + (dodedx ? " dE/dx" : "") +
+                                     (domcs ? " MCS" : "") +
+                                     (propPinvErr ? " (1/p error)" : "");
+
+            for (std::size_t b = 0; b < nBatches; ++b) {
+              std::vector<TrackState> const& origins = batches[b];
+              Plane const& target = targets[b];
+              std::vector<bool> batchSuccess;
+              std::vector<TrackState> const batchStates =
+                prop.propagateToPlane(batchSuccess, detProp, origins, target, dodedx, domcs, dir);
+              if ((batchStates.size() != origins.size()) ||
+                  (batchSuccess.size() != origins.size())) {
+                fail(what, b * batchSize, std::to_string(batchStates.size()) + " results");
+                continue;
+              }
+
+              for (std::size_t k = 0; k < origins.size(); ++k) {
+                std::size_t const i = b * batchSize + k;
+                ++fChecks;
+                bool success = false;
+                TrackState const state =
+                  prop.propagateToPlane(success, detProp, origins[k], target, dodedx, domcs, dir);
+                if (success != batchSuccess[k]) {
+                  fail(what,
+                       i,
+                       success ? "batch propagation failed" : "batch propagation succeeded");
+                  continue;
+                }
+                if (!success) continue;
+                if (std::string const msg = compare(state, batchStates[k]); !msg.empty())
+                  fail(what, i, msg);
+              } // for states
+            }   // for batches
+          }     // for directions
+        }       // for domcs
+      }         // for dodedx
+    }           // for propPinvErr
+  }
+
+} // namespace trkf
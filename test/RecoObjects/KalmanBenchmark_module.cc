@@ -0,0 +1,693 @@
+/**
+ * @file   KalmanBenchmark_module.cc
+ * @brief  Benchmark and regression check of the RecoObjects Kalman kernels
+ * @see    Propagator.h Interactor.h KHit.h KFTrackState.h TrackStatePropagator.h
+ *
+ * The kernels of the Kalman filter track fit are timed on synthetic tracks,
+ * generated with a fixed random seed on the standard surfaces (SurfYZPlane,
+ * SurfXYZPlane, SurfYZLine and wire planes from the geometry service):
+ *
+ * - `vec_prop` and `noise_prop` of PropYZPlane, PropXYZPlane, PropYZLine and
+ *   PropAny (with dE/dx);
+ * - `noise` of InteractPlane and InteractGeneral;
+ * - `predict` (with internal propagation) and `update` of a `KHit<1>`;
+ * - `updateWithHitState` and `combineWithTrackState` of KFTrackState;
+ * - `propagateToPlane` of TrackStatePropagator, one state at a time and in
+ *   batches.
+ *
+ * Each operation works on a copy of its input, and the copy is included in
+ * the time; the `copy` operations give the time of the copies alone.
+ * The services are needed for the detector properties, the LAr radiation
+ * length (multiple scattering) and the wire geometry; the work is done in
+ * `beginJob()`, so no event is needed.
+ *
+ * Configuration parameters
+ * =========================
+ *
+ * - `Tracks` (default: 1000): number of synthetic tracks per kernel
+ * - `Repeat` (default: 3): the best of `Repeat` runs is reported
+ * - `Format` (default: `csv`): output format, `csv` or `json`
+ * - `Output` (default: standard output): output file
+ * - `GoldenOutput` (default: none): file to write the golden outputs to
+ * - `GoldenReference` (default: none): file with golden outputs to compare to
+ *
+ * Each result reports the best wall time and the time per operation, and the
+ * number of memory allocations per operation. Allocations are counted only
+ * when the `KalmanAllocationCounter` library is preloaded, e.g.
+ * `LD_PRELOAD=libKalmanAllocationCounter.so lar -c kalmanbenchmark.fcl`
+ * (as the test does); otherwise they are not reported (empty in CSV, `null`
+ * in JSON).
+ *
+ * The golden outputs are the results of every operation on every track,
+ * written as hexadecimal floating point numbers (one line per operation and
+ * track). To check a change of the Kalman code, run once with `GoldenOutput`
+ * before the change, and then with that file as `GoldenReference`: any
+ * difference is reported, and the job fails.
+ */
+
+// test utilities
+#include "KalmanTestGenerators.h"
+
+// LArSoft libraries
+#include "larcore/Geometry/Geometry.h"
+#include "larcorealg/Geometry/WireGeo.h"
+#include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
+#include "lardata/RecoObjects/InteractGeneral.h"
+#include "lardata/RecoObjects/InteractPlane.h"
+#include "lardata/RecoObjects/KETrack.h"
+#include "lardata/RecoObjects/KFTrackState.h"
+#include "lardata/RecoObjects/KHit.h"
+#include "lardata/RecoObjects/PropAny.h"
+#include "lardata/RecoObjects/PropXYZPlane.h"
+#include "lardata/RecoObjects/PropYZLine.h"
+#include "lardata/RecoObjects/PropYZPlane.h"
+#include "lardata/RecoObjects/TrackStatePropagator.h"
+#include "lardataalg/DetectorInfo/DetectorPropertiesData.h"
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+
+// framework libraries
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/ParameterSet.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+// system libraries
+#include <dlfcn.h> // dlsym()
+
+// C/C++ standard libraries
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+//--- Results and output
+//---
+namespace {
+
+  struct Result_t {
+    std::string kernel;
+    std::string operation;
+    unsigned long ops; ///< per run
+    double seconds;
+    std::optional<unsigned long long> allocations; ///< per run, if counted
+
+    double nsPerOp() const { return seconds * 1e9 / ops; }
+    double allocsPerOp() const { return double(*allocations) / ops; }
+  }; // Result_t
+
+  void printCSV(std::ostream& out, std::vector<Result_t> const& results)
+  {
+    out << "kernel,operation,ops,seconds,ns_per_op,allocs_per_op\n";
+    for (Result_t const& r : results) {
+      out << r.kernel << ',' << r.operation << ',' << r.ops << ',' << r.seconds << ','
+          << r.nsPerOp() << ',';
+      if (r.allocations) out << r.allocsPerOp();
+      out << '\n';
+    }
+  }
+
+  void printJSON(std::ostream& out, std::vector<Result_t> const& results)
+  {
+    out << "[\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      Result_t const& r = results[i];
+      out << "  {\"kernel\": \"" << r.kernel << "\", \"operation\": \"" << r.operation
+          << "\", \"ops\": " << r.ops << ", \"seconds\": " << r.seconds
+          << ", \"ns_per_op\": " << r.nsPerOp() << ", \"allocs_per_op\": ";
+      if (r.allocations)
+        out << r.allocsPerOp();
+      else
+        out << "null";
+      out << "}" << ((i + 1 < results.size()) ? ",\n" : "\n");
+    }
+    out << "]\n";
+  }
+
+  //----------------------------------------------------------------------------
+  //--- Allocation counting
+  //---
+
+  /// Type of `lar_allocation_count()` (see KalmanAllocationCounter.cc).
+  using AllocationCounter_t = unsigned long long (*)();
+
+  /// Returns the allocation counter, or `nullptr` if not preloaded.
+  AllocationCounter_t allocationCounter()
+  {
+    return reinterpret_cast<AllocationCounter_t>(dlsym(RTLD_DEFAULT, "lar_allocation_count"));
+  }
+
+  //----------------------------------------------------------------------------
+  //--- Golden outputs
+  //---
+
+  /// Values of a propagation result (success flag and distance).
+  void addValues(std::vector<double>& values, std::optional<double> const& dist)
+  {
+    values.push_back(dist ? 1. : 0.);
+    values.push_back(dist ? *dist : 0.);
+  }
+
+  void addValues(std::vector<double>& values, trkf::TrackVector const& vec)
+  {
+    values.insert(values.end(), vec.begin(), vec.end());
+  }
+
+  void addValues(std::vector<double>& values, trkf::TrackError const& err)
+  {
+    for (unsigned int i = 0; i < err.size1(); ++i)
+      for (unsigned int j = 0; j <= i; ++j)
+        values.push_back(err(i, j));
+  }
+
+  void addValues(std::vector<double>& values, trkf::TrackState const& state)
+  {
+    for (unsigned int i = 0; i < 5; ++i)
+      values.push_back(state.parameters()[i]);
+    for (unsigned int i = 0; i < 5; ++i)
+      for (unsigned int j = 0; j <= i; ++j)
+        values.push_back(state.covariance()(i, j));
+  }
+
+  /// One line per operation and track, values in hexadecimal floating point.
+  std::string goldenLine(std::string const& kernel,
+                         std::string const& operation,
+                         std::size_t index,
+                         std::vector<double> const& values)
+  {
+    std::ostringstream line;
+    line << kernel << ' ' << operation << ' ' << index << std::hexfloat;
+    for (double value : values)
+      line << ' ' << value;
+    return line.str();
+  }
+
+  //----------------------------------------------------------------------------
+  //--- Synthetic tracks
+  //---
+
+  using trkf::test::Generator;
+  using trkf::test::SurfaceKind;
+  using trkf::test::surfaceName;
+
+  /// Measurement of the first track parameter, for KHit<1> predict/update.
+  class BenchHit : public trkf::KHit<1> {
+  public:
+    BenchHit(const std::shared_ptr<const trkf::Surface>& psurf, double u, double uerr2)
+      : KHit(psurf)
+    {
+      trkf::KVector<1>::type mvec(1);
+      trkf::KSymMatrix<1>::type merr(1);
+      mvec(0) = u;
+      merr(0, 0) = uerr2;
+      setMeasVector(mvec);
+      setMeasError(merr);
+    }
+
+    bool subpredict(const trkf::KETrack& tre,
+                    trkf::KVector<1>::type& pvec,
+                    trkf::KSymMatrix<1>::type& perr,
+                    trkf::KHMatrix<1>::type& hmatrix) const override
+    {
+      pvec.resize(1, false);
+      perr.resize(1, false);
+      hmatrix.resize(1, tre.getVector().size(), false);
+      hmatrix.clear();
+      pvec(0) = tre.getVector()(0);
+      perr(0, 0) = tre.getError()(0, 0);
+      hmatrix(0, 0) = 1.;
+      return true;
+    }
+  }; // BenchHit
+
+} // local namespace
+
+//------------------------------------------------------------------------------
+//--- Module
+//---
+namespace trkf {
+
+  class KalmanBenchmark : public art::EDAnalyzer {
+  public:
+    explicit KalmanBenchmark(fhicl::ParameterSet const& pset);
+
+  private:
+    /// No event-dependent work.
+    void analyze(art::Event const&) override {}
+
+    /// Runs the benchmarks and writes the results.
+    void beginJob() override;
+
+    /// Times `n` calls of `op(i)`, counts their allocations, and collects the golden outputs.
+    template <typename Op, typename Values>
+    void measure(std::string const& kernel,
+                 std::string const& operation,
+                 std::size_t n,
+                 unsigned long opsPerCall,
+                 Op op,
+                 Values values);
+
+    void benchmarkPropagators(detinfo::DetectorPropertiesData const& detProp);
+    void benchmarkInteractors(detinfo::DetectorPropertiesData const& detProp);
+    void benchmarkKHit(detinfo::DetectorPropertiesData const& detProp);
+    void benchmarkTrackStates(detinfo::DetectorPropertiesData const& detProp);
+
+    /// Compares the golden outputs with the reference file; returns mismatches.
+    unsigned int checkGolden(std::string const& fileName) const;
+
+    std::size_t fTracks;
+    unsigned int fRepeat;
+    std::string fFormat;
+    std::string fOutput;
+    std::string fGoldenOutput;
+    std::string fGoldenReference;
+
+    AllocationCounter_t fAllocationCounter = allocationCounter(); ///< Null if not preloaded.
+
+    std::vector<Result_t> fResults;
+    std::vector<std::string> fGolden; ///< Golden output lines.
+  }; // KalmanBenchmark
+
+  DEFINE_ART_MODULE(KalmanBenchmark)
+
+  //----------------------------------------------------------------------------
+  KalmanBenchmark::KalmanBenchmark(fhicl::ParameterSet const& pset)
+    : EDAnalyzer(pset)
+    , fTracks(pset.get<std::size_t>("Tracks", 1000))
+    , fRepeat(pset.get<unsigned int>("Repeat", 3))
+    , fFormat(pset.get<std::string>("Format", "csv"))
+    , fOutput(pset.get<std::string>("Output", ""))
+    , fGoldenOutput(pset.get<std::string>("GoldenOutput", ""))
+    , fGoldenReference(pset.get<std::string>("GoldenReference", ""))
+  {
+    if ((fFormat != "csv") && (fFormat != "json"))
+      throw cet::exception("KalmanBenchmark") << "Unknown format: '" << fFormat << "'\n";
+    if ((fTracks == 0) || (fRepeat == 0))
+      throw cet::exception("KalmanBenchmark") << "Tracks and repetitions must be positive\n";
+  }
+
+  //----------------------------------------------------------------------------
+  void KalmanBenchmark::beginJob()
+  {
+    auto const detProp =
+      art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataForJob();
+
+    benchmarkPropagators(detProp);
+    benchmarkInteractors(detProp);
+    benchmarkKHit(detProp);
+    benchmarkTrackStates(detProp);
+
+    std::ofstream outFile;
+    if (!fOutput.empty()) outFile.open(fOutput);
+    std::ostream& out = fOutput.empty() ? std::cout : outFile;
+    if (fFormat == "json")
+      printJSON(out, fResults);
+    else
+      printCSV(out, fResults);
+
+    if (!fGoldenOutput.empty()) {
+      std::ofstream golden(fGoldenOutput);
+      for (std::string const& line : fGolden)
+        golden << line << '\n';
+    }
+
+    if (!fGoldenReference.empty()) {
+      unsigned int const mismatches = checkGolden(fGoldenReference);
+      if (mismatches > 0) {
+        throw cet::exception("KalmanBenchmark")
+          << mismatches << " golden outputs differ from '" << fGoldenReference << "'\n";
+      }
+      mf::LogInfo("KalmanBenchmark")
+        << "All " << fGolden.size() << " golden outputs agree with '" << fGoldenReference << "'";
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  template <typename Op, typename Values>
+  void KalmanBenchmark::measure(std::string const& kernel,
+                                std::string const& operation,
+                                std::size_t n,
+                                unsigned long opsPerCall,
+                                Op op,
+                                Values values)
+  {
+    double best = std::numeric_limits<double>::max();
+    for (unsigned int iRun = 0; iRun < fRepeat; ++iRun) {
+      auto const start = std::chrono::steady_clock::now();
+      for (std::size_t i = 0; i < n; ++i)
+        op(i);
+      best = std::min(
+        best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // one more run for counting the allocations (the results are destroyed
+    // inside the loop, so their allocations are counted too)
+    std::optional<unsigned long long> allocations;
+    if (fAllocationCounter) {
+      unsigned long long const before = fAllocationCounter();
+      for (std::size_t i = 0; i < n; ++i)
+        op(i);
+      allocations = fAllocationCounter() - before;
+    }
+    fResults.push_back({kernel, operation, n * opsPerCall, best, allocations});
+
+    for (std::size_t i = 0; i < n; ++i) {
+      std::vector<double> v;
+      values(v, op(i));
+      fGolden.push_back(goldenLine(kernel, operation, i, v));
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  void KalmanBenchmark::benchmarkPropagators(detinfo::DetectorPropertiesData const& detProp)
+  {
+    double const tcut = 10.;
+    PropYZPlane const propYZPlane(detProp, tcut, true);
+    PropXYZPlane const propXYZPlane(detProp, tcut, true);
+    PropYZLine const propYZLine(detProp, tcut, true);
+    PropAny const propAny(detProp, tcut, true);
+
+    struct Case_t {
+      std::string name;
+      Propagator const* prop;
+      SurfaceKind kind;
+    };
+    std::vector<Case_t> const cases{
+      {"PropYZPlane", &propYZPlane, SurfaceKind::YZPlane},
+      {"PropXYZPlane", &propXYZPlane, SurfaceKind::XYZPlane},
+      {"PropYZLine", &propYZLine, SurfaceKind::YZLine},
+      {"PropAny", &propAny, SurfaceKind::YZPlane},
+      {"PropAny", &propAny, SurfaceKind::XYZPlane},
+      {"PropAny", &propAny, SurfaceKind::YZLine},
+    };
+
+    for (Case_t const& c : cases) {
+      Generator gen(12345);
+      std::vector<KETrack> tracks;
+      std::vector<std::shared_ptr<const Surface>> dests;
+      for (std::size_t i = 0; i < fTracks; ++i) {
+        tracks.push_back(gen.track(c.kind));
+        dests.push_back(gen.destination(c.kind, tracks.back(), 2., 50.));
+      }
+      std::string const kernel = c.name + "(" + surfaceName(c.kind) + ")";
+      Propagator const& prop = *c.prop;
+
+      measure(
+        kernel,
+        "copy",
+        fTracks,
+        1,
+        [&](std::size_t i) { return tracks[i]; },
+        [](std::vector<double>& v, KETrack const& tre) { addValues(v, tre.getVector()); });
+      measure(
+        kernel,
+        "vec_prop",
+        fTracks,
+        1,
+        [&](std::size_t i) {
+          KTrack trk = tracks[i];
+          std::optional<double> const dist =
+            prop.vec_prop(trk, dests[i], Propagator::FORWARD, true);
+          return std::make_pair(dist, trk);
+        },
+        [](std::vector<double>& v, auto const& result) {
+          addValues(v, result.first);
+          addValues(v, result.second.getVector());
+        });
+      measure(
+        kernel,
+        "noise_prop",
+        fTracks,
+        1,
+        [&](std::size_t i) {
+          KETrack tre = tracks[i];
+          std::optional<double> const dist =
+            prop.noise_prop(tre, dests[i], Propagator::FORWARD, true);
+          return std::make_pair(dist, tre);
+        },
+        [](std::vector<double>& v, auto const& result) {
+          addValues(v, result.first);
+          addValues(v, result.second.getVector());
+          addValues(v, result.second.getError());
+        });
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  void KalmanBenchmark::benchmarkInteractors(detinfo::DetectorPropertiesData const& detProp)
+  {
+    double const tcut = 10.;
+    InteractPlane const interactPlane(detProp, tcut);
+    InteractGeneral const interactGeneral(detProp, tcut);
+
+    struct Case_t {
+      std::string name;
+      Interactor const* interactor;
+      SurfaceKind kind;
+    };
+    std::vector<Case_t> const cases{
+      {"InteractPlane", &interactPlane, SurfaceKind::YZPlane},
+      {"InteractPlane", &interactPlane, SurfaceKind::XYZPlane},
+      {"InteractGeneral", &interactGeneral, SurfaceKind::YZLine},
+    };
+
+    for (Case_t const& c : cases) {
+      Generator gen(23456);
+      std::vector<KTrack> tracks;
+      std::vector<double> steps;
+      for (std::size_t i = 0; i < fTracks; ++i) {
+        tracks.push_back(gen.track(c.kind));
+        steps.push_back(gen.uniform(0.5, 20.));
+      }
+      Interactor const& interactor = *c.interactor;
+
+      measure(
+        c.name + "(" + surfaceName(c.kind) + ")",
+        "noise",
+        fTracks,
+        1,
+        [&](std::size_t i) {
+          TrackError noise(5);
+          noise.clear();
+          bool const ok = interactor.noise(tracks[i], steps[i], noise);
+          return std::make_pair(ok, noise);
+        },
+        [](std::vector<double>& v, auto const& result) {
+          v.push_back(result.first ? 1. : 0.);
+          addValues(v, result.second);
+        });
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  void KalmanBenchmark::benchmarkKHit(detinfo::DetectorPropertiesData const& detProp)
+  {
+    PropYZPlane const prop(detProp, 10., true);
+
+    // Tracks, measurements downstream of them, and the tracks propagated
+    // (with noise) to the measurement surfaces.
+
+    Generator gen(34567);
+    std::vector<KETrack> tracks;
+    std::vector<KETrack> onSurface;
+    std::vector<std::shared_ptr<const BenchHit>> hits;
+    for (std::size_t i = 0; i < fTracks; ++i) {
+      tracks.push_back(gen.track(SurfaceKind::YZPlane));
+      auto const psurf = gen.destination(SurfaceKind::YZPlane, tracks.back(), 2., 50.);
+      KETrack tre = tracks.back();
+      if (!prop.noise_prop(tre, psurf, Propagator::FORWARD, true)) tre = KETrack(psurf);
+      hits.push_back(std::make_shared<BenchHit>(
+        psurf, (tre.isValid() ? tre.getVector()(0) : 0.) + gen.uniform(-0.5, 0.5), 0.1));
+      onSurface.push_back(tre);
+    }
+
+    measure(
+      "KHit<1>",
+      "predict",
+      fTracks,
+      1,
+      [&](std::size_t i) {
+        bool const ok = hits[i]->predict(tracks[i], prop);
+        return std::make_pair(ok, hits[i]->getChisq());
+      },
+      [](std::vector<double>& v, auto const& result) {
+        v.push_back(result.first ? 1. : 0.);
+        v.push_back(result.second);
+      });
+
+    // Predictions on the measurement surfaces (no propagation), for update.
+
+    std::vector<std::size_t> predicted;
+    for (std::size_t i = 0; i < fTracks; ++i) {
+      if (onSurface[i].isValid() && hits[i]->predict(onSurface[i], prop))
+        predicted.push_back(i);
+    }
+
+    measure(
+      "KHit<1>",
+      "update",
+      predicted.size(),
+      1,
+      [&](std::size_t k) {
+        std::size_t const i = predicted[k];
+        KETrack tre = onSurface[i];
+        hits[i]->update(tre);
+        return tre;
+      },
+      [](std::vector<double>& v, KETrack const& tre) {
+        addValues(v, tre.getVector());
+        addValues(v, tre.getError());
+      });
+  }
+
+  //----------------------------------------------------------------------------
+  void KalmanBenchmark::benchmarkTrackStates(detinfo::DetectorPropertiesData const& detProp)
+  {
+    // Measurements on the wire planes of the first TPC.
+
+    art::ServiceHandle<geo::Geometry const> geom;
+    Generator gen(45678);
+    std::vector<HitState> hitStates;
+    std::vector<KFTrackState> states;
+    std::vector<TrackState> others;
+    unsigned int const nPlanes = geom->Nplanes();
+    for (std::size_t i = 0; i < fTracks; ++i) {
+      geo::PlaneID const planeID(0, 0, i % nPlanes);
+      geo::WireID const wireID(planeID, (7 * i) % geom->Nwires(planeID));
+      hitStates.emplace_back(
+        gen.uniform(-0.5, 0.5), 0.1, geo::WireID(wireID), geom->WireIDToWireGeo(wireID));
+      Plane const& plane = hitStates.back().plane();
+      SVector5 const par = gen.parameters();
+      SMatrixSym55 const cov = gen.covariance();
+      states.emplace_back(par, cov, plane, true, 13);
+      SVector5 const otherPar = gen.parameters();
+      SMatrixSym55 const otherCov = gen.covariance();
+      others.emplace_back(otherPar, otherCov, plane, true, 13);
+    }
+
+    measure(
+      "KFTrackState",
+      "copy",
+      fTracks,
+      1,
+      [&](std::size_t i) { return states[i]; },
+      [](std::vector<double>& v, KFTrackState const& s) { addValues(v, s.trackState()); });
+    measure(
+      "KFTrackState",
+      "updateWithHitState",
+      fTracks,
+      1,
+      [&](std::size_t i) {
+        KFTrackState s = states[i];
+        bool const ok = s.updateWithHitState(hitStates[i]);
+        return std::make_pair(ok, s);
+      },
+      [](std::vector<double>& v, auto const& result) {
+        v.push_back(result.first ? 1. : 0.);
+        addValues(v, result.second.trackState());
+      });
+    measure(
+      "KFTrackState",
+      "combineWithTrackState",
+      fTracks,
+      1,
+      [&](std::size_t i) {
+        KFTrackState s = states[i];
+        bool const ok = s.combineWithTrackState(others[i]);
+        return std::make_pair(ok, s);
+      },
+      [](std::vector<double>& v, auto const& result) {
+        v.push_back(result.first ? 1. : 0.);
+        addValues(v, result.second.trackState());
+      });
+
+    // Propagation of the states, one at a time and in batches of 100, to the
+    // plane of a measurement on the same wire plane: each batch goes to the
+    // plane following its first state, and so does each state of the batch
+    // when propagated alone, so that both ways give the same results.
+
+    TrackStatePropagator const prop(1., 0.1, 10, 10., 0.01, false);
+    std::vector<TrackState> origins;
+    for (KFTrackState const& s : states)
+      origins.push_back(s.trackState());
+    std::size_t const batchSize = 100;
+    auto target = [&](std::size_t i) -> Plane const& {
+      std::size_t const first = (i / batchSize) * batchSize; // first state of the batch
+      return hitStates[std::min(first + nPlanes, fTracks - 1)].plane();
+    };
+
+    measure(
+      "TrackStatePropagator",
+      "propagateToPlane",
+      fTracks,
+      1,
+      [&](std::size_t i) {
+        bool ok = false;
+        TrackState s = prop.propagateToPlane(ok, detProp, origins[i], target(i), true, true);
+        return std::make_pair(ok, s);
+      },
+      [](std::vector<double>& v, auto const& result) {
+        v.push_back(result.first ? 1. : 0.);
+        addValues(v, result.second);
+      });
+
+    std::size_t const nBatches = fTracks / batchSize;
+    std::vector<std::vector<TrackState>> batches(nBatches);
+    for (std::size_t i = 0; i < nBatches * batchSize; ++i)
+      batches[i / batchSize].push_back(origins[i]);
+
+    measure(
+      "TrackStatePropagator",
+      "propagateToPlane(batch)",
+      nBatches,
+      batchSize,
+      [&](std::size_t b) {
+        std::vector<bool> ok;
+        std::vector<TrackState> s =
+          prop.propagateToPlane(ok, detProp, batches[b], target(b * batchSize), true, true);
+        return std::make_pair(ok, s);
+      },
+      [](std::vector<double>& v, auto const& result) {
+        for (std::size_t i = 0; i < result.second.size(); ++i) {
+          v.push_back(result.first[i] ? 1. : 0.);
+          addValues(v, result.second[i]);
+        }
+      });
+  }
+
+  //----------------------------------------------------------------------------
+  unsigned int KalmanBenchmark::checkGolden(std::string const& fileName) const
+  {
+    std::ifstream reference(fileName);
+    if (!reference)
+      throw cet::exception("KalmanBenchmark")
+        << "Cannot read golden outputs '" << fileName << "'\n";
+
+    mf::LogError log("KalmanBenchmark");
+    unsigned int mismatches = 0;
+    std::string line;
+    std::size_t iLine = 0;
+    for (; std::getline(reference, line); ++iLine) {
+      if ((iLine < fGolden.size()) && (line == fGolden[iLine])) continue;
+      if (++mismatches <= 10) {
+        log << "\nexpected: " << line
+            << "\n     got: " << ((iLine < fGolden.size()) ? fGolden[iLine] : "(none)");
+      }
+    }
+    if (iLine != fGolden.size()) {
+      ++mismatches;
+      log << "\n" << fGolden.size() << " golden outputs, " << iLine << " in the reference";
+    }
+    return mismatches;
+  }
+
+} // namespace trkf
@@ -0,0 +1,178 @@
+#define BOOST_TEST_MODULE (KalmanFixedLATest)
+#include "boost/test/unit_test.hpp"
+
+//
+// File: KalmanFixedLATest.cxx
+//
+// Purpose: Regression test of the fixed-size Kalman filter linear algebra
+//          against the ublas expressions.
+//
+
+#include "lardata/RecoObjects/KalmanFixedLinearAlgebra.h"
+#include <random>
+
+using boost::test_tools::tolerance;
+auto const tol = 1.e-9 % tolerance();
+
+namespace {
+
+  std::mt19937 engine(20240601);
+
+  double random() { return std::uniform_real_distribution<double>(-1., 1.)(engine); }
+
+  // Random positive-definite symmetric matrix.
+  template <int N>
+  typename trkf::KSymMatrix<N>::type randomSymMatrix()
+  {
+    typename trkf::KMatrix<N, N>::type a(N, N);
+    for (int i = 0; i < N; ++i)
+      for (int j = 0; j < N; ++j)
+        a(i, j) = random();
+    typename trkf::KMatrix<N, N>::type aat = prod(a, trans(a));
+    typename trkf::KSymMatrix<N>::type s = trkf::ublas::symmetric_adaptor<decltype(aat)>(aat);
+    for (int i = 0; i < N; ++i)
+      s(i, i) += 0.5;
+    return s;
+  }
+
+  template <class M>
+  void randomFill(M& m)
+  {
+    for (unsigned int i = 0; i < m.size1(); ++i)
+      for (unsigned int j = 0; j < m.size2(); ++j)
+        m(i, j) = random();
+  }
+
+  template <class M1, class M2>
+  void checkEqual(const M1& m1, const M2& m2)
+  {
+    BOOST_TEST(m1.size1() == m2.size1());
+    BOOST_TEST(m1.size2() == m2.size2());
+    for (unsigned int i = 0; i < m1.size1(); ++i)
+      for (unsigned int j = 0; j < m1.size2(); ++j)
+        BOOST_TEST(m1(i, j) == m2(i, j), tol);
+  }
+
+  template <int N>
+  void checkSyminvert()
+  {
+    for (int trial = 0; trial < 10; ++trial) {
+      typename trkf::KSymMatrix<N>::type const m = randomSymMatrix<N>();
+      typename trkf::KSymMatrix<N>::type expected(m), fixed(m);
+      BOOST_TEST(trkf::syminvert(expected));
+      BOOST_TEST(trkf::fixed::syminvert<N>(fixed));
+      checkEqual(fixed, expected);
+    }
+  }
+
+  // Kalman update with the ublas expressions of KHit<N>::update.
+  template <int N>
+  void ublasUpdate(trkf::TrackVector& tvec,
+                   trkf::TrackError& terr,
+                   const typename trkf::KHMatrix<N>::type& H,
+                   const typename trkf::KSymMatrix<N>::type& V,
+                   const typename trkf::KSymMatrix<N>::type& Rinv,
+                   const typename trkf::KVector<N>::type& r)
+  {
+    using namespace trkf;
+    typename KGMatrix<N>::type temp = prod(trans(H), Rinv);
+    typename KGMatrix<N>::type gain = prod(terr, temp);
+    TrackVector newvec = tvec + prod(gain, r);
+    TrackMatrix fact = ublas::identity_matrix<double>(5);
+    fact -= prod(gain, H);
+    TrackMatrix errtemp1 = prod(terr, trans(fact));
+    TrackMatrix errtemp2 = prod(fact, errtemp1);
+    TrackError errtemp2s = ublas::symmetric_adaptor<TrackMatrix>(errtemp2);
+    typename KHMatrix<N>::type errtemp3 = prod(V, trans(gain));
+    TrackMatrix errtemp4 = prod(gain, errtemp3);
+    TrackError errtemp4s = ublas::symmetric_adaptor<TrackMatrix>(errtemp4);
+    tvec = newvec;
+    terr = errtemp2s + errtemp4s;
+  }
+
+  template <int N>
+  void checkUpdate()
+  {
+    using namespace trkf;
+    for (int trial = 0; trial < 10; ++trial) {
+      TrackVector tvec(5);
+      for (int i = 0; i < 5; ++i)
+        tvec(i) = random();
+      TrackError const terr = randomSymMatrix<5>();
+      typename KHMatrix<N>::type H(N, 5);
+      randomFill(H);
+      typename KSymMatrix<N>::type const V = randomSymMatrix<N>();
+      typename KVector<N>::type r(N);
+      for (int i = 0; i < N; ++i)
+        r(i) = random();
+
+      // residual error and its inverse, as from KHit<N>::predict
+      TrackMatrix const HP = prod(H, terr);
+      typename KMatrix<N, N>::type const HPHt = prod(HP, trans(H));
+      typename KSymMatrix<N>::type Rinv = ublas::symmetric_adaptor<decltype(HPHt)>(HPHt);
+      Rinv += V;
+      BOOST_TEST(syminvert(Rinv));
+
+      TrackVector expectedVec(tvec), fixedVec(tvec);
+      TrackError expectedErr(terr), fixedErr(terr);
+      ublasUpdate<N>(expectedVec, expectedErr, H, V, Rinv, r);
+      BOOST_TEST(fixed::tryUpdate<N>(fixedVec, fixedErr, H, V, Rinv, r));
+
+      for (int i = 0; i < 5; ++i)
+        BOOST_TEST(fixedVec(i) == expectedVec(i), tol);
+      checkEqual(fixedErr, expectedErr);
+    }
+  }
+
+} // local namespace
+
+BOOST_AUTO_TEST_CASE(Syminvert)
+{
+  checkSyminvert<1>();
+  checkSyminvert<2>();
+  checkSyminvert<3>();
+  checkSyminvert<4>();
+  checkSyminvert<5>();
+}
+
+BOOST_AUTO_TEST_CASE(SyminvertSingular)
+{
+  trkf::KSymMatrix<2>::type m(2);
+  m(0, 0) = 0.;
+  m(1, 0) = 1.;
+  m(1, 1) = 1.;
+  BOOST_TEST(!trkf::fixed::syminvert<2>(m));
+}
+
+BOOST_AUTO_TEST_CASE(Similarity)
+{
+  for (int trial = 0; trial < 10; ++trial) {
+    trkf::TrackMatrix F(5, 5);
+    randomFill(F);
+    trkf::TrackError const err = randomSymMatrix<5>();
+
+    trkf::TrackMatrix const temp = prod(err, trans(F));
+    trkf::TrackMatrix const temp2 = prod(F, temp);
+    trkf::TrackError const expected =
+      trkf::ublas::symmetric_adaptor<const trkf::TrackMatrix>(temp2);
+
+    trkf::TrackError fixed(err);
+    BOOST_TEST(trkf::fixed::trySimilarity(F, fixed));
+    checkEqual(fixed, expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Update)
+{
+  checkUpdate<1>();
+  checkUpdate<2>();
+  checkUpdate<3>();
+}
+
+BOOST_AUTO_TEST_CASE(SizeMismatch)
+{
+  trkf::TrackMatrix F(4, 4);
+  randomFill(F);
+  trkf::TrackError err = randomSymMatrix<4>();
+  BOOST_TEST(!trkf::fixed::trySimilarity(F, err));
+}
@@ -0,0 +1,178 @@
+/**
+ * @file   KalmanTestGenerators.h
+ * @brief  Synthetic tracks, surfaces, errors and measurements for the Kalman tests
+ * @see    KalmanBenchmark_module.cc KalmanBatchTest_module.cc
+ *         KHitContainerTest_module.cc KHitContainerArenaTest.cc KGTrackTest.cc
+ *
+ * All the random quantities are drawn from a `std::mt19937` engine with a
+ * fixed seed, in a fixed order: the same seed gives the same tracks, which
+ * the golden outputs of the benchmark rely on.
+ */
+
+#ifndef LARDATA_TEST_RECOOBJECTS_KALMANTESTGENERATORS_H
+#define LARDATA_TEST_RECOOBJECTS_KALMANTESTGENERATORS_H
+
+// LArSoft libraries
+#include "lardata/RecoObjects/KETrack.h"
+#include "lardata/RecoObjects/KHit.h"
+#include "lardata/RecoObjects/SurfXYZPlane.h"
+#include "lardata/RecoObjects/SurfYZLine.h"
+#include "lardata/RecoObjects/SurfYZPlane.h"
+#include "lardata/RecoObjects/TrackState.h"
+
+// C/C++ standard libraries
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace trkf::test {
+
+  enum class SurfaceKind { YZPlane, XYZPlane, YZLine };
+
+  inline std::string surfaceName(SurfaceKind kind)
+  {
+    switch (kind) {
+    case SurfaceKind::YZPlane: return "SurfYZPlane";
+    case SurfaceKind::XYZPlane: return "SurfXYZPlane";
+    case SurfaceKind::YZLine: return "SurfYZLine";
+    }
+    return "";
+  }
+
+  /// Measurement with a fixed plane index, and no prediction.
+  class TestHit : public KHit<1> {
+  public:
+    /// If `count` is not null, it is incremented here and decremented on destruction.
+    TestHit(const std::shared_ptr<const Surface>& psurf, int plane, int* count = nullptr)
+      : KHit(psurf), fCount(count)
+    {
+      setMeasPlane(plane);
+      if (fCount) ++*fCount;
+    }
+    ~TestHit()
+    {
+      if (fCount) --*fCount;
+    }
+
+    bool subpredict(const KETrack&,
+                    KVector<1>::type&,
+                    KSymMatrix<1>::type&,
+                    KHMatrix<1>::type&) const override
+    {
+      return false;
+    }
+
+  private:
+    int* fCount; ///< Number of live objects (optional).
+  }; // TestHit
+
+  class Generator {
+  public:
+    explicit Generator(unsigned int seed) : fEngine(seed) {}
+
+    double uniform(double a, double b)
+    {
+      return std::uniform_real_distribution<double>(a, b)(fEngine);
+    }
+
+    /// Surface of the given kind, about the point (x0, y0, z0).
+    std::shared_ptr<const Surface> surface(SurfaceKind kind, double x0, double y0, double z0)
+    {
+      switch (kind) {
+      case SurfaceKind::YZPlane:
+        return std::make_shared<SurfYZPlane>(x0, y0, z0, uniform(-0.3, 0.3));
+      case SurfaceKind::XYZPlane: {
+        double const phi = uniform(-0.3, 0.3);
+        double const theta = uniform(-0.3, 0.3);
+        return std::make_shared<SurfXYZPlane>(x0, y0, z0, phi, theta);
+      }
+      case SurfaceKind::YZLine:
+        return std::make_shared<SurfYZLine>(x0, y0, z0, uniform(-0.3, 0.3));
+      }
+      return {};
+    }
+
+    /// Track on a surface of the given kind, moving mostly along +z.
+    KETrack track(SurfaceKind kind)
+    {
+      double const x0 = uniform(-100., 100.);
+      double const y0 = uniform(-100., 100.);
+      double const z0 = uniform(0., 500.);
+      auto psurf = surface(kind, x0, y0, z0);
+      TrackVector vec(5);
+      if (kind == SurfaceKind::YZLine) {
+        vec(0) = uniform(-1., 1.);                // r
+        vec(1) = uniform(-10., 10.);              // v
+        vec(2) = 0.5 * M_PI + uniform(-0.5, 0.5); // phi
+        vec(3) = uniform(-0.5, 0.5);              // eta
+      }
+      else {
+        vec(0) = uniform(-10., 10.); // u
+        vec(1) = uniform(-10., 10.); // v
+        vec(2) = uniform(-0.5, 0.5); // du/dw
+        vec(3) = uniform(-0.5, 0.5); // dv/dw
+      }
+      vec(4) = 1. / uniform(0.3, 3.); // 1/p
+      return KETrack(psurf, vec, error(), Surface::FORWARD, 13);
+    }
+
+    /// Destination surface between `dzMin` and `dzMax` centimeters along z from the track.
+    std::shared_ptr<const Surface> destination(SurfaceKind kind,
+                                               const KTrack& trk,
+                                               double dzMin,
+                                               double dzMax)
+    {
+      double xyz[3];
+      trk.getPosition(xyz);
+      return surface(kind, xyz[0], xyz[1], xyz[2] + uniform(dzMin, dzMax));
+    }
+
+    /// Plane about the point (x0, y0, z0), facing roughly +z.
+    Plane plane(double x0, double y0, double z0)
+    {
+      double const dx = uniform(-0.3, 0.3);
+      double const dy = uniform(-0.3, 0.3);
+      return Plane(Point_t(x0, y0, z0), Vector_t(dx, dy, 1.));
+    }
+
+    /// Track parameters on a plane (the initializer list fixes the order of the draws).
+    SVector5 parameters()
+    {
+      return {uniform(-10., 10.),
+              uniform(-10., 10.),
+              uniform(-0.5, 0.5),
+              uniform(-0.5, 0.5),
+              1. / uniform(0.3, 3.)};
+    }
+
+    SMatrixSym55 covariance()
+    {
+      TrackError const err = error();
+      SMatrixSym55 cov;
+      for (unsigned int i = 0; i < 5; ++i)
+        for (unsigned int j = 0; j <= i; ++j)
+          cov(i, j) = err(i, j);
+      return cov;
+    }
+
+    /// Positive definite error matrix.
+    TrackError error()
+    {
+      TrackError err(5);
+      err.clear();
+      for (unsigned int i = 0; i < 5; ++i) {
+        err(i, i) = uniform(0.5, 1.) * (i == 4 ? 0.01 : 1.);
+        for (unsigned int j = 0; j < i; ++j)
+          err(i, j) = 0.1 * uniform(-1., 1.) * std::sqrt(err(i, i) * err(j, j));
+      }
+      return err;
+    }
+
+  private:
+    std::mt19937 fEngine;
+  }; // Generator
+
+} // namespace trkf::test
+
+#endif // LARDATA_TEST_RECOOBJECTS_KALMANTESTGENERATORS_H
@@ -7,6 +7,8 @@
 #include "lardata/RecoObjects/KETrack.h"
 #include "lardata/RecoObjects/KFitTrack.h"
 #include "lardata/RecoObjects/KTrack.h"
+#include "lardata/RecoObjects/KTrackBatch.h"
+#include "lardata/RecoObjects/SurfYZPlane.h"
 #include <cassert>
 #include <iostream>
 
@@ -32,6 +34,32 @@ int main()
   assert(!trk.isValid());
   assert(trf.getStat() == trkf::KFitTrack::INVALID);
 
+  // Copy a track with error through a track batch.
+
+  std::shared_ptr<const trkf::Surface> psurf(new trkf::SurfYZPlane(0., 1., 2., 0.5));
+  trkf::TrackVector vec(5);
+  trkf::TrackError err(5);
+  for (int i = 0; i < 5; ++i) {
+    vec(i) = 0.1 * (i + 1);
+    for (int j = 0; j <= i; ++j)
+      err(i, j) = (i == j ? 1. : 0.01 * (i + j));
+  }
+  trkf::KETrack tre1(psurf, vec, err, trkf::Surface::FORWARD, 13);
+  trkf::KTrackBatch batch(true);
+  batch.push_back(tre1);
+  assert(batch.size() == 1);
+  assert(batch.par(3)[0] == vec(3));
+  assert(batch.err(4)[0] == err(2, 1));
+  trkf::KETrack tre2 = batch.getETrack(0);
+  assert(tre2.getSurface() == psurf);
+  assert(tre2.getDirection() == trkf::Surface::FORWARD);
+  assert(tre2.PdgCode() == 13);
+  for (int i = 0; i < 5; ++i) {
+    assert(tre2.getVector()(i) == vec(i));
+    for (int j = 0; j <= i; ++j)
+      assert(tre2.getError()(i, j) == err(i, j));
+  }
+
   // Done (success).
 
   std::cout << "TrackTest: All tests passed." << std::endl;
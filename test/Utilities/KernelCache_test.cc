@@ -0,0 +1,106 @@
+/**
+ * @file    KernelCache_test.cc
+ * @brief   Tests the content-keyed kernel cache
+ * @see     KernelCache.h
+ *
+ * See http://www.boost.org/libs/test for the Boost test library home page.
+ */
+
+// C/C++ standard libraries
+#include <vector>
+
+// Boost libraries
+#define BOOST_TEST_MODULE (KernelCache_test)
+#include "boost/test/unit_test.hpp"
+
+// LArSoft libraries
+#include "lardata/Utilities/KernelCache.h"
+
+using Cache_t = util::KernelCache<std::vector<double>>;
+
+//------------------------------------------------------------------------------
+//--- Test code
+//
+
+/// A kernel made from the key (twice each element), counting the calls
+struct CountingMaker {
+  Cache_t::Key_t const& key;
+  unsigned int& nCalls;
+
+  std::vector<double> operator()() const
+  {
+    ++nCalls;
+    std::vector<double> kernel(key);
+    for (double& value : kernel)
+      value *= 2.;
+    return kernel;
+  }
+}; // CountingMaker
+
+//------------------------------------------------------------------------------
+void KernelCacheReuseTest()
+{
+  Cache_t cache;
+  unsigned int nCalls = 0;
+
+  Cache_t::Key_t const key1{1., 64., 0.5, -0.25};
+  Cache_t::Key_t const key2{1., 64., 0.5, -0.5};
+
+  auto const kernel1 = cache.Get(key1, CountingMaker{key1, nCalls});
+  BOOST_TEST(nCalls == 1U);
+  BOOST_TEST(*kernel1 == (std::vector<double>{2., 128., 1., -0.5}));
+
+  // same content, even from a different vector: no new computation
+  Cache_t::Key_t const key1copy(key1);
+  auto const kernel1again = cache.Get(key1copy, CountingMaker{key1copy, nCalls});
+  BOOST_TEST(nCalls == 1U);
+  BOOST_TEST(kernel1again == kernel1);
+
+  // different content
+  auto const kernel2 = cache.Get(key2, CountingMaker{key2, nCalls});
+  BOOST_TEST(nCalls == 2U);
+  BOOST_TEST(kernel2 != kernel1);
+  BOOST_TEST(cache.size() == 2U);
+
+} // KernelCacheReuseTest()
+
+//------------------------------------------------------------------------------
+void KernelCacheCapacityTest()
+{
+  Cache_t cache;
+  cache.SetCapacity(2U);
+  unsigned int nCalls = 0;
+
+  Cache_t::Key_t const key1{1.}, key2{2.}, key3{3.};
+  auto const kernel1 = cache.Get(key1, CountingMaker{key1, nCalls});
+  cache.Get(key2, CountingMaker{key2, nCalls});
+  BOOST_TEST(cache.size() == 2U);
+
+  // a third kernel makes the cache start over
+  cache.Get(key3, CountingMaker{key3, nCalls});
+  BOOST_TEST(cache.size() == 1U);
+
+  // kernels handed out before are still valid, and are made again if asked
+  BOOST_TEST(*kernel1 == std::vector<double>{2.});
+  auto const kernel1again = cache.Get(key1, CountingMaker{key1, nCalls});
+  BOOST_TEST(nCalls == 4U);
+  BOOST_TEST(*kernel1again == *kernel1);
+
+  cache.Clear();
+  BOOST_TEST(cache.size() == 0U);
+
+} // KernelCacheCapacityTest()
+
+//------------------------------------------------------------------------------
+//--- registration of tests
+//
+
+BOOST_AUTO_TEST_CASE(KernelCacheReuseTestCase)
+{
+  KernelCacheReuseTest();
+}
+
+BOOST_AUTO_TEST_CASE(KernelCacheCapacityTestCase)
+{
+  KernelCacheCapacityTest();
+}
@@ -0,0 +1,420 @@
+/**
+ * @file   LArFFTBenchmark.cc
+ * @brief  Throughput benchmark of the LArFFT and LArFFTW transforms
+ * @see    LArFFT.h LArFFTW.h
+ *
+ * The transforms (DoFFT, DoInvFFT) and the kernel operations (Convolute,
+ * Deconvolute) are timed on many channels, for each combination of
+ * backend, precision, FFTW planning option, transform size and number of
+ * threads. Usage:
+ * ~~~~
+ * LArFFTBenchmark [options]
+ *   --sizes 2048,3000,...   transform sizes (default: 2048 to 16384, with
+ *                           sizes which are not powers of two)
+ *   --backends LArFFT,LArFFTW
+ *   --precisions double,float   (LArFFT is double precision only)
+ *   --options ES,M,P,EX     FFTW planning options
+ *   --threads N             runs with 1, 2, 4... and N threads
+ *                           (default: hardware concurrency)
+ *   --channels N            waveforms per thread (default: 200)
+ *   --repeat N              the best of N runs is reported (default: 3)
+ *   --format csv|json       output format (default: csv)
+ *   --output FILE           output file (default: standard output)
+ * ~~~~
+ * Each result reports the wall time of the best run, the channel rate of all
+ * the threads together and the time per sample (wall time over the samples
+ * of all the threads). LArFFT rounds the size up to a power of two; the
+ * actual transform size is reported too. The time to make the plans is
+ * reported as the `Plan` operation.
+ *
+ * The kernel is a delay of one tick, so that repeated (de)convolutions keep
+ * the waveforms finite.
+ */
+
+// LArSoft libraries
+#include "lardata/Utilities/LArFFT.h"
+#include "lardata/Utilities/LArFFTW.h"
+#include "lardata/Utilities/LArFFTWPlan.h"
+#include "lardata/Utilities/SplitComplexKernel.h"
+
+// framework and ROOT libraries
+#include "TROOT.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "fhiclcpp/ParameterSet.h"
+
+// C/C++ standard libraries
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+//------------------------------------------------------------------------------
+//--- Configuration and results
+//---
+namespace {
+
+  struct Config_t {
+    std::vector<int> sizes{2048, 3000, 4096, 6000, 8192, 10000, 16384};
+    std::vector<std::string> backends{"LArFFT", "LArFFTW"};
+    std::vector<std::string> precisions{"double", "float"};
+    std::vector<std::string> options{"ES", "M", "P", "EX"};
+    unsigned int maxThreads = std::max(1U, std::thread::hardware_concurrency());
+    unsigned int channels = 200;
+    unsigned int repeat = 3;
+    std::string format = "csv";
+    std::string output;
+  }; // Config_t
+
+  struct Result_t {
+    std::string backend;
+    std::string precision;
+    std::string option;
+    int size;
+    int transformSize;
+    unsigned int threads;
+    std::string operation;
+    unsigned long channels; ///< total, in all threads
+    double seconds;
+
+    double channelRate() const { return channels / seconds; }
+    double nsPerSample() const { return seconds * 1e9 / (channels * double(transformSize)); }
+  }; // Result_t
+
+  //----------------------------------------------------------------------------
+  template <typename T>
+  std::vector<T> parseList(std::string const& list)
+  {
+    std::vector<T> values;
+    std::istringstream sstr(list);
+    std::string item;
+    while (std::getline(sstr, item, ',')) {
+      std::istringstream itemStr(item);
+      T value;
+      itemStr >> value;
+      if (!itemStr) throw std::runtime_error("Invalid list element: '" + item + "'");
+      values.push_back(value);
+    }
+    return values;
+  }
+
+  Config_t parseArguments(int argc, char** argv)
+  {
+    Config_t config;
+    for (int iArg = 1; iArg < argc; ++iArg) {
+      std::string const arg = argv[iArg];
+      if (iArg + 1 >= argc) throw std::runtime_error("Missing value for '" + arg + "'");
+      std::string const value = argv[++iArg];
+      if (arg == "--sizes")
+        config.sizes = parseList<int>(value);
+      else if (arg == "--backends")
+        config.backends = parseList<std::string>(value);
+      else if (arg == "--precisions")
+        config.precisions = parseList<std::string>(value);
+      else if (arg == "--options")
+        config.options = parseList<std::string>(value);
+      else if (arg == "--threads")
+        config.maxThreads = parseList<unsigned int>(value).at(0);
+      else if (arg == "--channels")
+        config.channels = parseList<unsigned int>(value).at(0);
+      else if (arg == "--repeat")
+        config.repeat = parseList<unsigned int>(value).at(0);
+      else if (arg == "--format")
+        config.format = value;
+      else if (arg == "--output")
+        config.output = value;
+      else
+        throw std::runtime_error("Unknown option: '" + arg + "'");
+    }
+    if ((config.format != "csv") && (config.format != "json"))
+      throw std::runtime_error("Unknown format: '" + config.format + "'");
+    if ((config.maxThreads == 0) || (config.channels == 0) || (config.repeat == 0))
+      throw std::runtime_error("Threads, channels and repetitions must be positive");
+    return config;
+  }
+
+  /// 1, 2, 4, ... up to and including `maxThreads`
+  std::vector<unsigned int> threadCounts(unsigned int maxThreads)
+  {
+    std::vector<unsigned int> counts;
+    for (unsigned int n = 1; n < maxThreads; n *= 2)
+      counts.push_back(n);
+    counts.push_back(maxThreads);
+    return counts;
+  }
+
+  //----------------------------------------------------------------------------
+  //--- Timing
+  //---
+
+  /// Returns the wall time [s] of `nThreads` threads running each `work()`
+  /// once after `setup()`; the clock starts when all threads are set up.
+  double timeThreads(unsigned int nThreads,
+                     std::function<std::function<void()>()> const& setup)
+  {
+    std::atomic<unsigned int> nReady{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < nThreads; ++i) {
+      threads.emplace_back([&]() {
+        std::function<void()> const work = setup();
+        ++nReady;
+        while (!go)
+          std::this_thread::yield();
+        work();
+      });
+    }
+
+    while (nReady < nThreads)
+      std::this_thread::yield();
+    auto const start = std::chrono::steady_clock::now();
+    go = true;
+    for (std::thread& thread : threads)
+      thread.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  /// Best time of `repeat` runs.
+  double bestTime(unsigned int repeat, std::function<double()> const& run)
+  {
+    double best = std::numeric_limits<double>::max();
+    for (unsigned int i = 0; i < repeat; ++i)
+      best = std::min(best, run());
+    return best;
+  }
+
+  template <typename Real>
+  std::vector<Real> noiseWaveform(int size)
+  {
+    std::mt19937 engine(12345);
+    std::normal_distribution<Real> noise(0., 3.);
+    std::vector<Real> waveform(size);
+    for (Real& sample : waveform)
+      sample = noise(engine);
+    return waveform;
+  }
+
+  /// Waveform of a delay of one tick.
+  template <typename Real>
+  std::vector<Real> delayResponse(int size)
+  {
+    std::vector<Real> response(size, 0.);
+    response[1] = 1.;
+    return response;
+  }
+
+  //----------------------------------------------------------------------------
+  //--- LArFFT
+  //---
+  void benchmarkLArFFT(Config_t const& config,
+                       std::string const& option,
+                       int size,
+                       std::vector<Result_t>& results)
+  {
+    fhicl::ParameterSet pset;
+    pset.put("FFTSize", size);
+    pset.put("FFTOption", option);
+    pset.put("FitBins", 20);
+    art::ActivityRegistry registry;
+
+    auto const planStart = std::chrono::steady_clock::now();
+    util::LArFFT const fft(pset, registry);
+    double const planTime =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - planStart).count();
+
+    int const N = fft.FFTSize();
+    std::vector<double> response = delayResponse<double>(N);
+    std::vector<TComplex> kernel(N / 2 + 1);
+    fft.DoFFT(response, kernel);
+    util::SplitComplexKernel const splitKernel(kernel);
+
+    results.push_back({"LArFFT", "double", option, size, N, 1, "Plan", 1, planTime});
+
+    using Operation_t = std::function<void(std::vector<double>&, std::vector<TComplex>&)>;
+    std::vector<std::pair<std::string, Operation_t>> const operations{
+      {"DoFFT", [&](auto& wave, auto& spectrum) { fft.DoFFT(wave, spectrum); }},
+      {"DoInvFFT", [&](auto& wave, auto& spectrum) { fft.DoInvFFT(spectrum, wave); }},
+      {"Convolute", [&](auto& wave, auto&) { fft.Convolute(wave, splitKernel); }},
+      {"Deconvolute", [&](auto& wave, auto&) { fft.Deconvolute(wave, splitKernel); }},
+    };
+
+    for (unsigned int nThreads : threadCounts(config.maxThreads)) {
+      for (auto const& [name, operation] : operations) {
+        double const seconds = bestTime(config.repeat, [&, op = operation]() {
+          return timeThreads(nThreads, [&]() -> std::function<void()> {
+            auto wave = std::make_shared<std::vector<double>>(noiseWaveform<double>(N));
+            auto spectrum = std::make_shared<std::vector<TComplex>>(N / 2 + 1);
+            fft.DoFFT(*wave, *spectrum); // also sets up the thread workspace
+            return [&config, op, wave, spectrum]() {
+              for (unsigned int i = 0; i < config.channels; ++i)
+                op(*wave, *spectrum);
+            };
+          });
+        });
+        results.push_back({"LArFFT",
+                           "double",
+                           option,
+                           size,
+                           N,
+                           nThreads,
+                           name,
+                           (unsigned long)nThreads * config.channels,
+                           seconds});
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //--- LArFFTW
+  //---
+  template <typename Real>
+  void benchmarkLArFFTW(Config_t const& config,
+                        std::string const& option,
+                        int size,
+                        std::vector<Result_t>& results)
+  {
+    using Engine_t = util::BasicLArFFTW<Real>;
+    using ComplexVector = typename Engine_t::ComplexVector;
+    std::string const precision = std::is_same_v<Real, float> ? "float" : "double";
+
+    auto const planStart = std::chrono::steady_clock::now();
+    util::BasicLArFFTWPlan<Real> const plan(size, option);
+    double const planTime =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - planStart).count();
+
+    ComplexVector kernel(size / 2 + 1);
+    {
+      Engine_t engine(plan, 20);
+      std::vector<Real> response = delayResponse<Real>(size);
+      engine.DoFFT(response, kernel);
+    }
+
+    results.push_back({"LArFFTW", precision, option, size, size, 1, "Plan", 1, planTime});
+
+    using Operation_t = std::function<void(Engine_t&, std::vector<Real>&, ComplexVector&)>;
+    std::vector<std::pair<std::string, Operation_t>> const operations{
+      {"DoFFT", [](auto& engine, auto& wave, auto& spectrum) { engine.DoFFT(wave, spectrum); }},
+      {"DoInvFFT",
+       [](auto& engine, auto& wave, auto& spectrum) { engine.DoInvFFT(spectrum, wave); }},
+      {"Convolute", [&](auto& engine, auto& wave, auto&) { engine.Convolute(wave, kernel); }},
+      {"Deconvolute", [&](auto& engine, auto& wave, auto&) { engine.Deconvolute(wave, kernel); }},
+    };
+
+    for (unsigned int nThreads : threadCounts(config.maxThreads)) {
+      for (auto const& [name, operation] : operations) {
+        double const seconds = bestTime(config.repeat, [&, op = operation]() {
+          return timeThreads(nThreads, [&]() -> std::function<void()> {
+            // each thread has its own engine (buffers) sharing the plans
+            auto engine = std::make_shared<Engine_t>(plan, 20);
+            auto wave = std::make_shared<std::vector<Real>>(noiseWaveform<Real>(size));
+            auto spectrum = std::make_shared<ComplexVector>(size / 2 + 1);
+            engine->DoFFT(*wave, *spectrum);
+            return [&config, op, engine, wave, spectrum]() {
+              for (unsigned int i = 0; i < config.channels; ++i)
+                op(*engine, *wave, *spectrum);
+            };
+          });
+        });
+        results.push_back({"LArFFTW",
+                           precision,
+                           option,
+                           size,
+                           size,
+                           nThreads,
+                           name,
+                           (unsigned long)nThreads * config.channels,
+                           seconds});
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  //--- Output
+  //---
+  void printCSV(std::ostream& out, std::vector<Result_t> const& results)
+  {
+    out << "backend,precision,option,size,transform_size,threads,operation,channels,seconds,"
+           "channels_per_s,ns_per_sample\n";
+    for (Result_t const& r : results) {
+      out << r.backend << ',' << r.precision << ',' << r.option << ',' << r.size << ','
+          << r.transformSize << ',' << r.threads << ',' << r.operation << ',' << r.channels << ','
+          << r.seconds << ',' << r.channelRate() << ',' << r.nsPerSample() << '\n';
+    }
+  }
+
+  void printJSON(std::ostream& out, std::vector<Result_t> const& results)
+  {
+    out << "[\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+      Result_t const& r = results[i];
+      out << "  {\"backend\": \"" << r.backend << "\", \"precision\": \"" << r.precision
+          << "\", \"option\": \"" << r.option << "\", \"size\": " << r.size
+          << ", \"transform_size\": " << r.transformSize << ", \"threads\": " << r.threads
+          << ", \"operation\": \"" << r.operation << "\", \"channels\": " << r.channels
+          << ", \"seconds\": " << r.seconds << ", \"channels_per_s\": " << r.channelRate()
+          << ", \"ns_per_sample\": " << r.nsPerSample() << "}"
+          << ((i + 1 < results.size()) ? ",\n" : "\n");
+    }
+    out << "]\n";
+  }
+
+} // local namespace
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  Config_t config;
+  try {
+    config = parseArguments(argc, argv);
+  }
+  catch (std::exception const& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  ROOT::EnableThreadSafety();
+
+  std::vector<Result_t> results;
+  for (std::string const& backend : config.backends) {
+    for (std::string const& precision : config.precisions) {
+      for (std::string const& option : config.options) {
+        for (int size : config.sizes) {
+          if (backend == "LArFFT") {
+            if (precision == "double") benchmarkLArFFT(config, option, size, results);
+          }
+          else if (backend == "LArFFTW") {
+            if (precision == "double")
+              benchmarkLArFFTW<double>(config, option, size, results);
+            else if (precision == "float")
+              benchmarkLArFFTW<float>(config, option, size, results);
+          }
+          else {
+            std::cerr << "Unknown backend: '" << backend << "'" << std::endl;
+            return 1;
+          }
+        }
+      }
+    }
+  }
+
+  std::ofstream outFile;
+  if (!config.output.empty()) outFile.open(config.output);
+  std::ostream& out = config.output.empty() ? std::cout : outFile;
+  if (config.format == "json")
+    printJSON(out, results);
+  else
+    printCSV(out, results);
+
+  return 0;
+}
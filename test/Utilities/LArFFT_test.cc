@@ -0,0 +1,137 @@
+/**
+ * @file    LArFFT_test.cc
+ * @brief   Tests the LArFFT transforms with split complex kernels
+ * @see     LArFFT.h SplitComplexKernel.h
+ *
+ * See http://www.boost.org/libs/test for the Boost test library home page.
+ *
+ * The service is constructed directly, with a fixed transform size.
+ * Convolution, deconvolution and correlation with a split complex kernel
+ * are compared with the same operations with the TComplex kernel, and
+ * kernels not matching the frequency space must be rejected.
+ */
+
+// C/C++ standard libraries
+#include <random>
+#include <vector>
+
+// Boost libraries
+#define BOOST_TEST_MODULE (LArFFT_test)
+#include "boost/test/unit_test.hpp"
+
+// LArSoft libraries
+#include "lardata/Utilities/LArFFT.h"
+#include "lardata/Utilities/SplitComplexKernel.h"
+
+// framework libraries
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/ParameterSet.h"
+
+using boost::test_tools::tolerance;
+
+//------------------------------------------------------------------------------
+//--- Test code
+//
+
+/// The seed for the default random engine
+constexpr unsigned int RandomSeed = 12345;
+
+/// Size of the transforms (a power of 2, so that LArFFT does not round it)
+constexpr int TransformSize = 64;
+
+fhicl::ParameterSet FFTConfiguration()
+{
+  fhicl::ParameterSet pset;
+  pset.put("FFTSize", TransformSize);
+  pset.put("FFTOption", std::string("ES"));
+  pset.put("FitBins", 5);
+  return pset;
+}
+
+std::vector<double> RandomWaveform(std::default_random_engine& engine)
+{
+  std::uniform_real_distribution<double> uniform(-2., 2.);
+  std::vector<double> waveform(TransformSize);
+  for (double& sample : waveform)
+    sample = uniform(engine);
+  return waveform;
+}
+
+//------------------------------------------------------------------------------
+void SplitKernelTest()
+{
+  art::ActivityRegistry registry;
+  util::LArFFT const fft(FFTConfiguration(), registry);
+  BOOST_TEST(fft.FFTSize() == TransformSize);
+
+  std::default_random_engine engine(RandomSeed);
+
+  // a response well away from zero in frequency space, so that the
+  // deconvolution is numerically sound
+  std::vector<double> response(TransformSize, 0.);
+  response[0] = 1.;
+  response[1] = 0.3;
+  std::vector<TComplex> kernel(TransformSize / 2 + 1);
+  fft.DoFFT(response, kernel);
+  util::SplitComplexKernel const splitKernel(kernel);
+
+  std::vector<double> const waveform = RandomWaveform(engine);
+
+  std::vector<double> expected = waveform;
+  std::vector<double> actual = waveform;
+  fft.Convolute(expected, kernel);
+  fft.Convolute(actual, splitKernel);
+  BOOST_TEST(actual == expected, tolerance(1e-9) << boost::test_tools::per_element());
+
+  expected = waveform;
+  actual = waveform;
+  fft.Deconvolute(expected, kernel);
+  fft.Deconvolute(actual, splitKernel);
+  BOOST_TEST(actual == expected, tolerance(1e-9) << boost::test_tools::per_element());
+
+  expected = waveform;
+  actual = waveform;
+  fft.Correlate(expected, kernel);
+  fft.Correlate(actual, splitKernel);
+  BOOST_TEST(actual == expected, tolerance(1e-9) << boost::test_tools::per_element());
+
+} // SplitKernelTest()
+
+//------------------------------------------------------------------------------
+void SplitKernelSizeTest()
+{
+  art::ActivityRegistry registry;
+  util::LArFFT const fft(FFTConfiguration(), registry);
+
+  std::default_random_engine engine(RandomSeed);
+
+  // kernels for the time domain size and for a smaller transform
+  for (std::size_t const size : {std::size_t(TransformSize), std::size_t(TransformSize / 4 + 1)}) {
+    util::SplitComplexKernel const kernel(std::vector<TComplex>(size, TComplex(1., 0.)));
+    std::vector<double> waveform = RandomWaveform(engine);
+    std::vector<double> const original = waveform;
+
+    BOOST_CHECK_THROW(fft.Convolute(waveform, kernel), cet::exception);
+    BOOST_CHECK_THROW(fft.Deconvolute(waveform, kernel), cet::exception);
+    BOOST_CHECK_THROW(fft.Correlate(waveform, kernel), cet::exception);
+
+    // the check happens before the waveform is touched
+    BOOST_TEST(waveform == original, boost::test_tools::per_element());
+  }
+
+} // SplitKernelSizeTest()
+
+//------------------------------------------------------------------------------
+//--- registration of tests
+//
+
+BOOST_AUTO_TEST_CASE(SplitKernelTestCase)
+{
+  SplitKernelTest();
+}
+
+BOOST_AUTO_TEST_CASE(SplitKernelSizeTestCase)
+{
+  SplitKernelSizeTest();
+}
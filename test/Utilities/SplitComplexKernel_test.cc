@@ -0,0 +1,111 @@
+/**
+ * @file    SplitComplexKernel_test.cc
+ * @brief   Tests the split complex kernel operations
+ * @see     SplitComplexKernel.h
+ *
+ * See http://www.boost.org/libs/test for the Boost test library home page.
+ *
+ * The vectorized implementation picked for the running CPU and the scalar
+ * one are both compared with std::complex arithmetic.
+ */
+
+// C/C++ standard libraries
+#include <complex>
+#include <random>
+#include <vector>
+
+// Boost libraries
+#define BOOST_TEST_MODULE (SplitComplexKernel_test)
+#include "boost/test/unit_test.hpp"
+
+// LArSoft libraries
+#include "lardata/Utilities/SplitComplexKernel.h"
+
+using boost::test_tools::tolerance;
+
+//------------------------------------------------------------------------------
+//--- Test code
+//
+
+/// The seed for the default random engine
+constexpr unsigned int RandomSeed = 12345;
+
+using Complex_t = std::complex<double>;
+
+std::vector<Complex_t> RandomSeries(std::size_t n, std::default_random_engine& engine)
+{
+  std::uniform_real_distribution<double> uniform(-2., 2.);
+  std::vector<Complex_t> series(n);
+  for (Complex_t& z : series)
+    z = Complex_t(uniform(engine), uniform(engine));
+  return series;
+} // RandomSeries()
+
+enum class Operation_t { Multiply, MultiplyConjugate, Divide };
+
+void TestOperation(Operation_t op, util::details::SplitComplexMultiplyFn multiply)
+{
+  std::default_random_engine engine(RandomSeed);
+
+  // sizes not multiple of the vector width exercise the scalar tail
+  for (std::size_t n : {1U, 3U, 4U, 7U, 8U, 17U, 4097U}) {
+    std::vector<Complex_t> const kern = RandomSeries(n, engine);
+    std::vector<Complex_t> const data = RandomSeries(n, engine);
+
+    util::SplitComplexKernel const kernel(kern);
+    BOOST_TEST(kernel.size() == n);
+
+    std::vector<double> re(n), im(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      re[i] = data[i].real();
+      im[i] = data[i].imag();
+    }
+
+    if (!multiply) {
+      switch (op) {
+      case Operation_t::Multiply: kernel.Multiply(re.data(), im.data()); break;
+      case Operation_t::MultiplyConjugate: kernel.MultiplyConjugate(re.data(), im.data()); break;
+      case Operation_t::Divide: kernel.Divide(re.data(), im.data()); break;
+      }
+    }
+    else {
+      BOOST_TEST_REQUIRE((op == Operation_t::Multiply));
+      multiply(kernel.Re(), kernel.Im(), re.data(), im.data(), n, false);
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+      Complex_t expected;
+      switch (op) {
+      case Operation_t::Multiply: expected = data[i] * kern[i]; break;
+      case Operation_t::MultiplyConjugate: expected = data[i] * std::conj(kern[i]); break;
+      case Operation_t::Divide: expected = data[i] / kern[i]; break;
+      }
+      BOOST_TEST(re[i] == expected.real(), tolerance(1e-9));
+      BOOST_TEST(im[i] == expected.imag(), tolerance(1e-9));
+    } // for
+  }   // for sizes
+} // TestOperation()
+
+//------------------------------------------------------------------------------
+//--- registration of tests
+//
+
+BOOST_AUTO_TEST_CASE(MultiplyTest)
+{
+  TestOperation(Operation_t::Multiply, nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(MultiplyConjugateTest)
+{
+  TestOperation(Operation_t::MultiplyConjugate, nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(DivideTest)
+{
+  TestOperation(Operation_t::Divide, nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(ScalarFallbackTest)
+{
+  TestOperation(Operation_t::Multiply, util::details::SplitComplexMultiplyScalar);
+}